@@ -13,14 +13,15 @@ AnimationInstance::AnimationInstance( const Vec3 & worldPos_, AnimationAssets::e
 
 	// spawn a single debug sphere to indicate the origin pos of the animated object
 	if ( SHOW_ORIGIN ) {
-		bodiesToAnimate.push_back( Body() );
-		bodiesToAnimate.back().m_position = worldPos;
-		bodiesToAnimate.back().m_orientation = { 0, 0, 0, 1 };
-		bodiesToAnimate.back().m_linearVelocity.Zero();
-		bodiesToAnimate.back().m_invMass = 0.f;	// no grav
-		bodiesToAnimate.back().m_elasticity = 1.f;
-		bodiesToAnimate.back().m_friction = 0.f;
-		bodiesToAnimate.back().m_shape = new ShapeAnimated( 0.45f, true );
+		bodyDesc_t body;
+		body.position = worldPos;
+		body.orientation = { 0, 0, 0, 1 };
+		body.linearVelocity.Zero();
+		body.invMass = 0.f;	// no grav
+		body.elasticity = 1.f;
+		body.friction = 0.f;
+		body.shape = new ShapeAnimated( 0.45f, true );
+		bodiesToAnimate.Add( body );
 	}
 
 	// Load the animation data ( bones and verts ) from fbx file
@@ -42,25 +43,27 @@ AnimationInstance::AnimationInstance( const Vec3 & worldPos_, AnimationAssets::e
 		case AnimationAssets::DEBUG_SKELETON: {
 			const int numBodies = animData->BoneCount();
 			for ( int i = 0; i < numBodies; i++ ) {
-				bodiesToAnimate.push_back( Body() );
-				bodiesToAnimate.back().m_shape = new ShapeAnimated( DEBUG_BONE_RAD, false );;
+				bodyDesc_t body;
+				body.shape = new ShapeAnimated( DEBUG_BONE_RAD, false );
+				bodiesToAnimate.Add( body );
 			}
 			break;
 		}
 		case AnimationAssets::SKINNED_MESH: {
-			bodiesToAnimate.push_back( Body() );
-			bodiesToAnimate.back().isSkinnedMesh = true;
-			bodiesToAnimate.back().m_shape = new ShapeLoadedMesh( 
+			bodyDesc_t body;
+			body.isSkinnedMesh = true;
+			body.shape = new ShapeLoadedMesh( 
 				animData->renderedVerts,
 				animData->numVerts,
 				animData->idxes,
 				animData->numIdxes,
 				animData->BoneCount()
 			);
+			bodiesToAnimate.Add( body );
 			break;
 		}
 	}
-	if ( bodiesToAnimate.empty() ) {
+	if ( bodiesToAnimate.Size() == 0 ) {
 		printf( "~WARNING~\tNo bodies to animate, AnimationIstance will NOT be initialized!\n" );
 		return;
 	}
@@ -77,7 +80,7 @@ AnimationInstance::AnimationInstance( const Vec3 & worldPos_, AnimationAssets::e
 	}
 
 	if ( whichSkeleton == AnimationAssets::eSkeleton::SKINNED_MESH ) {
-		ShapeLoadedMesh * mesh = reinterpret_cast< ShapeLoadedMesh * >( bodiesToAnimate[ 0 ].m_shape );
+		ShapeLoadedMesh * mesh = reinterpret_cast< ShapeLoadedMesh * >( bodiesToAnimate.m_shapes[ 0 ] );
 		if ( animMode == eAnimMode::GLOBAL ) {
 			mesh->PopulateMatrixPalette( fbxInitialTransforms );
 		} else if ( animMode == eAnimMode::LOCAL ) {
@@ -87,34 +90,34 @@ AnimationInstance::AnimationInstance( const Vec3 & worldPos_, AnimationAssets::e
 		}
 	} else {
 		// move bodies into position, assign appropriate shapes to them ( could be a skinned mesh! )
-		for ( int i = 0; i < bodiesToAnimate.size(); i++ ) {
-			Body & bodyToAnimate = bodiesToAnimate[ i ];
-			bodyToAnimate.m_position = worldPos + initialTransforms[ i ].translation;
-			bodyToAnimate.m_orientation = initialTransforms[ i ].rotation; // @TODO - add world rotation member
-			bodyToAnimate.m_linearVelocity.Zero();
-			bodyToAnimate.m_invMass = 0.f;	// no grav
-			bodyToAnimate.m_elasticity = 1.f;
-			bodyToAnimate.m_friction = 0.f;
+		for ( int i = 0; i < bodiesToAnimate.Size(); i++ ) {
+			Body bodyToAnimate = bodiesToAnimate.GetBodyAt( i );
+			bodyToAnimate.GetPosition() = worldPos + initialTransforms[ i ].translation;
+			bodyToAnimate.GetOrientation() = initialTransforms[ i ].rotation; // @TODO - add world rotation member
+			bodyToAnimate.GetLinearVelocity().Zero();
+			bodyToAnimate.GetInvMass() = 0.f;	// no grav
+			bodyToAnimate.GetElasticity() = 1.f;
+			bodyToAnimate.GetFriction() = 0.f;
 		}
 	}
 }
 
 AnimationInstance::~AnimationInstance() {
-	if ( bodiesToAnimate.size() > 0 ) {
+	if ( bodiesToAnimate.Size() > 0 ) {
 		if ( isInstanced ) {
-			if ( bodiesToAnimate[ 0 ].m_shape != nullptr ) {
-				delete bodiesToAnimate[ 0 ].m_shape;	
-				bodiesToAnimate[ 0 ].m_shape = nullptr;
+			if ( bodiesToAnimate.m_shapes[ 0 ] != nullptr ) {
+				delete bodiesToAnimate.m_shapes[ 0 ];	
+				bodiesToAnimate.m_shapes[ 0 ] = nullptr;
 			}
 		} else {
-			for ( int i = 0; i < bodiesToAnimate.size(); i++ ) {
-				if ( bodiesToAnimate[ i ].m_shape != nullptr ) {
-					delete( bodiesToAnimate[ i ].m_shape );
-					bodiesToAnimate[ i ].m_shape = nullptr;
+			for ( int i = 0; i < bodiesToAnimate.Size(); i++ ) {
+				if ( bodiesToAnimate.m_shapes[ i ] != nullptr ) {
+					delete( bodiesToAnimate.m_shapes[ i ] );
+					bodiesToAnimate.m_shapes[ i ] = nullptr;
 				}
 			}
 		}
-		bodiesToAnimate.clear();
+		bodiesToAnimate.Clear();
 	}
 
 	delete animData;
@@ -122,7 +125,7 @@ AnimationInstance::~AnimationInstance() {
 }
 
 void AnimationInstance::Update( float deltaT ) {
-	if ( animData->animations.empty() || bodiesToAnimate.empty() ) {
+	if ( animData->animations.empty() || bodiesToAnimate.Size() == 0 ) {
 		// no anim data, so dont update the pose ( just stay in t-pose )
 		return;
 	}
@@ -175,7 +178,7 @@ void AnimationInstance::Update( float deltaT ) {
 	}
 
 	// Apply transforms to all bodies rendered in the scene
-	if ( bodiesToAnimate.empty() ) {
+	if ( bodiesToAnimate.Size() == 0 ) {
 		return;
 	}
 	switch ( animData->skeletonType ) {
@@ -184,7 +187,7 @@ void AnimationInstance::Update( float deltaT ) {
 		case AnimationAssets::DEBUG_SKELETON: {
 			// apply each bone transform to each body ( 1 to 1 )
 			for ( int i = 0; i < animData->BoneCount(); i++ ) {
-				Body & bodyToAnimate			= bodiesToAnimate[ i ];
+				Body bodyToAnimate				= bodiesToAnimate.GetBodyAt( i );
 
 				BoneTransform transform;
 				if ( animMode == eAnimMode::GLOBAL ) {
@@ -195,15 +198,14 @@ void AnimationInstance::Update( float deltaT ) {
 					transform = boneTransforms[ i ];
 				}
 
-				bodyToAnimate.m_orientation		= transform.rotation;
-				bodyToAnimate.m_position		= worldPos + transform.translation;
+				bodyToAnimate.GetOrientation()	= transform.rotation;
+				bodyToAnimate.GetPosition()		= worldPos + transform.translation;
 			}
 			break;
 		}
 		case AnimationAssets::SKINNED_MESH: {
 			// handle the case of only ONE BODY, with ONE SHAPE,
-			Body & bodyToAnimate   = bodiesToAnimate[ 0 ];
-			ShapeLoadedMesh * mesh = reinterpret_cast< ShapeLoadedMesh * >( bodyToAnimate.m_shape );
+			ShapeLoadedMesh * mesh = reinterpret_cast< ShapeLoadedMesh * >( bodiesToAnimate.m_shapes[ 0 ] );
 			if ( animMode == eAnimMode::GLOBAL ) {
 				mesh->PopulateMatrixPalette( fbxBoneTransforms );
 			} else if ( animMode == eAnimMode::LOCAL ) {
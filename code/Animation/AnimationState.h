@@ -26,7 +26,7 @@ struct AnimationInstance {
 	std::map< std::string, AnimationClip >::iterator pCurAnim;
 
 	Vec3 worldPos = Vec3( 0, 0, 15 );
-	std::vector< Body > bodiesToAnimate;
+	BodyStore bodiesToAnimate;
 
 	bool isInstanced = true;
 	bool startInTPose = true;
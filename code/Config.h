@@ -31,6 +31,9 @@ static constexpr float ZOOM_MULTIPLIER = 35.f;
 static constexpr float GIZMO_SCALE	   = 20.f;
 
 static constexpr bool TEST_WITHOUT_TOI = false;
+// every body keeps its own clock during the TOI step, so a contact only advances the two bodies in it
+// ( false steps the whole scene to every contact's time of impact, k contacts cost k * N body updates )
+static constexpr bool TOI_LOCAL_TIME = true;
 static constexpr bool PRINT_FRAME_TIME = false;
 
 // Animation
@@ -60,9 +63,41 @@ static constexpr bool CONVERT_SCENE = true;
 
 // Physics
 #include "Math/Vector.h"
+#include "Physics/Broadphase.h"
 static constexpr float GRAVITY_MAGNITUDE = 10.f;
 static const Vec3 GRAV_ACCEL = { 0.f, 0.f, -GRAVITY_MAGNITUDE };
 
+// broadphase the scene starts with ( "B" cycles through them at runtime )
+static constexpr broadPhaseType_t DEFAULT_BROADPHASE = BROADPHASE_SWEEP_AND_PRUNE;
+// cell size of the spatial hash broadphase ( 0 = pick it from the body bounds )
+static constexpr float SPATIAL_HASH_CELL_SIZE = 0.f;
+// sleeping, bodies slower than this for long enough fall asleep along with their whole island
+static constexpr bool ENABLE_SLEEPING = true;
+static constexpr float SLEEP_LINEAR_VELOCITY = 0.25f;
+static constexpr float SLEEP_ANGULAR_VELOCITY = 0.25f;
+static constexpr float TIME_TO_SLEEP = 0.5f;
+// step the bodies SIMD_WIDTH at a time ( false runs the same integrator one body at a time )
+static constexpr bool SIMD_INTEGRATOR = true;
+// sweep sphere pairs SIMD_WIDTH at a time in the narrowphase ( false runs the same kernel one pair at a time )
+static constexpr bool SIMD_NARROWPHASE = true;
+// solve the contacts of colored manifolds SIMD_WIDTH manifolds at a time ( false solves them one at a time )
+static constexpr bool SIMD_SOLVER = true;
+// worker threads used by the physics, including the main thread ( capped to the hardware threads )
+static constexpr unsigned NUM_THREADS_PHYSICS = 32;
+// below this many broadphase pairs the narrowphase runs on the calling thread
+static constexpr int MIN_PARALLEL_NARROWPHASE_PAIRS = 256;
+// the solver only splits a color across the threads when each of them gets at least this many constraints
+static constexpr int MIN_PARALLEL_SOLVER_BATCH = 64;
+// resting contacts and joints are solved with sequential impulses, warm started from the last step's.
+// the iterations stop early once a whole one changes no contact impulse by more than the tolerance
+static constexpr int SOLVER_MAX_ITERATIONS = 10;
+static constexpr float SOLVER_TOLERANCE = 1e-4f;
+// scales every impulse change the solver makes, above 1 over relaxes ( SOR ) and can converge in fewer iterations
+static constexpr float SOLVER_RELAXATION = 1.0f;
+// bodies overlapping deeper than this ( e.g. spawned inside each other ) are pushed apart by the
+// contact resolve's projection instead, the solver would have to shoot them apart
+static constexpr float MAX_RESTING_PENETRATION = 0.1f;
+
 // Rendering
 static constexpr float FAR_CLIPPING_PLANE_CAM	 = 30000.f;
 static constexpr float FAR_CLIPPING_PLANE_SHADOW = 175.f;
\ No newline at end of file
@@ -30,6 +30,33 @@ bool Bounds::DoesIntersect( const Bounds & rhs ) const {
 	return true;
 }
 
+/*
+====================================================
+Bounds::Contains
+====================================================
+*/
+bool Bounds::Contains( const Bounds & rhs ) const {
+	if ( rhs.mins.x < mins.x || rhs.mins.y < mins.y || rhs.mins.z < mins.z ) {
+		return false;
+	}
+	if ( rhs.maxs.x > maxs.x || rhs.maxs.y > maxs.y || rhs.maxs.z > maxs.z ) {
+		return false;
+	}
+	return true;
+}
+
+/*
+====================================================
+Bounds::SurfaceArea
+====================================================
+*/
+float Bounds::SurfaceArea() const {
+	const float dx = WidthX();
+	const float dy = WidthY();
+	const float dz = WidthZ();
+	return 2.0f * ( dx * dy + dy * dz + dz * dx );
+}
+
 /*
 ====================================================
 Bounds::Expand
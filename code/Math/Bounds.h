@@ -21,6 +21,7 @@ public:
 
 	void Clear() { mins = Vec3( 1e6 ); maxs = Vec3( -1e6 ); }
 	bool DoesIntersect( const Bounds & rhs ) const;
+	bool Contains( const Bounds & rhs ) const;
 	void Expand( const Vec3 * pts, const int num );
 	void Expand( const Vec3 & rhs );
 	void Expand( const Bounds & rhs );
@@ -29,6 +30,8 @@ public:
 	float WidthY() const { return maxs.y - mins.y; }
 	float WidthZ() const { return maxs.z - mins.z; }
 
+	float SurfaceArea() const;
+
 public:
 	Vec3 mins;
 	Vec3 maxs;
@@ -0,0 +1,49 @@
+//
+//	BoundsSoA.cpp
+//
+#include "BoundsSoA.h"
+#include <float.h>
+
+/*
+====================================================
+BoundsSoA::Resize
+====================================================
+*/
+void BoundsSoA::Resize( const int num ) {
+	m_num = num;
+
+	// inverted bounds in the padding, they fail every overlap test
+	const int padded = ( ( num + SIMD_WIDTH - 1 ) / SIMD_WIDTH ) * SIMD_WIDTH + SIMD_WIDTH;
+	minX.assign( padded, FLT_MAX );
+	minY.assign( padded, FLT_MAX );
+	minZ.assign( padded, FLT_MAX );
+	maxX.assign( padded, -FLT_MAX );
+	maxY.assign( padded, -FLT_MAX );
+	maxZ.assign( padded, -FLT_MAX );
+}
+
+/*
+====================================================
+BoundsSoA::Set
+====================================================
+*/
+void BoundsSoA::Set( const int idx, const Bounds & bounds ) {
+	minX[ idx ] = bounds.mins.x;
+	minY[ idx ] = bounds.mins.y;
+	minZ[ idx ] = bounds.mins.z;
+	maxX[ idx ] = bounds.maxs.x;
+	maxY[ idx ] = bounds.maxs.y;
+	maxZ[ idx ] = bounds.maxs.z;
+}
+
+/*
+====================================================
+BoundsSoA::Get
+====================================================
+*/
+Bounds BoundsSoA::Get( const int idx ) const {
+	Bounds bounds;
+	bounds.mins = Vec3( minX[ idx ], minY[ idx ], minZ[ idx ] );
+	bounds.maxs = Vec3( maxX[ idx ], maxY[ idx ], maxZ[ idx ] );
+	return bounds;
+}
\ No newline at end of file
@@ -0,0 +1,69 @@
+//
+//	BoundsSoA.h
+//
+#pragma once
+#include "Bounds.h"
+#include "Simd.h"
+#include <vector>
+
+/*
+====================================================
+BoundsSoA
+
+Many bounds stored as one array per component, so a single bounds can be
+tested against SIMD_WIDTH others with a handful of wide compares. The arrays
+are padded up to a multiple of SIMD_WIDTH with inverted bounds that never
+overlap anything, so the kernels never need a scalar tail.
+====================================================
+*/
+class BoundsSoA {
+public:
+	BoundsSoA() : m_num( 0 ) {}
+
+	void Resize( const int num );
+	int Size() const { return m_num; }
+
+	void Set( const int idx, const Bounds & bounds );
+	Bounds Get( const int idx ) const;
+
+	// bit k is set if bounds[ first + k ] overlaps bounds[ query ], for k < SIMD_WIDTH
+	int OverlapMask( const int query, const int first ) const;
+
+public:
+	std::vector< float > minX;
+	std::vector< float > minY;
+	std::vector< float > minZ;
+	std::vector< float > maxX;
+	std::vector< float > maxY;
+	std::vector< float > maxZ;
+
+private:
+	int m_num;
+};
+
+/*
+====================================================
+BoundsSoA::OverlapMask
+====================================================
+*/
+inline int BoundsSoA::OverlapMask( const int query, const int first ) const {
+#if defined( SIMD_AVX )
+	__m256 overlap;
+	overlap =						   _mm256_cmp_ps( _mm256_loadu_ps( &minX[ first ] ), _mm256_set1_ps( maxX[ query ] ), _CMP_LE_OQ );
+	overlap = _mm256_and_ps( overlap, _mm256_cmp_ps( _mm256_loadu_ps( &maxX[ first ] ), _mm256_set1_ps( minX[ query ] ), _CMP_GE_OQ ) );
+	overlap = _mm256_and_ps( overlap, _mm256_cmp_ps( _mm256_loadu_ps( &minY[ first ] ), _mm256_set1_ps( maxY[ query ] ), _CMP_LE_OQ ) );
+	overlap = _mm256_and_ps( overlap, _mm256_cmp_ps( _mm256_loadu_ps( &maxY[ first ] ), _mm256_set1_ps( minY[ query ] ), _CMP_GE_OQ ) );
+	overlap = _mm256_and_ps( overlap, _mm256_cmp_ps( _mm256_loadu_ps( &minZ[ first ] ), _mm256_set1_ps( maxZ[ query ] ), _CMP_LE_OQ ) );
+	overlap = _mm256_and_ps( overlap, _mm256_cmp_ps( _mm256_loadu_ps( &maxZ[ first ] ), _mm256_set1_ps( minZ[ query ] ), _CMP_GE_OQ ) );
+	return _mm256_movemask_ps( overlap );
+#else
+	__m128 overlap;
+	overlap =					   _mm_cmple_ps( _mm_loadu_ps( &minX[ first ] ), _mm_set1_ps( maxX[ query ] ) );
+	overlap = _mm_and_ps( overlap, _mm_cmpge_ps( _mm_loadu_ps( &maxX[ first ] ), _mm_set1_ps( minX[ query ] ) ) );
+	overlap = _mm_and_ps( overlap, _mm_cmple_ps( _mm_loadu_ps( &minY[ first ] ), _mm_set1_ps( maxY[ query ] ) ) );
+	overlap = _mm_and_ps( overlap, _mm_cmpge_ps( _mm_loadu_ps( &maxY[ first ] ), _mm_set1_ps( minY[ query ] ) ) );
+	overlap = _mm_and_ps( overlap, _mm_cmple_ps( _mm_loadu_ps( &minZ[ first ] ), _mm_set1_ps( maxZ[ query ] ) ) );
+	overlap = _mm_and_ps( overlap, _mm_cmpge_ps( _mm_loadu_ps( &maxZ[ first ] ), _mm_set1_ps( minZ[ query ] ) ) );
+	return _mm_movemask_ps( overlap );
+#endif
+}
\ No newline at end of file
@@ -2,13 +2,84 @@
 //	LCP.h
 //
 #pragma once
-#include "Vector.h"
-#include "Matrix.h"
+#include "Simd.h"
 
+/*
+====================================================
+lcpParams_t
+
+how hard LCP_Iterate tries. it stops at whichever comes first, the
+iteration cap or a sweep that changed nothing by more than the tolerance
+====================================================
+*/
+struct lcpParams_t {
+	lcpParams_t() : relaxation( 1.0f ), tolerance( 1e-4f ), maxIterations( 10 ) {}
+
+	float	relaxation;		// 1 is plain gauss seidel, above 1 over relaxes ( SOR ), keep it under 2
+	float	tolerance;
+	int		maxIterations;
+};
+
+/*
+====================================================
+lcpStats_t
+====================================================
+*/
+struct lcpStats_t {
+	lcpStats_t() : iterations( 0 ), residual( 0.0f ) {}
+
+	int		iterations;		// sweeps actually run
+	float	residual;		// largest change to any x during the last sweep
+};
+
+/*
+====================================================
+LCP_ProjectRow
+
+the projection half of projected gauss seidel. it's the impulse accumulated
+over all the sweeps that gets clamped to [ lower, upper ], not the change one
+sweep makes, so a row can give back impulse it applied earlier. written once
+for a float or a whole register of rows
+====================================================
+*/
+template< typename lane_t >
+inline lane_t LCP_ProjectRow( const lane_t & lambda, const lane_t & lower, const lane_t & upper ) {
+	return SimdMin( SimdMax( lambda, lower ), upper );
+}
 
 /*
 ====================================================
-LCP_GaussSeidel
+LCP_FrictionLimit
+
+friction can't be stronger than the normal impulse allows, the friction rows
+are projected to [ -limit, limit ] with the contact's current normal impulse
 ====================================================
 */
-VecN LCP_GaussSeidel( const MatN & A, const VecN & b );
\ No newline at end of file
+template< typename lane_t >
+inline lane_t LCP_FrictionLimit( const lane_t & friction, const lane_t & normalLambda ) {
+	return friction * normalLambda;
+}
+
+/*
+====================================================
+LCP_Iterate
+
+the iteration policy of a projected gauss seidel solver. sweep makes one pass
+over the rows, clamping as it goes, and returns the largest change it made to
+any of them. the solver's rows are kept in the constraints themselves, not in a
+matrix, so they are solved in place
+====================================================
+*/
+template< typename SweepFunc >
+inline lcpStats_t LCP_Iterate( const lcpParams_t & params, SweepFunc sweep ) {
+	lcpStats_t stats;
+	while ( stats.iterations < params.maxIterations ) {
+		stats.residual = sweep();
+		stats.iterations++;
+
+		if ( stats.residual < params.tolerance ) {
+			break;
+		}
+	}
+	return stats;
+}
\ No newline at end of file
@@ -546,9 +546,9 @@ MatMN
 */
 class MatMN {
 public:
-	MatMN() : M( 0 ), N( 0 ) {}
+	MatMN() : M( 0 ), N( 0 ), rows( NULL ) {}
 	MatMN( int M, int N );
-	MatMN( const MatMN & rhs ) {
+	MatMN( const MatMN & rhs ) : rows( NULL ) {
 		*this = rhs;
 	}
 	~MatMN() { delete[] rows; }
@@ -578,6 +578,11 @@ inline MatMN::MatMN( int _M, int _N ) {
 }
 
 inline const MatMN & MatMN::operator = ( const MatMN & rhs ) {
+	if ( this == &rhs ) {
+		return *this;
+	}
+	delete[] rows;
+
 	M = rhs.M;
 	N = rhs.N;
 	rows = new VecN[ M ];
@@ -657,12 +662,12 @@ MatN
 */
 class MatN {
 public:
-	MatN() : numDimensions( 0 ) {}
+	MatN() : numDimensions( 0 ), rows( NULL ) {}
 	MatN( int N );
-	MatN( const MatN & rhs ) {
+	MatN( const MatN & rhs ) : rows( NULL ) {
 		*this = rhs;
 	}
-	MatN( const MatMN & rhs ) {
+	MatN( const MatMN & rhs ) : rows( NULL ) {
 		*this = rhs;
 	}
 	~MatN() { delete[] rows; }
@@ -692,6 +697,11 @@ inline MatN::MatN( int N ) {
 }
 
 inline const MatN & MatN::operator = ( const MatN & rhs ) {
+	if ( this == &rhs ) {
+		return *this;
+	}
+	delete[] rows;
+
 	numDimensions = rhs.numDimensions;
 	rows = new VecN[ numDimensions ];
 	for ( int i = 0; i < numDimensions; i++ ) {
@@ -704,6 +714,7 @@ inline const MatN & MatN::operator = ( const MatMN & rhs ) {
 	if ( rhs.M != rhs.N ) {
 		return *this;
 	}
+	delete[] rows;
 
 	numDimensions = rhs.N;
 	rows = new VecN[ numDimensions ];
@@ -764,5 +775,86 @@ inline MatN MatN::operator * ( const MatN & rhs ) {
 		}
 	}
 
+	return tmp;
+}
+
+/*
+====================================================
+MatFixed
+
+MatMN with the dimensions known at compile time, rows are VecFixed so the
+whole matrix is one flat block of floats. the products check their
+dimensions when they're compiled instead of at runtime
+====================================================
+*/
+template< int M, int N >
+class MatFixed {
+public:
+	const MatFixed & operator *= ( float rhs );
+	VecFixed< M > operator * ( const VecFixed< N > & rhs ) const;
+	template< int K >
+	MatFixed< M, K > operator * ( const MatFixed< N, K > & rhs ) const;
+	MatFixed operator * ( const float rhs ) const;
+
+	void Zero();
+	MatFixed< N, M > Transpose() const;
+
+public:
+	VecFixed< N > rows[ M ];
+};
+
+template< int M, int N >
+inline const MatFixed< M, N > & MatFixed< M, N >::operator *= ( float rhs ) {
+	for ( int m = 0; m < M; m++ ) {
+		rows[ m ] *= rhs;
+	}
+	return *this;
+}
+
+template< int M, int N >
+inline VecFixed< M > MatFixed< M, N >::operator * ( const VecFixed< N > & rhs ) const {
+	VecFixed< M > tmp;
+	for ( int m = 0; m < M; m++ ) {
+		tmp[ m ] = rhs.Dot( rows[ m ] );
+	}
+	return tmp;
+}
+
+template< int M, int N >
+template< int K >
+inline MatFixed< M, K > MatFixed< M, N >::operator * ( const MatFixed< N, K > & rhs ) const {
+	const MatFixed< K, N > tranposedRHS = rhs.Transpose();
+
+	MatFixed< M, K > tmp;
+	for ( int m = 0; m < M; m++ ) {
+		for ( int k = 0; k < K; k++ ) {
+			tmp.rows[ m ][ k ] = rows[ m ].Dot( tranposedRHS.rows[ k ] );
+		}
+	}
+	return tmp;
+}
+
+template< int M, int N >
+inline MatFixed< M, N > MatFixed< M, N >::operator * ( const float rhs ) const {
+	MatFixed tmp = *this;
+	tmp *= rhs;
+	return tmp;
+}
+
+template< int M, int N >
+inline void MatFixed< M, N >::Zero() {
+	for ( int m = 0; m < M; m++ ) {
+		rows[ m ].Zero();
+	}
+}
+
+template< int M, int N >
+inline MatFixed< N, M > MatFixed< M, N >::Transpose() const {
+	MatFixed< N, M > tmp;
+	for ( int m = 0; m < M; m++ ) {
+		for ( int n = 0; n < N; n++ ) {
+			tmp.rows[ n ][ m ] = rows[ m ][ n ];
+		}
+	}
 	return tmp;
 }
\ No newline at end of file
@@ -0,0 +1,152 @@
+//
+//	Simd.h
+//
+#pragma once
+#include <math.h>
+
+// SSE2 is always there on x64, AVX only when the compiler is allowed to use it ( /arch:AVX )
+#include <emmintrin.h>
+#if defined( __AVX__ )
+#include <immintrin.h>
+#define SIMD_AVX 1
+#endif
+
+#if defined( SIMD_AVX )
+static constexpr int SIMD_WIDTH = 8;
+#else
+static constexpr int SIMD_WIDTH = 4;
+#endif
+
+/*
+====================================================
+simd4f_t / simd8f_t
+
+Thin wrappers around an SSE / AVX register, with the same operators and
+helpers as a plain float, so a kernel can be written once as a template
+and instantiated for 1, 4 or 8 lanes.
+====================================================
+*/
+struct simd4f_t {
+	static constexpr int WIDTH = 4;
+
+	simd4f_t() {}
+	simd4f_t( const __m128 value ) : v( value ) {}
+	simd4f_t( const float value ) : v( _mm_set1_ps( value ) ) {}
+
+	__m128 v;
+};
+
+inline simd4f_t operator + ( const simd4f_t & a, const simd4f_t & b ) { return _mm_add_ps( a.v, b.v ); }
+inline simd4f_t operator - ( const simd4f_t & a, const simd4f_t & b ) { return _mm_sub_ps( a.v, b.v ); }
+inline simd4f_t operator * ( const simd4f_t & a, const simd4f_t & b ) { return _mm_mul_ps( a.v, b.v ); }
+inline simd4f_t operator / ( const simd4f_t & a, const simd4f_t & b ) { return _mm_div_ps( a.v, b.v ); }
+inline simd4f_t operator - ( const simd4f_t & a ) { return _mm_sub_ps( _mm_setzero_ps(), a.v ); }
+
+inline void SimdLoad( simd4f_t & out, const float * src ) { out.v = _mm_loadu_ps( src ); }
+inline void SimdStore( const simd4f_t & in, float * dst ) { _mm_storeu_ps( dst, in.v ); }
+inline simd4f_t SimdSqrt( const simd4f_t & a ) { return _mm_sqrt_ps( a.v ); }
+inline bool SimdAnyGreater( const simd4f_t & a, const float b ) { return _mm_movemask_ps( _mm_cmpgt_ps( a.v, _mm_set1_ps( b ) ) ) != 0; }
+inline simd4f_t SimdMin( const simd4f_t & a, const simd4f_t & b ) { return _mm_min_ps( a.v, b.v ); }
+inline simd4f_t SimdMax( const simd4f_t & a, const simd4f_t & b ) { return _mm_max_ps( a.v, b.v ); }
+
+// comparisons give a mask per lane ( all bits set or clear ), for SimdSelect and SimdMoveMask
+inline simd4f_t SimdLess( const simd4f_t & a, const simd4f_t & b ) { return _mm_cmplt_ps( a.v, b.v ); }
+inline simd4f_t SimdLessEqual( const simd4f_t & a, const simd4f_t & b ) { return _mm_cmple_ps( a.v, b.v ); }
+inline simd4f_t SimdAnd( const simd4f_t & a, const simd4f_t & b ) { return _mm_and_ps( a.v, b.v ); }
+inline simd4f_t SimdSelect( const simd4f_t & mask, const simd4f_t & ifTrue, const simd4f_t & ifFalse ) { return _mm_or_ps( _mm_and_ps( mask.v, ifTrue.v ), _mm_andnot_ps( mask.v, ifFalse.v ) ); }
+inline int SimdMoveMask( const simd4f_t & mask ) { return _mm_movemask_ps( mask.v ); }
+
+#if defined( SIMD_AVX )
+struct simd8f_t {
+	static constexpr int WIDTH = 8;
+
+	simd8f_t() {}
+	simd8f_t( const __m256 value ) : v( value ) {}
+	simd8f_t( const float value ) : v( _mm256_set1_ps( value ) ) {}
+
+	__m256 v;
+};
+
+inline simd8f_t operator + ( const simd8f_t & a, const simd8f_t & b ) { return _mm256_add_ps( a.v, b.v ); }
+inline simd8f_t operator - ( const simd8f_t & a, const simd8f_t & b ) { return _mm256_sub_ps( a.v, b.v ); }
+inline simd8f_t operator * ( const simd8f_t & a, const simd8f_t & b ) { return _mm256_mul_ps( a.v, b.v ); }
+inline simd8f_t operator / ( const simd8f_t & a, const simd8f_t & b ) { return _mm256_div_ps( a.v, b.v ); }
+inline simd8f_t operator - ( const simd8f_t & a ) { return _mm256_sub_ps( _mm256_setzero_ps(), a.v ); }
+
+inline void SimdLoad( simd8f_t & out, const float * src ) { out.v = _mm256_loadu_ps( src ); }
+inline void SimdStore( const simd8f_t & in, float * dst ) { _mm256_storeu_ps( dst, in.v ); }
+inline simd8f_t SimdSqrt( const simd8f_t & a ) { return _mm256_sqrt_ps( a.v ); }
+inline bool SimdAnyGreater( const simd8f_t & a, const float b ) { return _mm256_movemask_ps( _mm256_cmp_ps( a.v, _mm256_set1_ps( b ), _CMP_GT_OQ ) ) != 0; }
+inline simd8f_t SimdMin( const simd8f_t & a, const simd8f_t & b ) { return _mm256_min_ps( a.v, b.v ); }
+inline simd8f_t SimdMax( const simd8f_t & a, const simd8f_t & b ) { return _mm256_max_ps( a.v, b.v ); }
+
+inline simd8f_t SimdLess( const simd8f_t & a, const simd8f_t & b ) { return _mm256_cmp_ps( a.v, b.v, _CMP_LT_OQ ); }
+inline simd8f_t SimdLessEqual( const simd8f_t & a, const simd8f_t & b ) { return _mm256_cmp_ps( a.v, b.v, _CMP_LE_OQ ); }
+inline simd8f_t SimdAnd( const simd8f_t & a, const simd8f_t & b ) { return _mm256_and_ps( a.v, b.v ); }
+inline simd8f_t SimdSelect( const simd8f_t & mask, const simd8f_t & ifTrue, const simd8f_t & ifFalse ) { return _mm256_blendv_ps( ifFalse.v, ifTrue.v, mask.v ); }
+inline int SimdMoveMask( const simd8f_t & mask ) { return _mm256_movemask_ps( mask.v ); }
+
+typedef simd8f_t simdf_t;
+#else
+typedef simd4f_t simdf_t;
+#endif
+
+/*
+====================================================
+SimdStreamStride
+
+distance between the streams of a lane layout with num lanes. padded out to
+a whole number of SIMD batches, plus one cache line whenever the streams
+would start a multiple of 4k apart, so they don't all land in the same L1
+set ( a few dozen streams 64k apart otherwise evict each other constantly )
+====================================================
+*/
+inline int SimdStreamStride( const int num ) {
+	const int padded = ( ( num + SIMD_WIDTH - 1 ) / SIMD_WIDTH ) * SIMD_WIDTH;
+	const int floatsPer4k = 4096 / sizeof( float );
+	const int floatsPerLine = 64 / sizeof( float );
+	return ( padded % floatsPer4k == 0 ) ? padded + floatsPerLine : padded;
+}
+
+// the scalar lane, for tails and fallbacks
+inline void SimdLoad( float & out, const float * src ) { out = *src; }
+inline void SimdStore( const float in, float * dst ) { *dst = in; }
+inline float SimdSqrt( const float a ) { return sqrtf( a ); }
+inline bool SimdAnyGreater( const float a, const float b ) { return a > b; }
+inline float SimdMin( const float a, const float b ) { return ( a < b ) ? a : b; }
+inline float SimdMax( const float a, const float b ) { return ( a > b ) ? a : b; }
+inline bool SimdLess( const float a, const float b ) { return a < b; }
+inline bool SimdLessEqual( const float a, const float b ) { return a <= b; }
+inline bool SimdAnd( const bool a, const bool b ) { return a && b; }
+inline float SimdSelect( const bool mask, const float ifTrue, const float ifFalse ) { return mask ? ifTrue : ifFalse; }
+inline bool SimdSelect( const bool mask, const bool ifTrue, const bool ifFalse ) { return mask ? ifTrue : ifFalse; }
+inline int SimdMoveMask( const bool mask ) { return mask ? 1 : 0; }
+
+// past this half angle the polynomials below drift away from sinf / cosf ( they're still good to ~1e-9 at 0.5 )
+static const float MAX_POLY_HALF_ANGLE_SQR = 0.5f * 0.5f;
+
+/*
+====================================================
+SimdHalfAngleCosSinc
+
+cos( h ) and sin( h ) / h from h^2, taylor series. sin( h ) / h instead of
+sin( h ) means the axis never has to be normalized, and it goes to 1
+instead of 0 / 0 when the body isn't spinning at all
+====================================================
+*/
+template< typename lane_t >
+inline void SimdHalfAngleCosSinc( const lane_t & h2, lane_t & outCos, lane_t & outSinc ) {
+	outCos  = 1.0f + h2 * ( -1.0f / 2.0f + h2 * ( 1.0f / 24.0f  + h2 * ( -1.0f / 720.0f  + h2 * ( 1.0f / 40320.0f ) ) ) );
+	outSinc = 1.0f + h2 * ( -1.0f / 6.0f + h2 * ( 1.0f / 120.0f + h2 * ( -1.0f / 5040.0f + h2 * ( 1.0f / 362880.0f ) ) ) );
+}
+
+// the scalar lane is allowed to take its time
+inline void SimdHalfAngleCosSinc( const float h2, float & outCos, float & outSinc ) {
+	if ( h2 < MAX_POLY_HALF_ANGLE_SQR ) {
+		SimdHalfAngleCosSinc< float >( h2, outCos, outSinc );
+		return;
+	}
+	const float h = sqrtf( h2 );
+	outCos  = cosf( h );
+	outSinc = sinf( h ) / h;
+}
\ No newline at end of file
@@ -781,4 +781,93 @@ inline void VecN::Zero() {
 	for ( int i = 0; i < N; i++ ) {
 		data[ i ] = 0.0f;
 	}
+}
+
+/*
+ ================================
+ VecFixed
+
+ VecN with the size known at compile time, so it lives inline wherever
+ it's declared ( on the stack, or inside the constraint that owns it ) and
+ copying one never touches the heap
+ ================================
+ */
+template< int N >
+class VecFixed {
+public:
+	float			operator[] ( const int idx ) const { return data[ idx ]; }
+	float &			operator[] ( const int idx ) { return data[ idx ]; }
+	const VecFixed &	operator *= ( float rhs );
+	VecFixed		operator * ( float rhs ) const;
+	VecFixed		operator + ( const VecFixed & rhs ) const;
+	VecFixed		operator - ( const VecFixed & rhs ) const;
+	const VecFixed &	operator += ( const VecFixed & rhs );
+	const VecFixed &	operator -= ( const VecFixed & rhs );
+
+	float Dot( const VecFixed & rhs ) const;
+	void Zero();
+
+public:
+	float data[ N ];
+};
+
+template< int N >
+inline const VecFixed< N > & VecFixed< N >::operator *= ( float rhs ) {
+	for ( int i = 0; i < N; i++ ) {
+		data[ i ] *= rhs;
+	}
+	return *this;
+}
+
+template< int N >
+inline VecFixed< N > VecFixed< N >::operator * ( float rhs ) const {
+	VecFixed tmp = *this;
+	tmp *= rhs;
+	return tmp;
+}
+
+template< int N >
+inline VecFixed< N > VecFixed< N >::operator + ( const VecFixed & rhs ) const {
+	VecFixed tmp = *this;
+	tmp += rhs;
+	return tmp;
+}
+
+template< int N >
+inline VecFixed< N > VecFixed< N >::operator - ( const VecFixed & rhs ) const {
+	VecFixed tmp = *this;
+	tmp -= rhs;
+	return tmp;
+}
+
+template< int N >
+inline const VecFixed< N > & VecFixed< N >::operator += ( const VecFixed & rhs ) {
+	for ( int i = 0; i < N; i++ ) {
+		data[ i ] += rhs.data[ i ];
+	}
+	return *this;
+}
+
+template< int N >
+inline const VecFixed< N > & VecFixed< N >::operator -= ( const VecFixed & rhs ) {
+	for ( int i = 0; i < N; i++ ) {
+		data[ i ] -= rhs.data[ i ];
+	}
+	return *this;
+}
+
+template< int N >
+inline float VecFixed< N >::Dot( const VecFixed & rhs ) const {
+	float sum = 0;
+	for ( int i = 0; i < N; i++ ) {
+		sum += data[ i ] * rhs.data[ i ];
+	}
+	return sum;
+}
+
+template< int N >
+inline void VecFixed< N >::Zero() {
+	for ( int i = 0; i < N; i++ ) {
+		data[ i ] = 0.0f;
+	}
 }
\ No newline at end of file
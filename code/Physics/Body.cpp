@@ -5,25 +5,51 @@
 
 /*
 ====================================================
-Body::Body
+Body::Sleep
 ====================================================
 */
-Body::Body() :
-    m_position( 0.0f ),
-    m_orientation( 0.0f, 0.0f, 0.0f, 1.0f ),
-    m_shape( NULL ) {
+void Body::Sleep( const int islandId ) {
+    const int idx = GetIndex();
+    m_store->m_isAwake[ idx ]     = 0;
+    m_store->m_sleepTimers[ idx ] = 0.0f;
+    m_store->m_islandIds[ idx ]   = islandId;
+
+    // whatever tiny velocity is left would otherwise come back as drift when we wake up
+    m_store->m_linearVelocities[ idx ].Zero();
+    m_store->m_angularVelocities[ idx ].Zero();
+}
+
+void Body::Wake() {
+    const int idx = GetIndex();
+    m_store->m_isAwake[ idx ]     = 1;
+    m_store->m_sleepTimers[ idx ] = 0.0f;
+    m_store->m_islandIds[ idx ]   = -1;
 }
 
 void Body::Update( const float dt_sec ) {
+    // resolve the handle once, not for every field we touch
+    const int idx = GetIndex();
+    PredictState( dt_sec, m_store->m_positions[ idx ], m_store->m_orientations[ idx ], m_store->m_angularVelocities[ idx ] );
+
+    // the new orientation changes the world space inverse inertia the contacts will use
+    m_store->RefreshWorldInertia( idx );
+}
+
+// the math of Update, but advancing the state passed in ( a copy of ours, or our own ) instead of the body's.
+// nothing in the store gets written, so any number of threads can predict where the bodies will be
+void Body::PredictState( const float dt_sec, Vec3 & position, Quat & orientation, Vec3 & angularVelocity ) const {
+    const int idx               = GetIndex();
+    const Vec3 & linearVelocity = m_store->m_linearVelocities[ idx ];
+
     // position
-    m_position += m_linearVelocity * dt_sec;
+    position += linearVelocity * dt_sec;
 
     // orientation
     // 1. angular velocity operates relative to the center of mass, 
     //    so convert our world pos to be relative to center of mass
     //    ( use center of mass as our origin )
-    const Vec3 centerOfMass = GetCenterOfMassWorldSpace();
-    const Vec3 posRelToCM = m_position - centerOfMass;
+    const Vec3 centerOfMass = position + orientation.RotatePoint( m_store->m_centersOfMass[ idx ] );
+    const Vec3 posRelToCM = position - centerOfMass;
 
     // 2. Calculate total torque
     //    -> equal to externally applied torque + precession ( internal torque about its own axis )
@@ -33,10 +59,12 @@ void Body::Update( const float dt_sec ) {
     // 3. Calculate angular velocity delta 
     //    I a =        w X I * w
     //      a = I^-1 ( w X I * w )
-    const Mat3 toWorldOrientation = m_orientation.ToMat3();
-    const Mat3 iTensorGeom_WS     = toWorldOrientation * m_shape->InertiaTensorGeometric() * toWorldOrientation.Transpose();
-    const Vec3 deltaAngVelocity   = iTensorGeom_WS.Inverse() * ( m_angularVelocity.Cross( iTensorGeom_WS * m_angularVelocity ) );
-    m_angularVelocity             += deltaAngVelocity * dt_sec;
+    //    ( rotating the cached inverse is the same as inverting the rotated tensor, and a lot cheaper )
+    const Mat3 toWorldOrientation = orientation.ToMat3();
+    const Mat3 iTensorGeom_WS     = toWorldOrientation * m_store->m_inertiaGeometric[ idx ] * toWorldOrientation.Transpose();
+    const Mat3 invTensorGeom_WS   = toWorldOrientation * m_store->m_invInertiaGeometric[ idx ] * toWorldOrientation.Transpose();
+    const Vec3 deltaAngVelocity   = invTensorGeom_WS * ( angularVelocity.Cross( iTensorGeom_WS * angularVelocity ) );
+    angularVelocity             += deltaAngVelocity * dt_sec;
 
     // @TODO ^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^
     //   we are getting the pure geometric inertia tensor here, which doesnt include mass yet...
@@ -48,37 +76,37 @@ void Body::Update( const float dt_sec ) {
 
     // NOTE - the quat constructor normalizes the axis for us
     // 4. Update orientation
-    Vec3 deltaAngle = m_angularVelocity * dt_sec;
+    Vec3 deltaAngle = angularVelocity * dt_sec;
     Quat deltaQuat  = Quat( deltaAngle, deltaAngle.GetMagnitude() );
-    m_orientation   = deltaQuat * m_orientation;
-    m_orientation.Normalize();
+    orientation   = deltaQuat * orientation;
+    orientation.Normalize();
 
     // 5. update position, since above rotation can also affect that
-    m_position = centerOfMass + deltaQuat.RotatePoint( posRelToCM );
+    position = centerOfMass + deltaQuat.RotatePoint( posRelToCM );
 }
 
 Vec3 Body::GetCenterOfMassWorldSpace() const {
     // rotate the center of mass as defined in MODEL space, 
     // by the world orientation of the object, it may not be at the model origin
-    const Vec3 centerOfMassWorldRotation = m_orientation.RotatePoint( m_shape->GetCenterOfMass() );
+    const Vec3 centerOfMassWorldRotation = GetOrientation().RotatePoint( GetShape()->GetCenterOfMass() );
     // add world offset to this rotated point
-    return m_position + centerOfMassWorldRotation;
+    return GetPosition() + centerOfMassWorldRotation;
 }
 
 Vec3 Body::GetCenterOfMassModelSpace() const {
     // return center of mass respect to MODEL origin, with MODEL space orientation
-    return m_shape->GetCenterOfMass();
+    return GetShape()->GetCenterOfMass();
 }
 
 Vec3 Body::WorldSpaceToBodySpace( const Vec3 & worldPt ) const {
     const Vec3 pointRelToCenterOfMass_WS = worldPt - GetCenterOfMassWorldSpace();
-    const Quat orientationRelToBody      = m_orientation.Inverse();
+    const Quat orientationRelToBody      = GetOrientation().Inverse();
     const Vec3 pointOrientedRelToBody    = orientationRelToBody.RotatePoint( pointRelToCenterOfMass_WS );
     return pointOrientedRelToBody;
 }
 
 Vec3 Body::BodySpaceToWorldSpace( const Vec3 & localPt ) const {
-    const Vec3 pointOrientedRelToWorld      = m_orientation.RotatePoint( localPt );
+    const Vec3 pointOrientedRelToWorld      = GetOrientation().RotatePoint( localPt );
     const Vec3 orientedPointWithWorldOffset = pointOrientedRelToWorld + GetCenterOfMassWorldSpace();
     return orientedPointWithWorldOffset;
 }
@@ -86,25 +114,14 @@ Vec3 Body::BodySpaceToWorldSpace( const Vec3 & localPt ) const {
 Mat3 Body::GetInverseInertiaTensorBodySpace() const {
     // NOTE - inverting matrix, then multiplying by inv mass, is the same as multiplying by mass, then inverting
     // ( bc of commutable scalar multiplication by mass/invmass, mass gets inverted in the process of inverting the matrix )
-    const Mat3 iTensorGeom       = m_shape->InertiaTensorGeometric();
-    const Mat3 invTensorGeom     = iTensorGeom.Inverse();
-    const Mat3 invInertialTensor = invTensorGeom * m_invMass;
-    return invInertialTensor;
-}
-
-Mat3 Body::GetInverseInertiaTensorWorldSpace() const {
-    const Mat3 invInertialTensor = GetInverseInertiaTensorBodySpace();
-
-    // @TODO, why sandwich product? basically queueing up ( encoding ) the following transformation sequence?
-    // [ change-of-basis to world space >> transform by inv inertial tensor >> change-of-basis back to local ]
-    const Mat3 orientation = m_orientation.ToMat3();
-    Mat3 invITensorWorld   = orientation * invInertialTensor * orientation.Transpose();
-    return invITensorWorld;
+    // the inverse itself was taken once, when the shape was set
+    const int idx = GetIndex();
+    return m_store->m_invInertiaGeometric[ idx ] * m_store->m_invMasses[ idx ];
 }
 
 // apply both angular and linear impulses
 void Body::ApplyImpulse( const Vec3 impulsePoint, const Vec3 & impulseLinear ) {
-    if ( m_invMass == 0.f ) {
+    if ( GetInvMass() == 0.f ) {
         return;
     }
 
@@ -118,10 +135,14 @@ void Body::ApplyImpulse( const Vec3 impulsePoint, const Vec3 & impulseLinear ) {
 
 void Body::ApplyImpulseLinear( const Vec3 & impulse ) {
     // 0 would imply infinitely massive object unaffected by impulses
-    if ( m_invMass == 0.f ) {
+    const int idx = GetIndex();
+    if ( m_store->m_invMasses[ idx ] == 0.f ) {
         return;
     }
 
+    // the rest of our island gets woken up by the scene on its next update
+    m_store->m_isAwake[ idx ] = 1;
+
     //////////////// * D = "delta"    * //////////
     //////////////// * J = "momentum" * //////////
     //                                          //
@@ -130,24 +151,49 @@ void Body::ApplyImpulseLinear( const Vec3 & impulse ) {
     // J / m = velocity D                       //
     //                                          //
     //////////////////////////////////////////////
-    m_linearVelocity += impulse * m_invMass;
+    m_store->m_linearVelocities[ idx ] += impulse * m_store->m_invMasses[ idx ];
 }
 
 void Body::ApplyImpulseAngular( const Vec3 & impulse ) {
     // 0 would imply infinitely massive object unaffected by impulses
-    if ( m_invMass == 0.f ) {
+    const int idx = GetIndex();
+    if ( m_store->m_invMasses[ idx ] == 0.f ) {
         return;
     }
 
+    // the rest of our island gets woken up by the scene on its next update
+    m_store->m_isAwake[ idx ] = 1;
+
     // Angular momentum   = Inertia tensor     * Angular velocity         = radius CROSS momentum
     // D Angular momentum = Inertia tensor     * D Angular velocity       = radius CROSS impulse
     // THEREFORE : 
     // D angular velocity = inv Inertia tensor * ( radius CROSS impulse )
-    m_angularVelocity += GetInverseInertiaTensorWorldSpace() * impulse;
+    Vec3 & angularVelocity = m_store->m_angularVelocities[ idx ];
+    angularVelocity += GetInverseInertiaTensorWorldSpace() * impulse;
+
+    const float maxAngularSpeed = 30.f;
+    if ( angularVelocity.GetLengthSqr() > maxAngularSpeed * maxAngularSpeed ) {
+        angularVelocity.Normalize();
+        angularVelocity *= maxAngularSpeed;
+    }
+}
+
+void Body::ApplyVelocityChange( const Vec3 & linear, const Vec3 & angular ) {
+    const int idx = GetIndex();
+    if ( m_store->m_invMasses[ idx ] == 0.f ) {
+        return;
+    }
+
+    m_store->m_isAwake[ idx ] = 1;
+    m_store->m_linearVelocities[ idx ] += linear;
+
+    // same cap as ApplyImpulseAngular
+    Vec3 & angularVelocity = m_store->m_angularVelocities[ idx ];
+    angularVelocity += angular;
 
     const float maxAngularSpeed = 30.f;
-    if ( m_angularVelocity.GetLengthSqr() > maxAngularSpeed * maxAngularSpeed ) {
-        m_angularVelocity.Normalize();
-        m_angularVelocity *= maxAngularSpeed;
+    if ( angularVelocity.GetLengthSqr() > maxAngularSpeed * maxAngularSpeed ) {
+        angularVelocity.Normalize();
+        angularVelocity *= maxAngularSpeed;
     }
 }
@@ -7,6 +7,7 @@
 #include "../Math/Matrix.h"
 #include "../Math/Bounds.h"
 #include "Shapes.h"
+#include "BodyStore.h"
 
 #include "../Renderer/model.h"
 #include "../Renderer/shader.h"
@@ -14,26 +15,58 @@
 /*
 ====================================================
 Body
+
+Lightweight view of one body in a BodyStore, just the store and a handle,
+so it's cheap to copy around and stays valid when the store grows or
+other bodies get removed. Every access resolves the handle, so hot loops
+over all bodies should go through the store's arrays directly instead.
 ====================================================
 */
 class Body {
 public:
-	Body();
+	Body() : m_store( nullptr ), m_handle( INVALID_BODY_HANDLE ) {}
+	Body( BodyStore * store, const bodyHandle_t handle ) : m_store( store ), m_handle( handle ) {}
+
+	bool IsValid() const { return m_store != nullptr && m_store->IsValid( m_handle ); }
+	BodyStore * GetStore() const { return m_store; }
+	bodyHandle_t GetHandle() const { return m_handle; }
+	int GetIndex() const { return m_store->GetIndex( m_handle ); }
+
+	bool operator == ( const Body & rhs ) const { return m_store == rhs.m_store && m_handle == rhs.m_handle; }
+	bool operator != ( const Body & rhs ) const { return !( *this == rhs ); }
 
-	// @HACK for now
-	bool isSkinnedMesh = false;
+	Vec3 &			GetPosition()				{ return m_store->m_positions[ GetIndex() ]; }
+	const Vec3 &	GetPosition() const			{ return m_store->m_positions[ GetIndex() ]; }
+	Quat &			GetOrientation()			{ return m_store->m_orientations[ GetIndex() ]; }
+	const Quat &	GetOrientation() const		{ return m_store->m_orientations[ GetIndex() ]; }
+	Vec3 &			GetLinearVelocity()			{ return m_store->m_linearVelocities[ GetIndex() ]; }
+	const Vec3 &	GetLinearVelocity() const	{ return m_store->m_linearVelocities[ GetIndex() ]; }
+	Vec3 &			GetAngularVelocity()		{ return m_store->m_angularVelocities[ GetIndex() ]; }
+	const Vec3 &	GetAngularVelocity() const	{ return m_store->m_angularVelocities[ GetIndex() ]; }
 
-	Vec3  m_position;
-	Quat  m_orientation;
-	Vec3  m_linearVelocity;
-	Vec3  m_angularVelocity;
+	float &			GetInvMass()				{ return m_store->m_invMasses[ GetIndex() ]; }
+	float			GetInvMass() const			{ return m_store->m_invMasses[ GetIndex() ]; }
+	float &			GetElasticity()				{ return m_store->m_elasticities[ GetIndex() ]; }
+	float			GetElasticity() const		{ return m_store->m_elasticities[ GetIndex() ]; }
+	float &			GetFriction()				{ return m_store->m_frictions[ GetIndex() ]; }
+	float			GetFriction() const			{ return m_store->m_frictions[ GetIndex() ]; }
+	Shape *			GetShape()					{ return m_store->m_shapes[ GetIndex() ]; }
+	const Shape *	GetShape() const			{ return m_store->m_shapes[ GetIndex() ]; }
+	void			SetShape( Shape * shape )	{ m_store->SetShape( GetIndex(), shape ); }
+	bool			IsSkinnedMesh() const		{ return m_store->m_isSkinnedMesh[ GetIndex() ] != 0; }
 
-	float m_invMass;
-	float m_elasticity;
-	float m_friction;
-	Shape *	m_shape;
+	// sleeping
+	bool			IsAwake() const				{ return m_store->m_isAwake[ GetIndex() ] != 0; }
+	int				GetIslandId() const			{ return m_store->m_islandIds[ GetIndex() ]; }
+	float &			GetSleepTimer()				{ return m_store->m_sleepTimers[ GetIndex() ]; }
+
+	// only dynamic bodies that are awake get integrated and collided
+	bool IsActive() const { return m_store->IsActive( GetIndex() ); }
+	void Sleep( const int islandId );
+	void Wake();
 
 	void Update( const float dt_sec );
+	void PredictState( const float dt_sec, Vec3 & position, Quat & orientation, Vec3 & angularVelocity ) const;
 
 	Vec3 GetCenterOfMassModelSpace() const;
 	Vec3 GetCenterOfMassWorldSpace() const;
@@ -41,10 +74,18 @@ public:
 	Vec3 WorldSpaceToBodySpace( const Vec3 & worldPt ) const;
 	Vec3 BodySpaceToWorldSpace( const Vec3 & worldPt ) const;
 
+	// both come from the store's cache, the world space one is as of the last time the body was integrated
 	Mat3 GetInverseInertiaTensorBodySpace() const;
-	Mat3 GetInverseInertiaTensorWorldSpace() const;
+	const Mat3 & GetInverseInertiaTensorWorldSpace() const { return m_store->m_invInertiaWorld[ GetIndex() ]; }
 
 	void ApplyImpulse( const Vec3 impulsePoint, const Vec3 & impulse );
 	void ApplyImpulseLinear( const Vec3 & impulse );
 	void ApplyImpulseAngular( const Vec3 & impulse );
+
+	// for callers that already multiplied the impulse through the inverse mass themselves
+	void ApplyVelocityChange( const Vec3 & linear, const Vec3 & angular );
+
+private:
+	BodyStore *		m_store;
+	bodyHandle_t	m_handle;
 };
\ No newline at end of file
@@ -0,0 +1,206 @@
+//
+//	BodyStore.cpp
+//
+#include "BodyStore.h"
+#include "Body.h"
+#include "Shapes.h"
+
+/*
+====================================================
+BodyStore::Add
+====================================================
+*/
+bodyHandle_t BodyStore::Add( const bodyDesc_t & desc ) {
+	const int idx = Size();
+
+	// reuse a free slot if there is one, its generation was already bumped by Remove
+	int slot = m_freeSlot;
+	if ( slot >= 0 ) {
+		m_freeSlot = m_slots[ slot ].index;
+	} else {
+		slot = static_cast< int >( m_slots.size() );
+		m_slots.push_back( { 1, 0 } );
+	}
+	m_slots[ slot ].index = idx;
+	m_denseToSlot.push_back( static_cast< uint32_t >( slot ) );
+
+	m_positions.push_back( desc.position );
+	m_orientations.push_back( desc.orientation );
+	m_linearVelocities.push_back( desc.linearVelocity );
+	m_angularVelocities.push_back( desc.angularVelocity );
+	m_invMasses.push_back( desc.invMass );
+
+	m_elasticities.push_back( desc.elasticity );
+	m_frictions.push_back( desc.friction );
+	m_shapes.push_back( desc.shape );
+	m_isSkinnedMesh.push_back( desc.isSkinnedMesh ? 1 : 0 );
+
+	m_centersOfMass.push_back( Vec3( 0.0f ) );
+	m_inertiaGeometric.push_back( Mat3() );
+	m_invInertiaGeometric.push_back( Mat3() );
+	m_invInertiaWorld.push_back( Mat3() );
+	SetShape( idx, desc.shape );
+
+	m_isAwake.push_back( 1 );
+	m_sleepTimers.push_back( 0.0f );
+	m_islandIds.push_back( -1 );
+
+	m_version++;
+	return { static_cast< uint32_t >( slot ), m_slots[ slot ].generation };
+}
+
+/*
+====================================================
+BodyStore::Remove
+
+swap the last body into the hole, so the arrays stay dense. the shape is
+not deleted, the store never owned it
+====================================================
+*/
+void BodyStore::Remove( const bodyHandle_t handle ) {
+	const int idx = GetIndex( handle );
+	const int last = Size() - 1;
+
+	if ( idx != last ) {
+		m_positions[ idx ]			= m_positions[ last ];
+		m_orientations[ idx ]		= m_orientations[ last ];
+		m_linearVelocities[ idx ]	= m_linearVelocities[ last ];
+		m_angularVelocities[ idx ]	= m_angularVelocities[ last ];
+		m_invMasses[ idx ]			= m_invMasses[ last ];
+		m_elasticities[ idx ]		= m_elasticities[ last ];
+		m_frictions[ idx ]			= m_frictions[ last ];
+		m_shapes[ idx ]				= m_shapes[ last ];
+		m_isSkinnedMesh[ idx ]		= m_isSkinnedMesh[ last ];
+		m_centersOfMass[ idx ]		= m_centersOfMass[ last ];
+		m_inertiaGeometric[ idx ]	= m_inertiaGeometric[ last ];
+		m_invInertiaGeometric[ idx ]= m_invInertiaGeometric[ last ];
+		m_invInertiaWorld[ idx ]	= m_invInertiaWorld[ last ];
+		m_isAwake[ idx ]			= m_isAwake[ last ];
+		m_sleepTimers[ idx ]		= m_sleepTimers[ last ];
+		m_islandIds[ idx ]			= m_islandIds[ last ];
+
+		m_denseToSlot[ idx ] = m_denseToSlot[ last ];
+		m_slots[ m_denseToSlot[ idx ] ].index = idx;
+	}
+
+	m_positions.pop_back();
+	m_orientations.pop_back();
+	m_linearVelocities.pop_back();
+	m_angularVelocities.pop_back();
+	m_invMasses.pop_back();
+	m_elasticities.pop_back();
+	m_frictions.pop_back();
+	m_shapes.pop_back();
+	m_isSkinnedMesh.pop_back();
+	m_centersOfMass.pop_back();
+	m_inertiaGeometric.pop_back();
+	m_invInertiaGeometric.pop_back();
+	m_invInertiaWorld.pop_back();
+	m_isAwake.pop_back();
+	m_sleepTimers.pop_back();
+	m_islandIds.pop_back();
+	m_denseToSlot.pop_back();
+
+	// stale handles to this slot stop validating from here on
+	slot_t & slot = m_slots[ handle.slot ];
+	slot.generation++;
+	slot.index = m_freeSlot;
+	m_freeSlot = static_cast< int >( handle.slot );
+
+	m_version++;
+}
+
+/*
+====================================================
+BodyStore::Clear
+
+removes every body, but keeps bumping generations so handles from before
+the clear don't come back to life once the slots get reused
+====================================================
+*/
+void BodyStore::Clear() {
+	while ( Size() > 0 ) {
+		Remove( GetHandle( Size() - 1 ) );
+	}
+}
+
+/*
+====================================================
+BodyStore::Reserve
+====================================================
+*/
+void BodyStore::Reserve( const int num ) {
+	m_positions.reserve( num );
+	m_orientations.reserve( num );
+	m_linearVelocities.reserve( num );
+	m_angularVelocities.reserve( num );
+	m_invMasses.reserve( num );
+	m_elasticities.reserve( num );
+	m_frictions.reserve( num );
+	m_shapes.reserve( num );
+	m_isSkinnedMesh.reserve( num );
+	m_centersOfMass.reserve( num );
+	m_inertiaGeometric.reserve( num );
+	m_invInertiaGeometric.reserve( num );
+	m_invInertiaWorld.reserve( num );
+	m_isAwake.reserve( num );
+	m_sleepTimers.reserve( num );
+	m_islandIds.reserve( num );
+	m_denseToSlot.reserve( num );
+}
+
+/*
+====================================================
+BodyStore::SetShape
+
+the only place a shape's inertia tensor gets inverted
+====================================================
+*/
+void BodyStore::SetShape( const int idx, Shape * shape ) {
+	m_shapes[ idx ] = shape;
+
+	if ( shape == nullptr ) {
+		m_centersOfMass[ idx ].Zero();
+		m_inertiaGeometric[ idx ].Zero();
+		m_invInertiaGeometric[ idx ].Zero();
+	} else {
+		m_centersOfMass[ idx ] = shape->GetCenterOfMass();
+		m_inertiaGeometric[ idx ] = shape->InertiaTensorGeometric();
+		m_invInertiaGeometric[ idx ] = m_inertiaGeometric[ idx ].Inverse();
+	}
+	RefreshWorldInertia( idx );
+}
+
+/*
+====================================================
+BodyStore::RefreshWorldInertia
+
+the sandwich product is a change of basis to body space, the body space
+inverse inertia, and a change of basis back to world space. the mass is
+folded in here, so a new inverse mass shows up the next time the body is
+integrated
+====================================================
+*/
+void BodyStore::RefreshWorldInertia( const int idx ) {
+	const Mat3 orientation = m_orientations[ idx ].ToMat3();
+	m_invInertiaWorld[ idx ] = orientation * ( m_invInertiaGeometric[ idx ] * m_invMasses[ idx ] ) * orientation.Transpose();
+}
+
+/*
+====================================================
+BodyStore::GetBody
+====================================================
+*/
+Body BodyStore::GetBody( const bodyHandle_t handle ) {
+	assert( IsValid( handle ) );
+	return Body( this, handle );
+}
+
+/*
+====================================================
+BodyStore::GetBodyAt
+====================================================
+*/
+Body BodyStore::GetBodyAt( const int idx ) {
+	return Body( this, GetHandle( idx ) );
+}
\ No newline at end of file
@@ -0,0 +1,169 @@
+//
+//	BodyStore.h
+//
+#pragma once
+#include "../Math/Vector.h"
+#include "../Math/Quat.h"
+#include "../Math/Matrix.h"
+#include <vector>
+#include <assert.h>
+#include <stdint.h>
+
+class Shape;
+class Body;
+
+/*
+====================================================
+bodyHandle_t
+
+Names a body independent of where it currently sits in the store. The slot
+never moves, and its generation is bumped every time the body in it is
+removed, so a handle held across a Remove can never quietly resolve to
+whichever body gets the slot next.
+====================================================
+*/
+struct bodyHandle_t {
+	uint32_t slot;
+	uint32_t generation;
+
+	bool operator == ( const bodyHandle_t & rhs ) const { return slot == rhs.slot && generation == rhs.generation; }
+	bool operator != ( const bodyHandle_t & rhs ) const { return !( *this == rhs ); }
+};
+
+static const bodyHandle_t INVALID_BODY_HANDLE = { 0xFFFFFFFF, 0 };
+
+/*
+====================================================
+bodyDesc_t
+
+everything needed to add a body to a store
+====================================================
+*/
+struct bodyDesc_t {
+	bodyDesc_t() :
+		position( 0.0f ),
+		orientation( 0.0f, 0.0f, 0.0f, 1.0f ),
+		linearVelocity( 0.0f ),
+		angularVelocity( 0.0f ),
+		invMass( 0.0f ),
+		elasticity( 0.0f ),
+		friction( 0.0f ),
+		shape( nullptr ),
+		isSkinnedMesh( false ) {
+	}
+
+	Vec3  position;
+	Quat  orientation;
+	Vec3  linearVelocity;
+	Vec3  angularVelocity;
+
+	float invMass;
+	float elasticity;
+	float friction;
+	Shape * shape;
+
+	// @HACK for now
+	bool isSkinnedMesh;
+};
+
+/*
+====================================================
+BodyStore
+
+Owns every body of a scene as parallel arrays, so the loops that run every
+step ( integration, broadphase, sleeping ) stream through only the fields
+they touch. Bodies are kept densely packed; removing one swaps the last
+body into its place, which means dense indices are only stable between
+removals. Anything that needs to hold onto a body for longer should keep a
+handle ( or a Body view, which is just a handle plus the store ).
+
+Inverse inertia tensors are cached too, so nothing on the contact and
+impulse paths ever has to invert a matrix: the shape's inverse is taken
+once when the shape is set, and the world space one is rebuilt from it
+each time the body's orientation gets integrated.
+====================================================
+*/
+class BodyStore {
+public:
+	BodyStore() : m_freeSlot( -1 ), m_version( 0 ) {}
+
+	bodyHandle_t Add( const bodyDesc_t & desc );
+	void Remove( const bodyHandle_t handle );
+	void Clear();
+	void Reserve( const int num );
+
+	int Size() const { return static_cast< int >( m_positions.size() ); }
+
+	// bumped whenever bodies are added or removed, i.e. whenever a dense index may start naming a different body
+	uint32_t GetVersion() const { return m_version; }
+
+	bool IsValid( const bodyHandle_t handle ) const;
+	int GetIndex( const bodyHandle_t handle ) const;
+	bodyHandle_t GetHandle( const int idx ) const { return { m_denseToSlot[ idx ], m_slots[ m_denseToSlot[ idx ] ].generation }; }
+
+	Body GetBody( const bodyHandle_t handle );
+	Body GetBodyAt( const int idx );
+
+	// the shape's mass properties are cached when it's set, so swapping shapes has to go through here
+	void SetShape( const int idx, Shape * shape );
+	void RefreshWorldInertia( const int idx );
+
+	// only dynamic bodies that are awake get integrated and collided
+	bool IsActive( const int idx ) const { return m_isAwake[ idx ] != 0 && m_invMasses[ idx ] != 0.0f; }
+
+public:
+	// hot, read or written by every step
+	std::vector< Vec3 >		m_positions;
+	std::vector< Quat >		m_orientations;
+	std::vector< Vec3 >		m_linearVelocities;
+	std::vector< Vec3 >		m_angularVelocities;
+	std::vector< float >	m_invMasses;
+
+	// only looked at by collision response and rendering
+	std::vector< float >	m_elasticities;
+	std::vector< float >	m_frictions;
+	std::vector< Shape * >	m_shapes;
+	std::vector< uint8_t >	m_isSkinnedMesh;
+
+	// mass properties, the geometric ones come straight from the shape ( without the mass ) and
+	// only change with it, the world inverse inertia is refreshed whenever the body gets integrated
+	std::vector< Vec3 >		m_centersOfMass;			// model space
+	std::vector< Mat3 >		m_inertiaGeometric;
+	std::vector< Mat3 >		m_invInertiaGeometric;
+	std::vector< Mat3 >		m_invInertiaWorld;			// including the mass
+
+	// sleeping
+	std::vector< uint8_t >	m_isAwake;
+	std::vector< float >	m_sleepTimers;		// how long the body has been slow enough to fall asleep
+	std::vector< int >		m_islandIds;		// the scene's id for the island the body fell asleep with, -1 while awake
+
+private:
+	struct slot_t {
+		uint32_t generation;
+		int index;			// dense index of the body, or the next free slot while the slot is free
+	};
+
+	std::vector< slot_t > m_slots;
+	std::vector< uint32_t > m_denseToSlot;
+	int m_freeSlot;
+	uint32_t m_version;
+};
+
+/*
+====================================================
+BodyStore::IsValid
+====================================================
+*/
+inline bool BodyStore::IsValid( const bodyHandle_t handle ) const {
+	return handle.slot < m_slots.size() && m_slots[ handle.slot ].generation == handle.generation;
+}
+
+/*
+====================================================
+BodyStore::GetIndex
+====================================================
+*/
+inline int BodyStore::GetIndex( const bodyHandle_t handle ) const {
+	assert( IsValid( handle ) );
+	return m_slots[ handle.slot ].index;
+}
\ No newline at end of file
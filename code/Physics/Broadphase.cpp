@@ -2,65 +2,101 @@
 //  Broadphase.cpp
 //
 #include "Broadphase.h"
+#include "Shapes.h"
+#include "ThreadPool.h"
+#include "../Math/BoundsSoA.h"
+#include "../Config.h"
+#include <algorithm>
 
 /*
 ====================================================
 Sweep and Prune algorithm
 ====================================================
 */
-namespace {
-struct pseudoBody_t {
-	int id;
-	float value;
-	bool isMin;
-};
+Bounds GetSweptBounds( const BodyStore & bodies, const int idx, const float dt_sec ) {
+	Bounds bounds = bodies.m_shapes[ idx ]->GetBounds( bodies.m_positions[ idx ], bodies.m_orientations[ idx ] );
 
-int CompareSAP( const void * a, const void * b ) {
-	const pseudoBody_t * ea = reinterpret_cast< const pseudoBody_t * >( a );
-	const pseudoBody_t * eb = reinterpret_cast< const pseudoBody_t * >( b );
+	// expand each bounds by the distance it will travel in this time step
+	const Vec3 & linearVelocity = bodies.m_linearVelocities[ idx ];
+	bounds.Expand( bounds.mins + linearVelocity * dt_sec );
+	bounds.Expand( bounds.maxs + linearVelocity * dt_sec );
 
-	if ( ea->value < eb->value ) {
-		return -1;
-	}
-	return 1;
-}
+	// expand a little bit more along sweep axis
+	const float epsilon = 0.01f;
+	bounds.Expand( bounds.mins + Vec3( -1, -1, -1 ) * epsilon );
+	bounds.Expand( bounds.maxs + Vec3(  1,  1,  1 ) * epsilon );
+	return bounds;
 }
 
-void SortBodiesBounds( const Body * bodies, const int num, pseudoBody_t * outSortedArray, const float dt_sec ) {
+Vec3 GetSweepAxis() {
 	Vec3 axis = Vec3( 1, 1, 1 );
 	axis.Normalize();
+	return axis;
+}
 
-	for ( int i = 0; i < num; i++ ) {
-		const Body & body = bodies[ i ];
-		Bounds bounds = body.m_shape->GetBounds( body.m_position, body.m_orientation );
+namespace {
+// below this many work items it isn't worth waking up the thread pool
+static constexpr int MIN_PARALLEL_ITEMS = 512;
+// the work per item is uneven, so hand out more chunks than there are threads
+static constexpr int CHUNKS_PER_THREAD = 4;
+}
 
-		// expand each bounds by the distance it will travel in this time step
-		bounds.Expand( bounds.mins + body.m_linearVelocity * dt_sec );
-		bounds.Expand( bounds.maxs + body.m_linearVelocity * dt_sec );
+/*
+====================================================
+GatherPairsParallel
 
-		// expand a little bit more along sweep axis
-		const float epsilon = 0.01f;
-		bounds.Expand( bounds.mins + Vec3( -1, -1, -1 ) * epsilon );
-		bounds.Expand( bounds.maxs + Vec3(  1,  1,  1 ) * epsilon );
+splits [0, count) into chunks and runs gather( begin, end, outPairs ) for each
+one on the physics thread pool. Every chunk writes into its own buffer, and
+the buffers are appended in chunk order, so outPairs ends up exactly as if
+gather( 0, count, outPairs ) had run on this thread.
+====================================================
+*/
+template< typename gather_t >
+void GatherPairsParallel( const int count, std::vector< std::vector< collisionPair_t > > & chunkPairs, std::vector< collisionPair_t > & outPairs, gather_t && gather ) {
+	ThreadPool & pool = GetPhysicsThreadPool();
+	if ( count < MIN_PARALLEL_ITEMS || pool.GetNumThreads() == 1 ) {
+		gather( 0, count, outPairs );
+		return;
+	}
+
+	const int numChunks = std::min( count, pool.GetNumThreads() * CHUNKS_PER_THREAD );
+	if ( chunkPairs.size() < numChunks ) {
+		chunkPairs.resize( numChunks );
+	}
 
-		// separate each bounds into individual values, projected onto sweep axis so they can be sorted
-		// mins and maxes can later be tied together bc they share the same ids= 0; 
-		outSortedArray[ i * 2 + 0 ].id = i;
-		outSortedArray[ i * 2 + 0 ].value = axis.Dot( bounds.mins );
-		outSortedArray[ i * 2 + 0 ].isMin = true;
+	pool.ParallelFor( numChunks, [ & ]( const int chunk ) {
+		const int begin = static_cast< int >( int64_t( count ) * chunk / numChunks );
+		const int end = static_cast< int >( int64_t( count ) * ( chunk + 1 ) / numChunks );
+		chunkPairs[ chunk ].clear();
+		gather( begin, end, chunkPairs[ chunk ] );
+	} );
 
-		outSortedArray[ i * 2 + 1 ].id = i;
-		outSortedArray[ i * 2 + 1 ].value = axis.Dot( bounds.maxs );
-		outSortedArray[ i * 2 + 1 ].isMin = false;
+	// merge, in chunk order
+	int offsets[ 1024 ];
+	assert( numChunks < 1024 );
+	offsets[ 0 ] = static_cast< int >( outPairs.size() );
+	for ( int chunk = 0; chunk < numChunks; chunk++ ) {
+		offsets[ chunk + 1 ] = offsets[ chunk ] + static_cast< int >( chunkPairs[ chunk ].size() );
 	}
-	qsort( outSortedArray, num * 2, sizeof( pseudoBody_t ), CompareSAP );
+	outPairs.resize( offsets[ numChunks ] );
+
+	pool.ParallelFor( numChunks, [ & ]( const int chunk ) {
+		std::copy( chunkPairs[ chunk ].begin(), chunkPairs[ chunk ].end(), outPairs.begin() + offsets[ chunk ] );
+	} );
 }
 
-void BuildPairs( std::vector< collisionPair_t > & collisionPairs, const pseudoBody_t * sortedBodies, const int num ) {
-	collisionPairs.clear();
+/*
+====================================================
+BuildPairsRange
 
-	for ( int i = 0; i < num * 2; i++ ) {
-		const pseudoBody_t & a = sortedBodies[ i ];
+sweeps the min endpoints in [begin, end) of the sorted array, every body whose
+min lies between our min and max overlaps us on the sweep axis
+====================================================
+*/
+template< typename endPoint_t >
+void BuildPairsRange( const endPoint_t * sortedBodies, const int numEndPoints, const int begin, const int end, std::vector< collisionPair_t > & outPairs ) {
+	for ( int i = begin; i < end; i++ ) {
+		const endPoint_t & a = sortedBodies[ i ];
 		if ( !a.isMin ) {
 			continue;
 		}
@@ -68,8 +104,8 @@ void BuildPairs( std::vector< collisionPair_t > & collisionPairs, const pseudoBo
 		collisionPair_t pair;
 		pair.a = a.id;
 
-		for ( int j = i + 1; j < num * 2; j++ ) {
-			const pseudoBody_t & b = sortedBodies[ j ];
+		for ( int j = i + 1; j < numEndPoints; j++ ) {
+			const endPoint_t & b = sortedBodies[ j ];
 			if ( b.id == a.id ) {
 				break;
 			}
@@ -79,25 +115,687 @@ void BuildPairs( std::vector< collisionPair_t > & collisionPairs, const pseudoBo
 			}
 
 			pair.b = b.id;
-			collisionPairs.push_back( pair );
+			outPairs.push_back( pair );
+		}
+	}
+}
+
+/*
+====================================================
+BroadPhaseTypeToStr
+====================================================
+*/
+const char * BroadPhaseTypeToStr( const broadPhaseType_t type ) {
+	switch ( type ) {
+		case BROADPHASE_SWEEP_AND_PRUNE:	return "sweep and prune";
+		case BROADPHASE_AABB_TREE:			return "dynamic aabb tree";
+		case BROADPHASE_SPATIAL_HASH:		return "spatial hash grid";
+		default:							return "unknown";
+	}
+}
+
+/*
+====================================================
+CreateBroadPhase
+====================================================
+*/
+BroadPhaseBase * CreateBroadPhase( const broadPhaseType_t type ) {
+	switch ( type ) {
+		case BROADPHASE_SWEEP_AND_PRUNE:	return new BroadPhaseSAP();
+		case BROADPHASE_AABB_TREE:			return new BroadPhaseTree();
+		case BROADPHASE_SPATIAL_HASH:		return new BroadPhaseGrid( SPATIAL_HASH_CELL_SIZE );
+		default:							break;
+	}
+	assert( !"ERROR - unknown broadphase type!" );
+	return new BroadPhaseSAP();
+}
+
+/*
+========================================================================================================
+
+BroadPhaseSAP
+
+========================================================================================================
+*/
+
+/*
+====================================================
+BroadPhaseSAP::Clear
+====================================================
+*/
+void BroadPhaseSAP::Clear() {
+	m_numBodies = 0;
+	m_projectedMins.clear();
+	m_projectedMaxs.clear();
+	m_bounds.clear();
+	m_sortedIds.clear();
+	m_sortedMins.clear();
+	m_sortedMaxs.clear();
+	m_sortedBounds.Resize( 0 );
+	m_endPoints.clear();
+	m_axisPairs.clear();
+	m_pairLookup.Clear();
+	m_pairs.clear();
+	m_addedPairs.clear();
+	m_removedPairs.clear();
+	m_addedLookup.Clear();
+	m_removedLookup.Clear();
+}
+
+/*
+====================================================
+BroadPhaseSAP::Update
+====================================================
+*/
+void BroadPhaseSAP::Update( const BodyStore & bodies, const float dt_sec ) {
+	const int num = bodies.Size();
+	m_addedPairs.clear();
+	m_removedPairs.clear();
+	m_addedLookup.Clear();
+	m_removedLookup.Clear();
+
+	// the endpoint list is indexed by body id, so bodies coming or going means a different scene
+	if ( LayoutChanged( bodies, m_numBodies ) ) {
+		Rebuild( bodies, num, dt_sec );
+	} else {
+		ProjectBodies( bodies, num, dt_sec, false );
+
+		// refresh the endpoints in place, then let insertion sort fix up the ( mostly still valid ) order
+		for ( int i = 0; i < m_endPoints.size(); i++ ) {
+			endPoint_t & endPoint = m_endPoints[ i ];
+			endPoint.value = endPoint.isMin ? m_projectedMins[ endPoint.id ] : m_projectedMaxs[ endPoint.id ];
 		}
+		InsertionSort();
 	}
+
+	FilterPairs( bodies );
 }
 
-void SweepAndPrune1D( const Body * bodies, const int num, std::vector< collisionPair_t > & finalPairs, const float dt_sec ) {
-	pseudoBody_t * sortedBodies = reinterpret_cast< pseudoBody_t * >( alloca( sizeof( pseudoBody_t ) * num * 2 ) );
+/*
+====================================================
+BroadPhaseSAP::ProjectBodies
+====================================================
+*/
+void BroadPhaseSAP::ProjectBodies( const BodyStore & bodies, const int num, const float dt_sec, const bool allBodies ) {
+	const Vec3 axis = GetSweepAxis();
 
-	SortBodiesBounds( bodies, num, sortedBodies, dt_sec );
-	BuildPairs( finalPairs, sortedBodies, num );
+	m_projectedMins.resize( num );
+	m_projectedMaxs.resize( num );
+	m_bounds.resize( num );
+	for ( int i = 0; i < num; i++ ) {
+		// static and sleeping bodies stay where they were last time
+		if ( !allBodies && !bodies.IsActive( i ) ) {
+			continue;
+		}
+
+		const Bounds bounds = GetSweptBounds( bodies, i, dt_sec );
+		m_projectedMins[ i ] = axis.Dot( bounds.mins );
+		m_projectedMaxs[ i ] = axis.Dot( bounds.maxs );
+		m_bounds[ i ] = bounds;
+	}
 }
 
 /*
 ====================================================
-BroadPhase
+BroadPhaseSAP::FilterPairs
+
+the sweep axis alone lets plenty of pairs through that are nowhere near each
+other on the other axes, so everything gets the full bounds test too. the min
+endpoints, in order, are the bodies sorted by their min on the sweep axis, and
+the bodies overlapping one on that axis are the ones that start before its max.
+with the bounds copied into that order they're all in one run after it, which
+goes through the wide test a SIMD_WIDTH at a time. pairs where neither body is
+active can't do anything, so they're dropped too
 ====================================================
 */
-void BroadPhase( const Body * bodies, const int num, std::vector< collisionPair_t > & outFinalPairs, const float dt_sec ) {
-	outFinalPairs.clear();
+void BroadPhaseSAP::FilterPairs( const BodyStore & bodies ) {
+	m_pairs.clear();
+
+	const int num = m_numBodies;
+	m_sortedIds.clear();
+	for ( int i = 0; i < m_endPoints.size(); i++ ) {
+		if ( m_endPoints[ i ].isMin ) {
+			m_sortedIds.push_back( m_endPoints[ i ].id );
+		}
+	}
+
+	m_sortedMins.resize( num );
+	m_sortedMaxs.resize( num );
+	if ( m_sortedBounds.Size() != num ) {
+		m_sortedBounds.Resize( num );
+	}
+	for ( int i = 0; i < num; i++ ) {
+		const int id = m_sortedIds[ i ];
+		m_sortedMins[ i ] = m_projectedMins[ id ];
+		m_sortedMaxs[ i ] = m_projectedMaxs[ id ];
+		m_sortedBounds.Set( i, m_bounds[ id ] );
+	}
+
+	GatherPairsParallel( num, m_chunkPairs, m_pairs, [ & ]( const int begin, const int end, std::vector< collisionPair_t > & outPairs ) {
+		for ( int i = begin; i < end; i++ ) {
+			const int last = static_cast< int >( std::upper_bound( m_sortedMins.begin() + i + 1, m_sortedMins.begin() + num, m_sortedMaxs[ i ] ) - m_sortedMins.begin() );
+
+			collisionPair_t pair;
+			pair.a = m_sortedIds[ i ];
+			const bool isActiveA = bodies.IsActive( pair.a );
+
+			for ( int first = i + 1; first < last; first += SIMD_WIDTH ) {
+				int mask = m_sortedBounds.OverlapMask( i, first );
+				if ( last - first < SIMD_WIDTH ) {
+					mask &= ( 1 << ( last - first ) ) - 1;
+				}
+
+				for ( int k = 0; mask != 0; k++, mask >>= 1 ) {
+					if ( ( mask & 1 ) && ( isActiveA || bodies.IsActive( m_sortedIds[ first + k ] ) ) ) {
+						pair.b = m_sortedIds[ first + k ];
+						outPairs.push_back( pair );
+					}
+				}
+			}
+		}
+	} );
+}
+
+/*
+====================================================
+BroadPhaseSAP::Rebuild
+
+full sort + sweep, only needed when the set of bodies changes
+====================================================
+*/
+void BroadPhaseSAP::Rebuild( const BodyStore & bodies, const int num, const float dt_sec ) {
+	// everything we reported last time is gone
+	for ( int i = 0; i < m_axisPairs.size(); i++ ) {
+		const collisionPair_t & pair = m_axisPairs[ i ];
+		TrackDelta( m_removedPairs, m_removedLookup, PairKey( pair.a, pair.b ), pair );
+	}
+	m_axisPairs.clear();
+	m_pairLookup.Clear();
+
+	m_numBodies = num;
+	ProjectBodies( bodies, num, dt_sec, true );
+
+	m_endPoints.resize( num * 2 );
+	for ( int i = 0; i < num; i++ ) {
+		m_endPoints[ i * 2 + 0 ] = { i, m_projectedMins[ i ], true };
+		m_endPoints[ i * 2 + 1 ] = { i, m_projectedMaxs[ i ], false };
+	}
+	std::sort( m_endPoints.begin(), m_endPoints.end(), []( const endPoint_t & a, const endPoint_t & b ) {
+		return a.value < b.value;
+	} );
+
+	// the sweep runs in parallel, but the pairs are added in sweep order
+	const int numEndPoints = static_cast< int >( m_endPoints.size() );
+	m_sweptPairs.clear();
+	GatherPairsParallel( numEndPoints, m_chunkPairs, m_sweptPairs, [ & ]( const int begin, const int end, std::vector< collisionPair_t > & outPairs ) {
+		BuildPairsRange( m_endPoints.data(), numEndPoints, begin, end, outPairs );
+	} );
+
+	for ( int i = 0; i < m_sweptPairs.size(); i++ ) {
+		AddPair( m_sweptPairs[ i ].a, m_sweptPairs[ i ].b );
+	}
+}
+
+/*
+====================================================
+BroadPhaseSAP::InsertionSort
+
+endpoints only ever move past their neighbours, and each time a min passes
+a max ( or vice versa ) the overlap state of exactly that pair flips
+====================================================
+*/
+void BroadPhaseSAP::InsertionSort() {
+	for ( int i = 1; i < m_endPoints.size(); i++ ) {
+		const endPoint_t key = m_endPoints[ i ];
+
+		int j = i - 1;
+		while ( j >= 0 && m_endPoints[ j ].value > key.value ) {
+			const endPoint_t & other = m_endPoints[ j ];
+			if ( key.isMin && !other.isMin ) {
+				// our min moved below their max, the intervals now overlap
+				AddPair( key.id, other.id );
+			} else if ( !key.isMin && other.isMin ) {
+				// our max moved below their min, the intervals no longer overlap
+				RemovePair( key.id, other.id );
+			}
+
+			m_endPoints[ j + 1 ] = m_endPoints[ j ];
+			j--;
+		}
+		m_endPoints[ j + 1 ] = key;
+	}
+}
+
+/*
+====================================================
+BroadPhaseSAP::PairKey
+====================================================
+*/
+uint64_t BroadPhaseSAP::PairKey( const int a, const int b ) {
+	const uint32_t lo = static_cast< uint32_t >( std::min( a, b ) );
+	const uint32_t hi = static_cast< uint32_t >( std::max( a, b ) );
+	return ( static_cast< uint64_t >( lo ) << 32 ) | hi;
+}
+
+/*
+====================================================
+BroadPhaseSAP::TrackDelta
+====================================================
+*/
+void BroadPhaseSAP::TrackDelta( std::vector< collisionPair_t > & list, PairTable & lookup, const uint64_t key, const collisionPair_t & pair ) {
+	list.push_back( pair );
+	lookup.Add( key );
+}
+
+/*
+====================================================
+BroadPhaseSAP::UntrackDelta
+
+returns true if the key was in the list ( and removes it )
+====================================================
+*/
+bool BroadPhaseSAP::UntrackDelta( std::vector< collisionPair_t > & list, PairTable & lookup, const uint64_t key ) {
+	const int idx = lookup.Find( key );
+	if ( idx < 0 ) {
+		return false;
+	}
+
+	// the table swap-removes the same way, so the list and its indices stay in step
+	lookup.Remove( idx );
+	if ( idx != list.size() - 1 ) {
+		list[ idx ] = list.back();
+	}
+	list.pop_back();
+	return true;
+}
+
+/*
+====================================================
+BroadPhaseSAP::AddPair
+====================================================
+*/
+void BroadPhaseSAP::AddPair( const int a, const int b ) {
+	const uint64_t key = PairKey( a, b );
+	if ( m_pairLookup.Find( key ) >= 0 ) {
+		return;
+	}
+
+	collisionPair_t pair;
+	pair.a = std::min( a, b );
+	pair.b = std::max( a, b );
+	TrackDelta( m_axisPairs, m_pairLookup, key, pair );
 
-	SweepAndPrune1D( bodies, num, outFinalPairs, dt_sec );
+	// removed and re-added within the same update is not a change
+	if ( !UntrackDelta( m_removedPairs, m_removedLookup, key ) ) {
+		TrackDelta( m_addedPairs, m_addedLookup, key, pair );
+	}
+}
+
+/*
+====================================================
+BroadPhaseSAP::RemovePair
+====================================================
+*/
+void BroadPhaseSAP::RemovePair( const int a, const int b ) {
+	const uint64_t key = PairKey( a, b );
+	if ( !UntrackDelta( m_axisPairs, m_pairLookup, key ) ) {
+		return;
+	}
+
+	// added and removed within the same update is not a change
+	if ( !UntrackDelta( m_addedPairs, m_addedLookup, key ) ) {
+		collisionPair_t pair;
+		pair.a = std::min( a, b );
+		pair.b = std::max( a, b );
+		TrackDelta( m_removedPairs, m_removedLookup, key, pair );
+	}
+}
+
+/*
+========================================================================================================
+
+BroadPhaseTree
+
+========================================================================================================
+*/
+
+/*
+====================================================
+BroadPhaseTree::Clear
+====================================================
+*/
+void BroadPhaseTree::Clear() {
+	m_tree.Clear();
+	m_proxies.clear();
+	m_bounds.clear();
+	m_pairs.clear();
+}
+
+/*
+====================================================
+BroadPhaseTree::Update
+====================================================
+*/
+void BroadPhaseTree::Update( const BodyStore & bodies, const float dt_sec ) {
+	const int num = bodies.Size();
+	m_pairs.clear();
+
+	// static and sleeping bodies stay where they were last time
+	const bool allBodies = LayoutChanged( bodies, static_cast< int >( m_proxies.size() ) );
+	m_bounds.resize( num );
+	for ( int i = 0; i < num; i++ ) {
+		if ( allBodies || bodies.IsActive( i ) ) {
+			m_bounds[ i ] = GetSweptBounds( bodies, i, dt_sec );
+		}
+	}
+
+	// proxies are indexed by body id, so bodies coming or going means a different scene
+	if ( allBodies ) {
+		m_tree.Clear();
+		m_proxies.resize( num );
+		for ( int i = 0; i < num; i++ ) {
+			m_proxies[ i ] = m_tree.CreateProxy( m_bounds[ i ], i );
+		}
+	} else {
+		// only bodies that left their fat bounds actually touch the tree
+		for ( int i = 0; i < num; i++ ) {
+			if ( !bodies.IsActive( i ) ) {
+				continue;
+			}
+			m_tree.MoveProxy( m_proxies[ i ], m_bounds[ i ], bodies.m_linearVelocities[ i ] * dt_sec );
+		}
+	}
+
+	// static and sleeping bodies never query, they only get found. pairs of active bodies are reported by the lower id
+	GatherPairsParallel( num, m_chunkPairs, m_pairs, [ & ]( const int begin, const int end, std::vector< collisionPair_t > & outPairs ) {
+		for ( int i = begin; i < end; i++ ) {
+			if ( !bodies.IsActive( i ) ) {
+				continue;
+			}
+
+			const Bounds & bounds = m_bounds[ i ];
+			m_tree.QueryBounds( bounds, [ & ]( const int j ) {
+				if ( j == i ) {
+					return true;
+				}
+				if ( bodies.IsActive( j ) && j < i ) {
+					return true;
+				}
+
+				// the tree only knows the fat bounds
+				if ( bounds.DoesIntersect( m_bounds[ j ] ) ) {
+					collisionPair_t pair;
+					pair.a = i;
+					pair.b = j;
+					outPairs.push_back( pair );
+				}
+				return true;
+			} );
+		}
+	} );
+}
+
+/*
+========================================================================================================
+
+BroadPhaseGrid
+
+========================================================================================================
+*/
+
+namespace {
+// bodies spanning more cells than this along any axis don't go in the grid
+static constexpr int MAX_CELLS_PER_AXIS = 4;
+}
+
+/*
+====================================================
+BroadPhaseGrid::Clear
+====================================================
+*/
+void BroadPhaseGrid::Clear() {
+	m_numBodies = 0;
+	m_bounds.clear();
+	m_bodyBounds.Resize( 0 );
+	m_oversized.clear();
+	m_bucketStarts.clear();
+	m_bucketFill.clear();
+	m_entries.clear();
+	m_entryBounds.Resize( 0 );
+	m_pairs.clear();
+}
+
+/*
+====================================================
+BroadPhaseGrid::PickCellSize
+
+A cell should be about as big as a typical body, so each body lands in a
+handful of cells. Use the median of the largest extents, which ignores the
+few giant bodies that would otherwise blow the cells up.
+====================================================
+*/
+float BroadPhaseGrid::PickCellSize( const Bounds * bounds, const int num ) {
+	if ( num <= 0 ) {
+		return 1.f;
+	}
+
+	std::vector< float > extents( num );
+	for ( int i = 0; i < num; i++ ) {
+		extents[ i ] = std::max( bounds[ i ].WidthX(), std::max( bounds[ i ].WidthY(), bounds[ i ].WidthZ() ) );
+	}
+
+	std::nth_element( extents.begin(), extents.begin() + num / 2, extents.end() );
+	const float median = extents[ num / 2 ];
+	return ( median > 0.f ) ? median : 1.f;
+}
+
+/*
+====================================================
+BroadPhaseGrid::GetCellRange
+====================================================
+*/
+void BroadPhaseGrid::GetCellRange( const Bounds & bounds, int * outMins, int * outMaxs ) const {
+	const float invCellSize = 1.f / m_cellSize;
+	for ( int i = 0; i < 3; i++ ) {
+		outMins[ i ] = static_cast< int >( floorf( bounds.mins[ i ] * invCellSize ) );
+		outMaxs[ i ] = static_cast< int >( floorf( bounds.maxs[ i ] * invCellSize ) );
+	}
+}
+
+/*
+====================================================
+BroadPhaseGrid::HashCell
+====================================================
+*/
+int BroadPhaseGrid::HashCell( const int x, const int y, const int z ) const {
+	// large primes, so neighbouring cells scatter across the table
+	const uint32_t h = ( uint32_t( x ) * 73856093u ) ^ ( uint32_t( y ) * 19349663u ) ^ ( uint32_t( z ) * 83492791u );
+	return static_cast< int >( h & uint32_t( m_bucketStarts.size() - 2 ) );
+}
+
+/*
+====================================================
+BroadPhaseGrid::Update
+====================================================
+*/
+void BroadPhaseGrid::Update( const BodyStore & bodies, const float dt_sec ) {
+	const int num = bodies.Size();
+	m_pairs.clear();
+
+	// nothing to put in cells, and the buckets are only sized once there are bodies
+	if ( 0 == num ) {
+		m_numBodies = 0;
+		return;
+	}
+
+	// static and sleeping bodies stay where they were last time
+	const bool allBodies = LayoutChanged( bodies, m_numBodies );
+	m_bounds.resize( num );
+	if ( m_bodyBounds.Size() != num ) {
+		m_bodyBounds.Resize( num );
+	}
+	for ( int i = 0; i < num; i++ ) {
+		if ( allBodies || bodies.IsActive( i ) ) {
+			m_bounds[ i ] = GetSweptBounds( bodies, i, dt_sec );
+			m_bodyBounds.Set( i, m_bounds[ i ] );
+		}
+	}
+
+	// the body sizes only really change with the scene
+	if ( num != m_numBodies ) {
+		m_numBodies = num;
+		m_cellSize = ( m_fixedCellSize > 0.f ) ? m_fixedCellSize : PickCellSize( m_bounds.data(), num );
+
+		// power of two buckets, at least twice the body count to keep collisions rare
+		int numBuckets = 1;
+		while ( numBuckets < num * 2 ) {
+			numBuckets <<= 1;
+		}
+		m_bucketStarts.resize( numBuckets + 1 );
+		m_bucketFill.resize( numBuckets );
+	}
+	const int numBuckets = static_cast< int >( m_bucketFill.size() );
+
+	//
+	// counting sort, pass 1: how many entries land in each bucket
+	//
+	m_oversized.clear();
+	std::fill( m_bucketStarts.begin(), m_bucketStarts.end(), 0 );
+	for ( int i = 0; i < num; i++ ) {
+		int mins[ 3 ];
+		int maxs[ 3 ];
+		GetCellRange( m_bounds[ i ], mins, maxs );
+		if ( maxs[ 0 ] - mins[ 0 ] >= MAX_CELLS_PER_AXIS || maxs[ 1 ] - mins[ 1 ] >= MAX_CELLS_PER_AXIS || maxs[ 2 ] - mins[ 2 ] >= MAX_CELLS_PER_AXIS ) {
+			m_oversized.push_back( i );
+			continue;
+		}
+
+		for ( int x = mins[ 0 ]; x <= maxs[ 0 ]; x++ ) {
+			for ( int y = mins[ 1 ]; y <= maxs[ 1 ]; y++ ) {
+				for ( int z = mins[ 2 ]; z <= maxs[ 2 ]; z++ ) {
+					m_bucketStarts[ HashCell( x, y, z ) + 1 ]++;
+				}
+			}
+		}
+	}
+
+	// prefix sum turns the counts into offsets
+	for ( int b = 0; b < numBuckets; b++ ) {
+		m_bucketStarts[ b + 1 ] += m_bucketStarts[ b ];
+	}
+	m_entries.resize( m_bucketStarts[ numBuckets ] );
+	if ( m_entryBounds.Size() != m_entries.size() ) {
+		m_entryBounds.Resize( static_cast< int >( m_entries.size() ) );
+	}
+
+	//
+	// pass 2: scatter the entries into their buckets
+	//
+	std::fill( m_bucketFill.begin(), m_bucketFill.end(), 0 );
+	int nextOversized = 0;
+	for ( int i = 0; i < num; i++ ) {
+		if ( nextOversized < m_oversized.size() && m_oversized[ nextOversized ] == i ) {
+			nextOversized++;
+			continue;
+		}
+
+		int mins[ 3 ];
+		int maxs[ 3 ];
+		GetCellRange( m_bounds[ i ], mins, maxs );
+		for ( int x = mins[ 0 ]; x <= maxs[ 0 ]; x++ ) {
+			for ( int y = mins[ 1 ]; y <= maxs[ 1 ]; y++ ) {
+				for ( int z = mins[ 2 ]; z <= maxs[ 2 ]; z++ ) {
+					const int bucket = HashCell( x, y, z );
+					const int entry = m_bucketStarts[ bucket ] + m_bucketFill[ bucket ]++;
+					m_entries[ entry ] = { i, x, y, z };
+					m_entryBounds.Set( entry, m_bounds[ i ] );
+				}
+			}
+		}
+	}
+
+	//
+	// pairs within each bucket
+	//
+	const float invCellSize = 1.f / m_cellSize;
+	GatherPairsParallel( numBuckets, m_chunkPairs, m_pairs, [ & ]( const int begin, const int end, std::vector< collisionPair_t > & outPairs ) {
+		for ( int b = begin; b < end; b++ ) {
+			const int bucketStart = m_bucketStarts[ b ];
+			const int bucketEnd = m_bucketStarts[ b + 1 ];
+			for ( int e1 = bucketStart; e1 < bucketEnd; e1++ ) {
+				const cellEntry_t & entryA = m_entries[ e1 ];
+				const Bounds & boundsA = m_bounds[ entryA.id ];
+
+				// the rest of the bucket through the wide bounds test, a SIMD_WIDTH at a time
+				for ( int first = e1 + 1; first < bucketEnd; first += SIMD_WIDTH ) {
+					int mask = m_entryBounds.OverlapMask( e1, first );
+					if ( bucketEnd - first < SIMD_WIDTH ) {
+						mask &= ( 1 << ( bucketEnd - first ) ) - 1;
+					}
+
+					for ( int k = 0; mask != 0; k++, mask >>= 1 ) {
+						if ( !( mask & 1 ) ) {
+							continue;
+						}
+						const cellEntry_t & entryB = m_entries[ first + k ];
+
+						// different cells can hash to the same bucket
+						if ( entryA.x != entryB.x || entryA.y != entryB.y || entryA.z != entryB.z ) {
+							continue;
+						}
+						if ( !bodies.IsActive( entryA.id ) && !bodies.IsActive( entryB.id ) ) {
+							continue;
+						}
+
+						// a pair sharing several cells is only reported by the cell
+						// holding the min corner of their overlap
+						const Bounds & boundsB = m_bounds[ entryB.id ];
+						const int ownerX = static_cast< int >( floorf( std::max( boundsA.mins.x, boundsB.mins.x ) * invCellSize ) );
+						const int ownerY = static_cast< int >( floorf( std::max( boundsA.mins.y, boundsB.mins.y ) * invCellSize ) );
+						const int ownerZ = static_cast< int >( floorf( std::max( boundsA.mins.z, boundsB.mins.z ) * invCellSize ) );
+						if ( ownerX != entryA.x || ownerY != entryA.y || ownerZ != entryA.z ) {
+							continue;
+						}
+
+						collisionPair_t pair;
+						pair.a = entryA.id;
+						pair.b = entryB.id;
+						outPairs.push_back( pair );
+					}
+				}
+			}
+		}
+	} );
+
+	//
+	// the oversized bodies test everything
+	//
+	for ( int o = 0; o < m_oversized.size(); o++ ) {
+		const int a = m_oversized[ o ];
+		for ( int first = 0; first < num; first += SIMD_WIDTH ) {
+			int mask = m_bodyBounds.OverlapMask( a, first );
+			if ( num - first < SIMD_WIDTH ) {
+				mask &= ( 1 << ( num - first ) ) - 1;
+			}
+
+			for ( int k = 0; mask != 0; k++, mask >>= 1 ) {
+				const int b = first + k;
+				if ( !( mask & 1 ) || b == a ) {
+					continue;
+				}
+				// pairs of oversized bodies are reported by the lower id
+				if ( b < a && std::binary_search( m_oversized.begin(), m_oversized.end(), b ) ) {
+					continue;
+				}
+				if ( !bodies.IsActive( a ) && !bodies.IsActive( b ) ) {
+					continue;
+				}
+
+				collisionPair_t pair;
+				pair.a = a;
+				pair.b = b;
+				m_pairs.push_back( pair );
+			}
+		}
+	}
 }
\ No newline at end of file
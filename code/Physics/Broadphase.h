@@ -2,8 +2,12 @@
 //	Broadphase.h
 //
 #pragma once
-#include "Body.h"
+#include "BodyStore.h"
+#include "DynamicAABBTree.h"
+#include "PairTable.h"
+#include "../Math/BoundsSoA.h"
 #include <vector>
+#include <stdint.h>
 
 
 struct collisionPair_t {
@@ -18,4 +22,192 @@ struct collisionPair_t {
 	}
 };
 
-void BroadPhase( const Body * bodies, const int num, std::vector< collisionPair_t > & finalPairs, const float dt_sec );
\ No newline at end of file
+enum broadPhaseType_t {
+	BROADPHASE_SWEEP_AND_PRUNE = 0,
+	BROADPHASE_AABB_TREE,
+	BROADPHASE_SPATIAL_HASH,
+	BROADPHASE_COUNT,
+};
+
+const char * BroadPhaseTypeToStr( const broadPhaseType_t type );
+
+/*
+====================================================
+BroadPhase Interface
+
+Persistent broadphase owned by the scene. Update is handed the full body
+store every step, and GetPairs returns every potentially colliding pair
+( as dense body indices ) with at least one active ( dynamic and awake )
+body in it. Static and sleeping bodies are assumed not to move, so their
+bounds are only looked at again when bodies get added or removed.
+====================================================
+*/
+class BroadPhaseBase {
+public:
+	BroadPhaseBase() : m_storeVersion( 0 ) {}
+	virtual ~BroadPhaseBase() {}
+
+	virtual void Update( const BodyStore & bodies, const float dt_sec ) = 0;
+	virtual void Clear() = 0;
+	virtual broadPhaseType_t GetType() const = 0;
+
+	const std::vector< collisionPair_t > & GetPairs() const { return m_pairs; }
+
+protected:
+	// true when a dense index may now name a different body than it did last Update
+	bool LayoutChanged( const BodyStore & bodies, const int numTracked ) {
+		const bool changed = ( bodies.Size() != numTracked || bodies.GetVersion() != m_storeVersion );
+		m_storeVersion = bodies.GetVersion();
+		return changed;
+	}
+
+	std::vector< collisionPair_t > m_pairs;
+	std::vector< std::vector< collisionPair_t > > m_chunkPairs;	// scratch for the threads gathering pairs
+	uint32_t m_storeVersion;
+};
+
+BroadPhaseBase * CreateBroadPhase( const broadPhaseType_t type );
+
+/*
+====================================================
+BroadPhaseSAP
+
+Persistent sweep and prune. The sorted endpoint list survives from one
+step to the next, so re-sorting it is an insertion sort over an almost
+sorted array ( ~O(n) when bodies move coherently ). Every swap of a min
+past a max endpoint starts or ends an overlap, which lets us keep the
+list of pairs overlapping on the sweep axis alive too, instead of
+rebuilding it from scratch each step. GetPairs() sweeps the same sorted
+order, testing the bounds on all three axes a SIMD_WIDTH at a time.
+====================================================
+*/
+class BroadPhaseSAP : public BroadPhaseBase {
+public:
+	BroadPhaseSAP() : m_numBodies( 0 ) {}
+
+	void Update( const BodyStore & bodies, const float dt_sec ) override;
+	void Clear() override;
+	broadPhaseType_t GetType() const override { return BROADPHASE_SWEEP_AND_PRUNE; }
+
+	// net changes made to the sweep axis overlaps by the last Update
+	const std::vector< collisionPair_t > & GetAddedPairs() const { return m_addedPairs; }
+	const std::vector< collisionPair_t > & GetRemovedPairs() const { return m_removedPairs; }
+
+private:
+	struct endPoint_t {
+		int id;
+		float value;
+		bool isMin;
+	};
+
+	void Rebuild( const BodyStore & bodies, const int num, const float dt_sec );
+	void ProjectBodies( const BodyStore & bodies, const int num, const float dt_sec, const bool allBodies );
+	void InsertionSort();
+	void FilterPairs( const BodyStore & bodies );
+
+	void AddPair( const int a, const int b );
+	void RemovePair( const int a, const int b );
+
+	static uint64_t PairKey( const int a, const int b );
+	static void TrackDelta( std::vector< collisionPair_t > & list, PairTable & lookup, const uint64_t key, const collisionPair_t & pair );
+	static bool UntrackDelta( std::vector< collisionPair_t > & list, PairTable & lookup, const uint64_t key );
+
+	int m_numBodies;
+
+	std::vector< float > m_projectedMins;
+	std::vector< float > m_projectedMaxs;
+	std::vector< Bounds > m_bounds;			// swept bounds of each body, for this step
+	std::vector< endPoint_t > m_endPoints;
+
+	// the bodies in the order of their min endpoints, with their projections and bounds in the same order
+	std::vector< int > m_sortedIds;
+	std::vector< float > m_sortedMins;
+	std::vector< float > m_sortedMaxs;
+	BoundsSoA m_sortedBounds;
+
+	std::vector< collisionPair_t > m_sweptPairs;			// scratch for Rebuild
+
+	std::vector< collisionPair_t > m_axisPairs;				// bodies overlapping on the sweep axis
+	PairTable m_pairLookup;									// pair key -> index into m_axisPairs
+
+	std::vector< collisionPair_t > m_addedPairs;
+	std::vector< collisionPair_t > m_removedPairs;
+	PairTable m_addedLookup;								// pair key -> index into m_addedPairs
+	PairTable m_removedLookup;								// pair key -> index into m_removedPairs
+};
+
+/*
+====================================================
+BroadPhaseTree
+
+Every body gets a proxy in a dynamic AABB tree, and each dynamic body
+queries the tree for its neighbours. Doesn't care how bodies are spread
+out, and the tree doubles as the acceleration structure for ray and
+bounds queries against the scene.
+====================================================
+*/
+class BroadPhaseTree : public BroadPhaseBase {
+public:
+	void Update( const BodyStore & bodies, const float dt_sec ) override;
+	void Clear() override;
+	broadPhaseType_t GetType() const override { return BROADPHASE_AABB_TREE; }
+
+	const DynamicAABBTree & GetTree() const { return m_tree; }
+
+	// false until the first Update after the bodies changed, e.g. right after a reset or switching broadphase
+	bool IsCurrent( const BodyStore & bodies ) const { return bodies.Size() == static_cast< int >( m_proxies.size() ) && bodies.GetVersion() == m_storeVersion; }
+
+private:
+	DynamicAABBTree m_tree;
+	std::vector< int > m_proxies;		// body id -> proxy id
+	std::vector< Bounds > m_bounds;		// tight swept bounds of each body, for this step
+};
+
+/*
+====================================================
+BroadPhaseGrid
+
+Spatial hash over a uniform grid, for swarms of similarly sized bodies.
+Each body is binned into every cell its bounds touch, and the cell entries
+are rebuilt every step with a counting sort into one flat array, so a
+bucket's bodies are contiguous in memory. Bodies that would span too many
+cells ( e.g. a huge static floor ) are kept out of the grid and tested
+against everything directly instead.
+====================================================
+*/
+class BroadPhaseGrid : public BroadPhaseBase {
+public:
+	// cellSize <= 0 picks one from the bounds of the bodies
+	explicit BroadPhaseGrid( const float cellSize = 0.f ) : m_fixedCellSize( cellSize ), m_cellSize( 1.f ), m_numBodies( 0 ) {}
+
+	void Update( const BodyStore & bodies, const float dt_sec ) override;
+	void Clear() override;
+	broadPhaseType_t GetType() const override { return BROADPHASE_SPATIAL_HASH; }
+
+	float GetCellSize() const { return m_cellSize; }
+	static float PickCellSize( const Bounds * bounds, const int num );
+
+private:
+	struct cellEntry_t {
+		int id;
+		int x;
+		int y;
+		int z;
+	};
+
+	void GetCellRange( const Bounds & bounds, int * outMins, int * outMaxs ) const;
+	int HashCell( const int x, const int y, const int z ) const;
+
+	float m_fixedCellSize;
+	float m_cellSize;
+	int m_numBodies;
+
+	std::vector< Bounds > m_bounds;			// swept bounds of each body, for this step
+	BoundsSoA m_bodyBounds;					// the same again, for testing the oversized bodies against everything
+	std::vector< int > m_oversized;			// bodies kept out of the grid
+
+	std::vector< int > m_bucketStarts;		// offset of each hash bucket into m_entries ( one extra at the end )
+	std::vector< int > m_bucketFill;
+	std::vector< cellEntry_t > m_entries;
+	BoundsSoA m_entryBounds;				// the bounds of each entry's body, so a bucket's are contiguous too
+};
\ No newline at end of file
@@ -0,0 +1,95 @@
+//
+//	ConstraintColoring.cpp
+//
+#include "ConstraintColoring.h"
+#include <algorithm>
+
+/*
+====================================================
+ConstraintColoring::Build
+
+every body keeps a mask of the colors it's already in, so finding a
+constraint's color is one bit scan over the two masks. then a counting sort
+by color, which keeps the constraints of each color in their original order
+====================================================
+*/
+void ConstraintColoring::Build( const span_t< constraintBodies_t > & constraints, const int numBodies, FrameArena & arena ) {
+	const int numConstraints = constraints.Size();
+	span_t< uint64_t > bodyColors = arena.Alloc< uint64_t >( numBodies );
+	span_t< int > colors = arena.Alloc< int >( numConstraints );
+	std::fill( bodyColors.begin(), bodyColors.end(), uint64_t( 0 ) );
+
+	int counts[ MAX_COLORS ] = {};
+	m_numColors = 0;
+	for ( int i = 0; i < numConstraints; i++ ) {
+		const int a = constraints[ i ].bodyA;
+		const int b = constraints[ i ].bodyB;
+		uint64_t used = 0;
+		if ( a >= 0 ) {
+			used |= bodyColors[ a ];
+		}
+		if ( b >= 0 ) {
+			used |= bodyColors[ b ];
+		}
+
+		// first free color, the overflow color is never marked as used so it's always free
+		int color = 0;
+		while ( color < MAX_COLORS - 1 && ( used & ( uint64_t( 1 ) << color ) ) ) {
+			color++;
+		}
+
+		if ( color < MAX_COLORS - 1 ) {
+			const uint64_t bit = uint64_t( 1 ) << color;
+			if ( a >= 0 ) {
+				bodyColors[ a ] |= bit;
+			}
+			if ( b >= 0 ) {
+				bodyColors[ b ] |= bit;
+			}
+		}
+
+		colors[ i ] = color;
+		counts[ color ]++;
+		m_numColors = std::max( m_numColors, color + 1 );
+	}
+
+	m_colorStarts[ 0 ] = 0;
+	for ( int color = 0; color < MAX_COLORS; color++ ) {
+		m_colorStarts[ color + 1 ] = m_colorStarts[ color ] + counts[ color ];
+	}
+
+	int next[ MAX_COLORS ];
+	std::copy( m_colorStarts, m_colorStarts + MAX_COLORS, next );
+	m_order = arena.Alloc< int >( numConstraints );
+	for ( int i = 0; i < numConstraints; i++ ) {
+		m_order[ next[ colors[ i ] ]++ ] = i;
+	}
+	m_isParallel = true;
+}
+
+/*
+====================================================
+ConstraintColoring::BuildSerial
+====================================================
+*/
+void ConstraintColoring::BuildSerial( const int numConstraints, FrameArena & arena ) {
+	m_order = arena.Alloc< int >( numConstraints );
+	for ( int i = 0; i < numConstraints; i++ ) {
+		m_order[ i ] = i;
+	}
+
+	m_numColors = ( numConstraints > 0 ) ? 1 : 0;
+	m_colorStarts[ 0 ] = 0;
+	m_colorStarts[ 1 ] = numConstraints;
+	m_isParallel = false;
+}
+
+/*
+====================================================
+ConstraintColoring::GetColor
+====================================================
+*/
+span_t< int > ConstraintColoring::GetColor( const int color ) const {
+	const int begin = m_colorStarts[ color ];
+	return span_t< int >( m_order.data + begin, m_colorStarts[ color + 1 ] - begin );
+}
\ No newline at end of file
@@ -0,0 +1,57 @@
+//
+//	ConstraintColoring.h
+//
+#pragma once
+#include "FrameArena.h"
+
+/*
+====================================================
+constraintBodies_t
+
+the two bodies a constraint writes to, as store indices. -1 for a body that
+can't move, those never conflict with anything
+====================================================
+*/
+struct constraintBodies_t {
+	int bodyA;
+	int bodyB;
+};
+
+/*
+====================================================
+ConstraintColoring
+
+Splits the constraints into colors, batches where no two constraints share a
+dynamic body, so everything within one color can be solved at the same time.
+The coloring is greedy, each constraint takes the first color neither of its
+bodies is in yet, so it only depends on the order the constraints come in and
+never on the number of threads. A body can be in at most MAX_COLORS - 1
+colors, whatever doesn't fit goes in the last color, which has to be solved
+on one thread.
+====================================================
+*/
+class ConstraintColoring {
+public:
+	static const int MAX_COLORS = 64;
+
+	ConstraintColoring() : m_numColors( 0 ), m_isParallel( false ) {}
+
+	// the spans are all carved from arena, so they're only good until its next Reset
+	void Build( const span_t< constraintBodies_t > & constraints, const int numBodies, FrameArena & arena );
+
+	// one color with everything in its original order, for when nothing would run in parallel anyway.
+	// gauss seidel converges faster along the order the constraints came in ( e.g. up a stack ) than color by color
+	void BuildSerial( const int numConstraints, FrameArena & arena );
+
+	int GetNumColors() const { return m_numColors; }
+	bool IsParallel( const int color ) const { return m_isParallel && color != MAX_COLORS - 1; }
+
+	// indices into the constraints Build was given, in the order they came in
+	span_t< int > GetColor( const int color ) const;
+
+private:
+	span_t< int > m_order;			// the constraints sorted by color
+	int m_colorStarts[ MAX_COLORS + 1 ];
+	int m_numColors;
+	bool m_isParallel;
+};
\ No newline at end of file
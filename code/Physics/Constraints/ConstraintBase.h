@@ -10,6 +10,29 @@
 #include "../Body.h"
 #include <vector>
 
+// one row of a constraint's Jacobian: body A's linear and angular terms, then body B's
+typedef VecFixed< 12 > jacobianRow_t;
+
+/*
+====================================================
+constraintInvMass_t
+
+the 12x12 inverse mass matrix is block diagonal, each body's inverse mass
+down the diagonal of its linear block and its world space inverse inertia
+in its angular block, everything else is zero. so only the blocks are kept,
+and the kernels below skip the zeros
+====================================================
+*/
+struct bodyInvMass_t {
+	float	invMass;
+	Mat3	invInertia;
+};
+
+struct constraintInvMass_t {
+	bodyInvMass_t	A;
+	bodyInvMass_t	B;
+};
+
 /*
 ====================================================
 Constraint
@@ -25,13 +48,18 @@ public:
 	static Mat4 Right( const Quat & q );
 
 protected:
-	MatMN GetInverseMassMatrix() const;
-	VecN GetVelocities() const;
-	void ApplyImpulses( const VecN & impulses );
+	// fixed size, so none of these ever allocate
+	constraintInvMass_t GetInverseMass() const;
+	VecFixed< 12 > GetVelocities() const;
+	void ApplyImpulses( const constraintInvMass_t & invMass, const VecFixed< 12 > & impulses );
+
+	// J * M^-1 * Jt for one row, and M^-1 * v for a 12 vector ( like Jt * lambda )
+	static float GetJWJt( const jacobianRow_t & J, const constraintInvMass_t & invMass );
+	static VecFixed< 12 > MulInverseMass( const constraintInvMass_t & invMass, const VecFixed< 12 > & v );
 
 public:
-	Body * m_bodyA;
-	Body * m_bodyB;
+	Body m_bodyA;
+	Body m_bodyB;
 
 	Vec3 m_anchorA;		// The anchor location in bodyA's space
 	Vec3 m_axisA;		// The axis direction in bodyA's space
@@ -42,26 +70,77 @@ public:
 
 /*
 ====================================================
-Constraint::GetInverseMassMatrix
+Constraint::GetInverseMass
 ====================================================
 */
-inline MatMN Constraint::GetInverseMassMatrix() const {
-	MatMN invMassMatrix( 12, 12 );
-	
-	// TODO: Add code
+inline constraintInvMass_t Constraint::GetInverseMass() const {
+	constraintInvMass_t invMass;
+	invMass.A.invMass = m_bodyA.GetInvMass();
+	invMass.A.invInertia = m_bodyA.GetInverseInertiaTensorWorldSpace();
+	invMass.B.invMass = m_bodyB.GetInvMass();
+	invMass.B.invInertia = m_bodyB.GetInverseInertiaTensorWorldSpace();
+	return invMass;
+}
 
-	return invMassMatrix;
+/*
+====================================================
+Constraint::GetJWJt
+
+each body's block contributes invMass * |linear|^2 + angular . ( invInertia * angular ).
+under 40 multiplies, where the dense 12x12 version took 156
+====================================================
+*/
+inline float Constraint::GetJWJt( const jacobianRow_t & J, const constraintInvMass_t & invMass ) {
+	const Vec3 linearA( J[ 0 ], J[ 1 ], J[ 2 ] );
+	const Vec3 angularA( J[ 3 ], J[ 4 ], J[ 5 ] );
+	const Vec3 linearB( J[ 6 ], J[ 7 ], J[ 8 ] );
+	const Vec3 angularB( J[ 9 ], J[ 10 ], J[ 11 ] );
+
+	float sum = 0.0f;
+	sum += invMass.A.invMass * linearA.Dot( linearA );
+	sum += angularA.Dot( invMass.A.invInertia * angularA );
+	sum += invMass.B.invMass * linearB.Dot( linearB );
+	sum += angularB.Dot( invMass.B.invInertia * angularB );
+	return sum;
 }
 
 /*
 ====================================================
-Constraint::GetVelocities
+Constraint::MulInverseMass
 ====================================================
 */
-inline VecN Constraint::GetVelocities() const {
-	VecN q_dt( 12 );
+inline VecFixed< 12 > Constraint::MulInverseMass( const constraintInvMass_t & invMass, const VecFixed< 12 > & v ) {
+	const Vec3 angularA = invMass.A.invInertia * Vec3( v[ 3 ], v[ 4 ], v[ 5 ] );
+	const Vec3 angularB = invMass.B.invInertia * Vec3( v[ 9 ], v[ 10 ], v[ 11 ] );
+
+	VecFixed< 12 > tmp;
+	for ( int i = 0; i < 3; i++ ) {
+		tmp[ 0 + i ] = v[ 0 + i ] * invMass.A.invMass;
+		tmp[ 3 + i ] = angularA[ i ];
+		tmp[ 6 + i ] = v[ 6 + i ] * invMass.B.invMass;
+		tmp[ 9 + i ] = angularB[ i ];
+	}
+	return tmp;
+}
 
-	// TODO: Add code
+/*
+====================================================
+Constraint::GetVelocities
+====================================================
+*/
+inline VecFixed< 12 > Constraint::GetVelocities() const {
+	VecFixed< 12 > q_dt;
+
+	const Vec3 & linVelA = m_bodyA.GetLinearVelocity();
+	const Vec3 & angVelA = m_bodyA.GetAngularVelocity();
+	const Vec3 & linVelB = m_bodyB.GetLinearVelocity();
+	const Vec3 & angVelB = m_bodyB.GetAngularVelocity();
+	for ( int i = 0; i < 3; i++ ) {
+		q_dt[ 0 + i ] = linVelA[ i ];
+		q_dt[ 3 + i ] = angVelA[ i ];
+		q_dt[ 6 + i ] = linVelB[ i ];
+		q_dt[ 9 + i ] = angVelB[ i ];
+	}
 
 	return q_dt;
 }
@@ -71,8 +150,11 @@ inline VecN Constraint::GetVelocities() const {
 Constraint::ApplyImpulses
 ====================================================
 */
-inline void Constraint::ApplyImpulses( const VecN & impulses ) {
-	// TODO: Add code
+inline void Constraint::ApplyImpulses( const constraintInvMass_t & invMass, const VecFixed< 12 > & impulses ) {
+	const VecFixed< 12 > dq = MulInverseMass( invMass, impulses );
+
+	m_bodyA.ApplyVelocityChange( Vec3( dq[ 0 ], dq[ 1 ], dq[ 2 ] ), Vec3( dq[ 3 ], dq[ 4 ], dq[ 5 ] ) );
+	m_bodyB.ApplyVelocityChange( Vec3( dq[ 6 ], dq[ 7 ], dq[ 8 ] ), Vec3( dq[ 9 ], dq[ 10 ], dq[ 11 ] ) );
 }
 
 /*
@@ -82,9 +164,10 @@ Constraint::Left
 */
 inline Mat4 Constraint::Left( const Quat & q ) {
 	Mat4 L;
-	
-	// TODO: Add code
-
+	L.rows[ 0 ] = Vec4( q.w, -q.x, -q.y, -q.z );
+	L.rows[ 1 ] = Vec4( q.x,  q.w, -q.z,  q.y );
+	L.rows[ 2 ] = Vec4( q.y,  q.z,  q.w, -q.x );
+	L.rows[ 3 ] = Vec4( q.z, -q.y,  q.x,  q.w );
 	return L.Transpose();
 }
 
@@ -95,8 +178,9 @@ Constraint::Right
 */
 inline Mat4 Constraint::Right( const Quat & q ) {
 	Mat4 R;
-	
-	// TODO: Add code
-
+	R.rows[ 0 ] = Vec4( q.w, -q.x, -q.y, -q.z );
+	R.rows[ 1 ] = Vec4( q.x,  q.w,  q.z, -q.y );
+	R.rows[ 2 ] = Vec4( q.y, -q.z,  q.w,  q.x );
+	R.rows[ 3 ] = Vec4( q.z,  q.y, -q.x,  q.w );
 	return R.Transpose();
 }
\ No newline at end of file
@@ -11,7 +11,7 @@ ConstraintHingeQuat
 */
 class ConstraintHingeQuat : public Constraint {
 public:
-	ConstraintHingeQuat() : Constraint(), m_cachedLambda( 3 ), m_Jacobian( 3, 12 ) {
+	ConstraintHingeQuat() : Constraint() {
 		m_cachedLambda.Zero();
 		m_baumgarte = 0.0f;
 	}
@@ -21,8 +21,8 @@ public:
 
 	Quat q0;	// The initial relative quaternion q1^-1 * q2
 
-	VecN m_cachedLambda;
-	MatMN m_Jacobian;
+	VecFixed< 3 > m_cachedLambda;
+	MatFixed< 3, 12 > m_Jacobian;
 
 	float m_baumgarte;
 };
@@ -34,7 +34,7 @@ ConstraintHingeQuatLimited
 */
 class ConstraintHingeQuatLimited : public Constraint {
 public:
-	ConstraintHingeQuatLimited() : Constraint(), m_cachedLambda( 4 ), m_Jacobian( 4, 12 ) {
+	ConstraintHingeQuatLimited() : Constraint() {
 		m_cachedLambda.Zero();
 		m_baumgarte = 0.0f;
 		m_isAngleViolated = false;
@@ -46,8 +46,8 @@ public:
 
 	Quat m_q0;	// The initial relative quaternion q1^-1 * q2
 
-	VecN m_cachedLambda;
-	MatMN m_Jacobian;
+	VecFixed< 4 > m_cachedLambda;
+	MatFixed< 4, 12 > m_Jacobian;
 
 	float m_baumgarte;
 
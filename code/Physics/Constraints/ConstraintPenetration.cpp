@@ -2,6 +2,8 @@
 //  ConstraintPenetration.cpp
 //
 #include "ConstraintPenetration.h"
+#include <algorithm>
+#include <float.h>
 
 /*
 ================================
@@ -9,14 +11,114 @@ ConstraintPenetration::PreSolve
 ================================
 */
 void ConstraintPenetration::PreSolve( const float dt_sec ) {
-	// TODO: Add code
+	// Get the world space position of the contact from A's orientation
+	const Vec3 worldAnchorA = m_bodyA.BodySpaceToWorldSpace( m_anchorA );
+
+	// Get the world space position of the contact from B's orientation
+	const Vec3 worldAnchorB = m_bodyB.BodySpaceToWorldSpace( m_anchorB );
+
+	const Vec3 ra = worldAnchorA - m_bodyA.GetCenterOfMassWorldSpace();
+	const Vec3 rb = worldAnchorB - m_bodyB.GetCenterOfMassWorldSpace();
+
+	m_friction = m_bodyA.GetFriction() * m_bodyB.GetFriction();
+
+	// the tangents are picked in A's space, so they turn with A and the cached friction impulses still line up next step
+	Vec3 u;
+	Vec3 v;
+	m_normal.GetOrtho( u, v );
+
+	// Convert tangent space from model space to world space
+	const Quat & orientationA = m_bodyA.GetOrientation();
+	const Vec3 normal = orientationA.RotatePoint( m_normal );
+	u = orientationA.RotatePoint( u );
+	v = orientationA.RotatePoint( v );
+
+	// one row per direction, the first is the non penetration constraint and the other two are friction
+	const Vec3 directions[ 3 ] = { normal, u, v };
+	m_invMass = GetInverseMass();
+	for ( int row = 0; row < 3; row++ ) {
+		const Vec3 & dir = directions[ row ];
+		const Vec3 angularA = ra.Cross( dir * -1.0f );
+		const Vec3 angularB = rb.Cross( dir );
+
+		jacobianRow_t & J = m_Jacobian.rows[ row ];
+		for ( int i = 0; i < 3; i++ ) {
+			J[ 0 + i ] = -dir[ i ];
+			J[ 3 + i ] = angularA[ i ];
+			J[ 6 + i ] = dir[ i ];
+			J[ 9 + i ] = angularB[ i ];
+		}
+
+		const float J_W_Jt = GetJWJt( J, m_invMass );
+		m_effectiveMass[ row ] = ( J_W_Jt > 0.0f ) ? 1.0f / J_W_Jt : 0.0f;
+	}
+
+	// friction impulses from before the friction went away mustn't get warm started
+	if ( m_friction <= 0.0f ) {
+		m_cachedLambda[ 1 ] = 0.0f;
+		m_cachedLambda[ 2 ] = 0.0f;
+	}
+
+	//
+	// Apply warm starting from last frame
+	//
+	const VecFixed< 12 > impulses = m_Jacobian.Transpose() * m_cachedLambda;
+	ApplyImpulses( m_invMass, impulses );
+
+	//
+	//	Calculate the baumgarte stabilization
+	//
+	float C = ( worldAnchorB - worldAnchorA ).Dot( normal );
+	C = std::min( 0.0f, C + 0.02f );	// Add slop
+	const float Beta = 0.25f;
+
+	// bodies that start out deep inside each other get pushed apart over a few steps, instead of launched
+	const float maxCorrectionSpeed = 1.0f;
+	m_baumgarte = std::max( Beta * C / dt_sec, -maxCorrectionSpeed );
+
+	m_impulseDelta = 0.0f;
 }
 
 /*
 ================================
-ConstraintPenetration::PreSolve
+ConstraintPenetration::Solve
+
+one sequential impulse per row. it's the accumulated impulse that gets
+clamped, not the change, so an iteration can take back some of what an
+earlier one ( or the warm start ) overdid. this is projected gauss seidel
+on the rows, relaxation scales each change before it's clamped. the scene
+runs the iterations with LCP_Iterate
 ================================
 */
-void ConstraintPenetration::Solve() {
-	// TODO: Add code
+void ConstraintPenetration::Solve( const float relaxation ) {
+	m_impulseDelta = 0.0f;
+
+	// friction first, so the normal row gets the last word each iteration
+	const int order[ 3 ] = { 1, 2, 0 };
+	for ( int i = 0; i < 3; i++ ) {
+		const int row = order[ i ];
+		if ( row > 0 && m_friction <= 0.0f ) {
+			continue;
+		}
+
+		const jacobianRow_t & J = m_Jacobian.rows[ row ];
+		const VecFixed< 12 > q_dt = GetVelocities();
+		const float bias = ( 0 == row ) ? m_baumgarte : 0.0f;
+		float lambda = -relaxation * ( J.Dot( q_dt ) + bias ) * m_effectiveMass[ row ];
+
+		// contacts can only push, and friction can't be stronger than the normal impulse allows
+		float lower = 0.0f;
+		float upper = FLT_MAX;
+		if ( row > 0 ) {
+			upper = LCP_FrictionLimit( m_friction, m_cachedLambda[ 0 ] );
+			lower = -upper;
+		}
+		const float oldLambda = m_cachedLambda[ row ];
+		const float newLambda = LCP_ProjectRow( oldLambda + lambda, lower, upper );
+		lambda = newLambda - oldLambda;
+		m_cachedLambda[ row ] = newLambda;
+
+		ApplyImpulses( m_invMass, J * lambda );
+		m_impulseDelta = std::max( m_impulseDelta, fabsf( lambda ) );
+	}
 }
\ No newline at end of file
@@ -7,24 +7,37 @@
 /*
 ================================
 ConstraintPenetration
+
+one contact point of a manifold: a non penetration row along the normal
+and two friction rows across it. the impulses accumulated over a step are
+kept, and the next step starts by applying them again ( warm starting ),
+so a resting contact only has to correct what changed since
 ================================
 */
 class ConstraintPenetration : public Constraint {
 public:
-	ConstraintPenetration() : Constraint(), m_cachedLambda( 3 ), m_Jacobian( 3, 12 ) {
+	ConstraintPenetration() : Constraint() {
 		m_cachedLambda.Zero();
 		m_baumgarte = 0.0f;
 		m_friction = 0.0f;
+		m_impulseDelta = 0.0f;
+		for ( int i = 0; i < 3; i++ ) {
+			m_effectiveMass[ i ] = 0.0f;
+		}
 	}
 
 	void PreSolve( const float dt_sec ) override;
-	void Solve() override;
+	void Solve() override { Solve( 1.0f ); }
+	void Solve( const float relaxation );
 
-	VecN m_cachedLambda;
+	VecFixed< 3 > m_cachedLambda;	// normal, then the two friction directions
 	Vec3 m_normal;		// in Body A's local space
 
-	MatMN m_Jacobian;
+	MatFixed< 3, 12 > m_Jacobian;
+	float m_effectiveMass[ 3 ];	// 1 / ( J M^-1 J^T ) of each row
+	constraintInvMass_t m_invMass;	// both bodies' blocks, as of PreSolve
 
 	float m_baumgarte;
 	float m_friction;
+	float m_impulseDelta;	// largest change the last Solve made to the accumulated impulses
 };
\ No newline at end of file
@@ -9,18 +9,18 @@ ResolveContact
 ====================================================
 */
 void ResolveContact( const contact_t & contact ) {
-	Body * const bodyA = contact.bodyA;
-	Body * const bodyB = contact.bodyB;
+	Body bodyA = contact.bodyA;
+	Body bodyB = contact.bodyB;
 	const Vec3 ptOnA   = contact.ptOnA_WorldSpace;
 	const Vec3 ptOnB   = contact.ptOnB_WorldSpace;
-	const float sysElasticity = bodyA->m_elasticity * bodyB->m_elasticity;
-	const float invMassA = contact.bodyA->m_invMass;
-	const float invMassB = contact.bodyB->m_invMass;
-	const Mat3 invWorldInertiaA = bodyA->GetInverseInertiaTensorWorldSpace();
-	const Mat3 invWorldInertiaB = bodyB->GetInverseInertiaTensorWorldSpace();
+	const float sysElasticity = bodyA.GetElasticity() * bodyB.GetElasticity();
+	const float invMassA = bodyA.GetInvMass();
+	const float invMassB = bodyB.GetInvMass();
+	const Mat3 & invWorldInertiaA = bodyA.GetInverseInertiaTensorWorldSpace();
+	const Mat3 & invWorldInertiaB = bodyB.GetInverseInertiaTensorWorldSpace();
 	const Vec3 normal  = contact.normal;
-	const Vec3 radiusA = ptOnA - bodyA->GetCenterOfMassWorldSpace();
-	const Vec3 radiusB = ptOnB - bodyB->GetCenterOfMassWorldSpace();
+	const Vec3 radiusA = ptOnA - bodyA.GetCenterOfMassWorldSpace();
+	const Vec3 radiusB = ptOnB - bodyB.GetCenterOfMassWorldSpace();
 
 	// get a vector orthogonal to axis of rotation and radius, whose magnitude is the angular impulse 
 	// ( basically, the second basis vector of the 2d subspace, or "disc" of rotation )
@@ -30,19 +30,19 @@ void ResolveContact( const contact_t & contact ) {
 	const float angularFactor = ( angImpulseA + angImpulseB ).Dot( normal );
 
 	// world space velocity including both motion and rotation
-	const Vec3 velA = bodyA->m_linearVelocity + bodyA->m_angularVelocity.Cross( radiusA );
-	const Vec3 velB = bodyB->m_linearVelocity + bodyB->m_angularVelocity.Cross( radiusB );
+	const Vec3 velA = bodyA.GetLinearVelocity() + bodyA.GetAngularVelocity().Cross( radiusA );
+	const Vec3 velB = bodyB.GetLinearVelocity() + bodyB.GetAngularVelocity().Cross( radiusB );
 
 	// Calculate and apply collision impulse
 	const Vec3 velARelToB  = velA - velB;
 	const float impulseMag = ( 1.f + sysElasticity ) * velARelToB.Dot( normal ) / ( invMassA + invMassB + angularFactor );
 	const Vec3 impulseVec  = normal * impulseMag;
-	bodyA->ApplyImpulse( ptOnA, impulseVec * -1.f );
-	bodyB->ApplyImpulse( ptOnB, impulseVec *  1.f );
+	bodyA.ApplyImpulse( ptOnA, impulseVec * -1.f );
+	bodyB.ApplyImpulse( ptOnB, impulseVec *  1.f );
 
 	// Calculate impulse caused by friction
-	const float frictionA = bodyA->m_friction;	   // 0 ~ 1
-	const float frictionB = bodyB->m_friction;	   // 0 ~ 1
+	const float frictionA = bodyA.GetFriction();	   // 0 ~ 1
+	const float frictionB = bodyB.GetFriction();	   // 0 ~ 1
 	const float frictionT = frictionA * frictionB; // 0 ~ 1
 
 	// Calculate velocity components normal and tangential ( perpendicular ) to collision
@@ -61,8 +61,8 @@ void ResolveContact( const contact_t & contact ) {
 	const float reducedMass    = 1.f / ( invMassA + invMassB + invInertia );
 	const Vec3 impulseFriction = velTangDir * reducedMass * frictionT;
 
-	bodyA->ApplyImpulse( ptOnA, impulseFriction * -1.f );
-	bodyB->ApplyImpulse( ptOnB, impulseFriction *  1.f );
+	bodyA.ApplyImpulse( ptOnA, impulseFriction * -1.f );
+	bodyB.ApplyImpulse( ptOnB, impulseFriction *  1.f );
 
 	// only do the fake separation of colliding bodies w valid time of impact
 	if ( 0.f == contact.timeOfImpact ) {
@@ -71,7 +71,7 @@ void ResolveContact( const contact_t & contact ) {
 		const Vec3 separationDist = ptOnB - ptOnA;
 		const float adjustPercA   = invMassA / ( invMassA + invMassB );
 		const float adjustPercB   = invMassB / ( invMassA + invMassB );
-		bodyA->m_position += separationDist * adjustPercA;
-		bodyB->m_position -= separationDist * adjustPercB;
+		bodyA.GetPosition() += separationDist * adjustPercA;
+		bodyB.GetPosition() -= separationDist * adjustPercB;
 	}
 }
\ No newline at end of file
@@ -15,8 +15,8 @@ struct contact_t {
 	float separationDistance;	// positive when non-penetrating, negative when penetrating
 	float timeOfImpact;
 
-	Body * bodyA;
-	Body * bodyB;
+	Body bodyA;
+	Body bodyB;
 };
 
 void ResolveContact( const contact_t & contact );
\ No newline at end of file
@@ -0,0 +1,278 @@
+//
+//	ContactBatch.cpp
+//
+#include "ContactBatch.h"
+#include "../Math/LCP.h"
+#include <algorithm>
+#include <float.h>
+
+/*
+====================================================
+SolveRowLanes
+
+one row of ConstraintPenetration::Solve for lane_t::WIDTH contacts. v holds
+the velocities of the lanes' bodies, A's linear and angular then B's, and
+gets the velocity change applied. returns the size of the change made to
+the accumulated impulse
+====================================================
+*/
+template< typename lane_t >
+static lane_t SolveRowLanes( float * const * rowStreams, const int lane, lane_t * v,
+							 const lane_t & invMassA, const lane_t & invMassB, const lane_t & bias,
+							 const lane_t & lower, const lane_t & upper, const lane_t & relaxation ) {
+	lane_t linX, linY, linZ, angAX, angAY, angAZ, angBX, angBY, angBZ;
+	lane_t wAngAX, wAngAY, wAngAZ, wAngBX, wAngBY, wAngBZ, effectiveMass, oldLambda;
+	SimdLoad( linX, rowStreams[ ContactBatch::LIN_X ] + lane );
+	SimdLoad( linY, rowStreams[ ContactBatch::LIN_Y ] + lane );
+	SimdLoad( linZ, rowStreams[ ContactBatch::LIN_Z ] + lane );
+	SimdLoad( angAX, rowStreams[ ContactBatch::ANG_A_X ] + lane );
+	SimdLoad( angAY, rowStreams[ ContactBatch::ANG_A_Y ] + lane );
+	SimdLoad( angAZ, rowStreams[ ContactBatch::ANG_A_Z ] + lane );
+	SimdLoad( angBX, rowStreams[ ContactBatch::ANG_B_X ] + lane );
+	SimdLoad( angBY, rowStreams[ ContactBatch::ANG_B_Y ] + lane );
+	SimdLoad( angBZ, rowStreams[ ContactBatch::ANG_B_Z ] + lane );
+	SimdLoad( wAngAX, rowStreams[ ContactBatch::INV_MASS_ANG_A_X ] + lane );
+	SimdLoad( wAngAY, rowStreams[ ContactBatch::INV_MASS_ANG_A_Y ] + lane );
+	SimdLoad( wAngAZ, rowStreams[ ContactBatch::INV_MASS_ANG_A_Z ] + lane );
+	SimdLoad( wAngBX, rowStreams[ ContactBatch::INV_MASS_ANG_B_X ] + lane );
+	SimdLoad( wAngBY, rowStreams[ ContactBatch::INV_MASS_ANG_B_Y ] + lane );
+	SimdLoad( wAngBZ, rowStreams[ ContactBatch::INV_MASS_ANG_B_Z ] + lane );
+	SimdLoad( effectiveMass, rowStreams[ ContactBatch::EFFECTIVE_MASS ] + lane );
+	SimdLoad( oldLambda, rowStreams[ ContactBatch::LAMBDA ] + lane );
+
+	// J . v
+	const lane_t relX = v[ 6 ] - v[ 0 ];
+	const lane_t relY = v[ 7 ] - v[ 1 ];
+	const lane_t relZ = v[ 8 ] - v[ 2 ];
+	const lane_t Jv = linX * relX + linY * relY + linZ * relZ
+					+ angAX * v[ 3 ] + angAY * v[ 4 ] + angAZ * v[ 5 ]
+					+ angBX * v[ 9 ] + angBY * v[ 10 ] + angBZ * v[ 11 ];
+
+	// the accumulated impulse is what gets clamped
+	const lane_t lambda = -relaxation * ( Jv + bias ) * effectiveMass;
+	const lane_t newLambda = LCP_ProjectRow( oldLambda + lambda, lower, upper );
+	const lane_t delta = newLambda - oldLambda;
+	SimdStore( newLambda, rowStreams[ ContactBatch::LAMBDA ] + lane );
+
+	// M^-1 * Jt * delta
+	const lane_t linA = delta * invMassA;
+	const lane_t linB = delta * invMassB;
+	v[ 0 ] = v[ 0 ] - linX * linA;
+	v[ 1 ] = v[ 1 ] - linY * linA;
+	v[ 2 ] = v[ 2 ] - linZ * linA;
+	v[ 3 ] = v[ 3 ] + wAngAX * delta;
+	v[ 4 ] = v[ 4 ] + wAngAY * delta;
+	v[ 5 ] = v[ 5 ] + wAngAZ * delta;
+	v[ 6 ] = v[ 6 ] + linX * linB;
+	v[ 7 ] = v[ 7 ] + linY * linB;
+	v[ 8 ] = v[ 8 ] + linZ * linB;
+	v[ 9 ] = v[ 9 ] + wAngBX * delta;
+	v[ 10 ] = v[ 10 ] + wAngBY * delta;
+	v[ 11 ] = v[ 11 ] + wAngBZ * delta;
+
+	return SimdMax( delta, -delta );
+}
+
+/*
+====================================================
+ContactBatch::Clear
+====================================================
+*/
+void ContactBatch::Clear() {
+	m_store = nullptr;
+	m_manifolds.clear();
+	m_bodies.clear();
+	m_numSlots.clear();
+}
+
+/*
+====================================================
+ContactBatch::AddGroup
+====================================================
+*/
+void ContactBatch::AddGroup( Manifold * const * manifolds, const int num ) {
+	assert( num > 0 && num <= SIMD_WIDTH );
+
+	int numSlots = 0;
+	for ( int k = 0; k < SIMD_WIDTH; k++ ) {
+		Manifold * manifold = ( k < num ) ? manifolds[ k ] : nullptr;
+		m_manifolds.push_back( manifold );
+		if ( nullptr == manifold ) {
+			m_bodies.push_back( -1 );
+			m_bodies.push_back( -1 );
+			continue;
+		}
+
+		m_store = manifold->m_bodyA.GetStore();
+		m_bodies.push_back( manifold->m_bodyA.GetIndex() );
+		m_bodies.push_back( manifold->m_bodyB.GetIndex() );
+		numSlots = std::max( numSlots, manifold->m_numContacts );
+	}
+	m_numSlots.push_back( numSlots );
+}
+
+/*
+====================================================
+ContactBatch::Gather
+
+empty slots and padding lanes are left all zeros, no effective mass means
+they never change anything
+====================================================
+*/
+void ContactBatch::Gather() {
+	const int numGroups = GetNumGroups();
+	m_stride = SimdStreamStride( numGroups * MAX_CONTACTS * SIMD_WIDTH );
+	m_lanes.resize( NUM_STREAMS * m_stride );
+	std::fill( m_lanes.begin(), m_lanes.end(), 0.0f );
+
+	for ( int group = 0; group < numGroups; group++ ) {
+		for ( int k = 0; k < SIMD_WIDTH; k++ ) {
+			const Manifold * manifold = m_manifolds[ group * SIMD_WIDTH + k ];
+			if ( nullptr == manifold ) {
+				continue;
+			}
+
+			for ( int slot = 0; slot < manifold->m_numContacts; slot++ ) {
+				const ConstraintPenetration & constraint = manifold->m_constraints[ slot ];
+				const int lane = GetLane( group, slot ) + k;
+				for ( int row = 0; row < 3; row++ ) {
+					float * rowStreams[ NUM_ROW_STREAMS ];
+					for ( int s = 0; s < NUM_ROW_STREAMS; s++ ) {
+						rowStreams[ s ] = GetStream( row * NUM_ROW_STREAMS + s );
+					}
+
+					const jacobianRow_t & J = constraint.m_Jacobian.rows[ row ];
+					const Vec3 angA( J[ 3 ], J[ 4 ], J[ 5 ] );
+					const Vec3 angB( J[ 9 ], J[ 10 ], J[ 11 ] );
+					const Vec3 wAngA = constraint.m_invMass.A.invInertia * angA;
+					const Vec3 wAngB = constraint.m_invMass.B.invInertia * angB;
+					for ( int i = 0; i < 3; i++ ) {
+						rowStreams[ LIN_X + i ][ lane ] = J[ 6 + i ];
+						rowStreams[ ANG_A_X + i ][ lane ] = angA[ i ];
+						rowStreams[ ANG_B_X + i ][ lane ] = angB[ i ];
+						rowStreams[ INV_MASS_ANG_A_X + i ][ lane ] = wAngA[ i ];
+						rowStreams[ INV_MASS_ANG_B_X + i ][ lane ] = wAngB[ i ];
+					}
+					rowStreams[ EFFECTIVE_MASS ][ lane ] = constraint.m_effectiveMass[ row ];
+					rowStreams[ LAMBDA ][ lane ] = constraint.m_cachedLambda[ row ];
+				}
+				GetStream( BIAS )[ lane ] = constraint.m_baumgarte;
+				GetStream( FRICTION )[ lane ] = constraint.m_friction;
+				GetStream( INV_MASS_A )[ lane ] = constraint.m_invMass.A.invMass;
+				GetStream( INV_MASS_B )[ lane ] = constraint.m_invMass.B.invMass;
+			}
+		}
+	}
+}
+
+/*
+====================================================
+ContactBatch::SolveGroup
+
+friction first then the normal, slot by slot, the same order as
+ConstraintPenetration::Solve. the velocities stay in registers for the
+whole group
+====================================================
+*/
+float ContactBatch::SolveGroup( const int group, const float relaxation ) {
+	const int * bodies = &m_bodies[ group * SIMD_WIDTH * 2 ];
+
+	// gather, A's linear and angular velocity then B's, one lane per manifold
+	float velocities[ 12 ][ SIMD_WIDTH ];
+	for ( int k = 0; k < SIMD_WIDTH; k++ ) {
+		for ( int b = 0; b < 2; b++ ) {
+			const int idx = bodies[ k * 2 + b ];
+			const Vec3 linear = ( idx >= 0 ) ? m_store->m_linearVelocities[ idx ] : Vec3( 0.0f );
+			const Vec3 angular = ( idx >= 0 ) ? m_store->m_angularVelocities[ idx ] : Vec3( 0.0f );
+			for ( int i = 0; i < 3; i++ ) {
+				velocities[ b * 6 + 0 + i ][ k ] = linear[ i ];
+				velocities[ b * 6 + 3 + i ][ k ] = angular[ i ];
+			}
+		}
+	}
+	simdf_t v[ 12 ];
+	for ( int i = 0; i < 12; i++ ) {
+		SimdLoad( v[ i ], velocities[ i ] );
+	}
+
+	float * streams[ NUM_STREAMS ];
+	for ( int s = 0; s < NUM_STREAMS; s++ ) {
+		streams[ s ] = GetStream( s );
+	}
+	float * const * normalRow = streams + 0 * NUM_ROW_STREAMS;
+	float * const * tangentRowU = streams + 1 * NUM_ROW_STREAMS;
+	float * const * tangentRowV = streams + 2 * NUM_ROW_STREAMS;
+
+	const simdf_t relax = relaxation;
+	const simdf_t zero = 0.0f;
+	simdf_t maxDelta = 0.0f;
+	for ( int slot = 0; slot < m_numSlots[ group ]; slot++ ) {
+		const int lane = GetLane( group, slot );
+		simdf_t bias, friction, invMassA, invMassB, normalLambda;
+		SimdLoad( bias, streams[ BIAS ] + lane );
+		SimdLoad( friction, streams[ FRICTION ] + lane );
+		SimdLoad( invMassA, streams[ INV_MASS_A ] + lane );
+		SimdLoad( invMassB, streams[ INV_MASS_B ] + lane );
+		SimdLoad( normalLambda, normalRow[ LAMBDA ] + lane );
+
+		// friction can't be stronger than the normal impulse allows
+		const simdf_t maxFriction = LCP_FrictionLimit( friction, normalLambda );
+		maxDelta = SimdMax( maxDelta, SolveRowLanes( tangentRowU, lane, v, invMassA, invMassB, zero, -maxFriction, maxFriction, relax ) );
+		maxDelta = SimdMax( maxDelta, SolveRowLanes( tangentRowV, lane, v, invMassA, invMassB, zero, -maxFriction, maxFriction, relax ) );
+
+		// contacts can only push
+		maxDelta = SimdMax( maxDelta, SolveRowLanes( normalRow, lane, v, invMassA, invMassB, bias, zero, simdf_t( FLT_MAX ), relax ) );
+	}
+
+	// scatter, only to the bodies that can move, the rest aren't ours to write
+	for ( int i = 0; i < 12; i++ ) {
+		SimdStore( v[ i ], velocities[ i ] );
+	}
+	for ( int k = 0; k < SIMD_WIDTH; k++ ) {
+		for ( int b = 0; b < 2; b++ ) {
+			const int idx = bodies[ k * 2 + b ];
+			if ( idx < 0 || m_store->m_invMasses[ idx ] == 0.0f ) {
+				continue;
+			}
+
+			m_store->m_isAwake[ idx ] = 1;
+			m_store->m_linearVelocities[ idx ] = Vec3( velocities[ b * 6 + 0 ][ k ], velocities[ b * 6 + 1 ][ k ], velocities[ b * 6 + 2 ][ k ] );
+
+			// same cap as Body::ApplyImpulseAngular, just once for the whole group
+			Vec3 angularVelocity( velocities[ b * 6 + 3 ][ k ], velocities[ b * 6 + 4 ][ k ], velocities[ b * 6 + 5 ][ k ] );
+			const float maxAngularSpeed = 30.f;
+			if ( angularVelocity.GetLengthSqr() > maxAngularSpeed * maxAngularSpeed ) {
+				angularVelocity.Normalize();
+				angularVelocity *= maxAngularSpeed;
+			}
+			m_store->m_angularVelocities[ idx ] = angularVelocity;
+		}
+	}
+
+	float deltas[ SIMD_WIDTH ];
+	SimdStore( maxDelta, deltas );
+	return *std::max_element( deltas, deltas + SIMD_WIDTH );
+}
+
+/*
+====================================================
+ContactBatch::StoreImpulses
+====================================================
+*/
+void ContactBatch::StoreImpulses() {
+	for ( int group = 0; group < GetNumGroups(); group++ ) {
+		for ( int k = 0; k < SIMD_WIDTH; k++ ) {
+			Manifold * manifold = m_manifolds[ group * SIMD_WIDTH + k ];
+			if ( nullptr == manifold ) {
+				continue;
+			}
+
+			for ( int slot = 0; slot < manifold->m_numContacts; slot++ ) {
+				const int lane = GetLane( group, slot ) + k;
+				for ( int row = 0; row < 3; row++ ) {
+					manifold->m_constraints[ slot ].m_cachedLambda[ row ] = GetStream( row * NUM_ROW_STREAMS + LAMBDA )[ lane ];
+				}
+			}
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,79 @@
+//
+//	ContactBatch.h
+//
+#pragma once
+#include "Manifold.h"
+#include "../Math/Simd.h"
+#include <vector>
+
+/*
+====================================================
+ContactBatch
+
+Wide version of Manifold::Solve. The manifolds go in SIMD_WIDTH at a time,
+one per lane, and every contact row is stored as a lane of float streams
+( the Jacobian, invMass * Jt, effective mass and accumulated impulse ).
+Solving a group gathers the velocities of its bodies once, runs the normal
+and friction rows of every contact slot for all the lanes at once, and
+scatters the velocities back. The manifolds of a group must never share a
+body that can move, that's what the coloring is for, so lanes never step on
+each other. Contacts are filled in from the manifolds after their PreSolve,
+and the accumulated impulses go back with StoreImpulses for next step's
+warm start.
+====================================================
+*/
+class ContactBatch {
+public:
+	ContactBatch() : m_store( nullptr ), m_stride( 0 ) {}
+
+	void Clear();
+	int GetNumGroups() const { return static_cast< int >( m_numSlots.size() ); }
+
+	// up to SIMD_WIDTH manifolds, that have been through PreSolve
+	void AddGroup( Manifold * const * manifolds, const int num );
+
+	// copies the contacts of every group into the lanes
+	void Gather();
+
+	// one iteration over a group, returns the largest change to any accumulated impulse
+	float SolveGroup( const int group, const float relaxation );
+
+	// the accumulated impulses back into the contacts
+	void StoreImpulses();
+
+	// streams of one row, the normal row first then the two friction directions
+	enum rowStream_t {
+		LIN_X, LIN_Y, LIN_Z,								// B's linear part of the Jacobian, A's is the negative
+		ANG_A_X, ANG_A_Y, ANG_A_Z,
+		ANG_B_X, ANG_B_Y, ANG_B_Z,
+		INV_MASS_ANG_A_X, INV_MASS_ANG_A_Y, INV_MASS_ANG_A_Z,	// invInertia * the angular parts, the velocity change per unit impulse
+		INV_MASS_ANG_B_X, INV_MASS_ANG_B_Y, INV_MASS_ANG_B_Z,
+		EFFECTIVE_MASS,
+		LAMBDA,
+		NUM_ROW_STREAMS
+	};
+
+	// streams of a whole contact, after the three rows
+	enum contactStream_t {
+		BIAS = 3 * NUM_ROW_STREAMS,
+		FRICTION,
+		INV_MASS_A,
+		INV_MASS_B,
+		NUM_STREAMS
+	};
+
+private:
+	static const int MAX_CONTACTS = Manifold::MAX_CONTACTS;
+
+	float * GetStream( const int stream ) { return &m_lanes[ stream * m_stride ]; }
+
+	// first lane of a contact slot of a group
+	static int GetLane( const int group, const int slot ) { return ( group * MAX_CONTACTS + slot ) * SIMD_WIDTH; }
+
+	BodyStore * m_store;
+	std::vector< Manifold * > m_manifolds;	// SIMD_WIDTH per group, null for the padding lanes
+	std::vector< int > m_bodies;			// store index of body A and B of every lane, -1 for padding
+	std::vector< int > m_numSlots;			// most contacts of any manifold in each group
+	std::vector< float > m_lanes;
+	int m_stride;
+};
\ No newline at end of file
@@ -0,0 +1,413 @@
+//
+//  DynamicAABBTree.cpp
+//
+#include "DynamicAABBTree.h"
+#include <algorithm>
+
+namespace {
+// padding added around the tight bounds, so small jitters don't force a re-insert
+static constexpr float FAT_MARGIN = 0.1f;
+// how far ahead along the displacement the fat bounds are stretched
+static constexpr float DISPLACEMENT_MULTIPLIER = 2.0f;
+}
+
+/*
+====================================================
+DynamicAABBTree::DynamicAABBTree
+====================================================
+*/
+DynamicAABBTree::DynamicAABBTree() :
+	m_root( NULL_NODE ),
+	m_freeList( NULL_NODE ) {
+}
+
+/*
+====================================================
+DynamicAABBTree::Clear
+====================================================
+*/
+void DynamicAABBTree::Clear() {
+	m_nodes.clear();
+	m_root = NULL_NODE;
+	m_freeList = NULL_NODE;
+}
+
+/*
+====================================================
+DynamicAABBTree::Union
+====================================================
+*/
+Bounds DynamicAABBTree::Union( const Bounds & a, const Bounds & b ) {
+	Bounds bounds = a;
+	bounds.Expand( b );
+	return bounds;
+}
+
+/*
+====================================================
+DynamicAABBTree::RayBounds
+
+slab test, invDir is 1 / ( end - start ) so t is in units of the full segment
+====================================================
+*/
+bool DynamicAABBTree::RayBounds( const Vec3 & start, const Vec3 & invDir, const float maxT, const Bounds & bounds ) {
+	float tmin = 0.0f;
+	float tmax = maxT;
+	for ( int i = 0; i < 3; i++ ) {
+		float t1 = ( bounds.mins[ i ] - start[ i ] ) * invDir[ i ];
+		float t2 = ( bounds.maxs[ i ] - start[ i ] ) * invDir[ i ];
+		if ( t1 > t2 ) {
+			std::swap( t1, t2 );
+		}
+
+		// NaN from 0 * inf ( ray parallel to and touching the slab ) fails both compares and is ignored
+		if ( t1 > tmin ) {
+			tmin = t1;
+		}
+		if ( t2 < tmax ) {
+			tmax = t2;
+		}
+		if ( tmin > tmax ) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/*
+====================================================
+DynamicAABBTree::AllocateNode
+====================================================
+*/
+int DynamicAABBTree::AllocateNode() {
+	if ( m_freeList == NULL_NODE ) {
+		node_t node;
+		node.parent = NULL_NODE;
+		node.height = -1;
+		m_nodes.push_back( node );
+		m_freeList = static_cast< int >( m_nodes.size() ) - 1;
+	}
+
+	const int nodeId = m_freeList;
+	node_t & node = m_nodes[ nodeId ];
+	m_freeList = node.parent;
+
+	node.parent = NULL_NODE;
+	node.child1 = NULL_NODE;
+	node.child2 = NULL_NODE;
+	node.height = 0;
+	node.userData = -1;
+	return nodeId;
+}
+
+/*
+====================================================
+DynamicAABBTree::FreeNode
+====================================================
+*/
+void DynamicAABBTree::FreeNode( const int nodeId ) {
+	node_t & node = m_nodes[ nodeId ];
+	node.parent = m_freeList;
+	node.height = -1;
+	m_freeList = nodeId;
+}
+
+/*
+====================================================
+DynamicAABBTree::CreateProxy
+====================================================
+*/
+int DynamicAABBTree::CreateProxy( const Bounds & bounds, const int userData ) {
+	const int proxyId = AllocateNode();
+
+	node_t & node = m_nodes[ proxyId ];
+	node.bounds = bounds;
+	node.bounds.Expand( bounds.mins - Vec3( FAT_MARGIN ) );
+	node.bounds.Expand( bounds.maxs + Vec3( FAT_MARGIN ) );
+	node.userData = userData;
+
+	InsertLeaf( proxyId );
+	return proxyId;
+}
+
+/*
+====================================================
+DynamicAABBTree::DestroyProxy
+====================================================
+*/
+void DynamicAABBTree::DestroyProxy( const int proxyId ) {
+	assert( m_nodes[ proxyId ].IsLeaf() );
+
+	RemoveLeaf( proxyId );
+	FreeNode( proxyId );
+}
+
+/*
+====================================================
+DynamicAABBTree::MoveProxy
+
+returns true if the proxy had to be re-inserted
+====================================================
+*/
+bool DynamicAABBTree::MoveProxy( const int proxyId, const Bounds & bounds, const Vec3 & displacement ) {
+	assert( m_nodes[ proxyId ].IsLeaf() );
+
+	if ( m_nodes[ proxyId ].bounds.Contains( bounds ) ) {
+		return false;
+	}
+
+	RemoveLeaf( proxyId );
+
+	// fatten, and stretch along the direction we are heading so we stay inside for a few more steps
+	Bounds fat = bounds;
+	fat.Expand( bounds.mins - Vec3( FAT_MARGIN ) );
+	fat.Expand( bounds.maxs + Vec3( FAT_MARGIN ) );
+	const Vec3 predicted = displacement * DISPLACEMENT_MULTIPLIER;
+	fat.Expand( fat.mins + predicted );
+	fat.Expand( fat.maxs + predicted );
+	m_nodes[ proxyId ].bounds = fat;
+
+	InsertLeaf( proxyId );
+	return true;
+}
+
+/*
+====================================================
+DynamicAABBTree::InsertLeaf
+====================================================
+*/
+void DynamicAABBTree::InsertLeaf( const int leaf ) {
+	if ( m_root == NULL_NODE ) {
+		m_root = leaf;
+		m_nodes[ m_root ].parent = NULL_NODE;
+		return;
+	}
+
+	// Find the best sibling, by walking down the tree and only descending
+	// while it's cheaper ( in added surface area ) than pairing up right here
+	const Bounds leafBounds = m_nodes[ leaf ].bounds;
+	int index = m_root;
+	while ( !m_nodes[ index ].IsLeaf() ) {
+		const node_t & node = m_nodes[ index ];
+		const int child1 = node.child1;
+		const int child2 = node.child2;
+
+		const float area = node.bounds.SurfaceArea();
+		const float combinedArea = Union( node.bounds, leafBounds ).SurfaceArea();
+
+		// cost of creating a new parent for this node and the new leaf
+		const float cost = 2.0f * combinedArea;
+
+		// minimum cost of pushing the leaf further down the tree ( every ancestor grows )
+		const float inheritanceCost = 2.0f * ( combinedArea - area );
+
+		float cost1 = Union( leafBounds, m_nodes[ child1 ].bounds ).SurfaceArea() + inheritanceCost;
+		if ( !m_nodes[ child1 ].IsLeaf() ) {
+			cost1 -= m_nodes[ child1 ].bounds.SurfaceArea();
+		}
+		float cost2 = Union( leafBounds, m_nodes[ child2 ].bounds ).SurfaceArea() + inheritanceCost;
+		if ( !m_nodes[ child2 ].IsLeaf() ) {
+			cost2 -= m_nodes[ child2 ].bounds.SurfaceArea();
+		}
+
+		if ( cost < cost1 && cost < cost2 ) {
+			break;
+		}
+		index = ( cost1 < cost2 ) ? child1 : child2;
+	}
+	const int sibling = index;
+
+	// Create a new parent for the sibling and the leaf
+	const int oldParent = m_nodes[ sibling ].parent;
+	const int newParent = AllocateNode();
+	m_nodes[ newParent ].parent = oldParent;
+	m_nodes[ newParent ].bounds = Union( leafBounds, m_nodes[ sibling ].bounds );
+	m_nodes[ newParent ].height = m_nodes[ sibling ].height + 1;
+	m_nodes[ newParent ].child1 = sibling;
+	m_nodes[ newParent ].child2 = leaf;
+	m_nodes[ sibling ].parent = newParent;
+	m_nodes[ leaf ].parent = newParent;
+
+	if ( oldParent != NULL_NODE ) {
+		if ( m_nodes[ oldParent ].child1 == sibling ) {
+			m_nodes[ oldParent ].child1 = newParent;
+		} else {
+			m_nodes[ oldParent ].child2 = newParent;
+		}
+	} else {
+		m_root = newParent;
+	}
+
+	// Walk back up, rebalancing and refitting the ancestors
+	index = m_nodes[ leaf ].parent;
+	while ( index != NULL_NODE ) {
+		index = Balance( index );
+
+		node_t & node = m_nodes[ index ];
+		node.height = 1 + std::max( m_nodes[ node.child1 ].height, m_nodes[ node.child2 ].height );
+		node.bounds = Union( m_nodes[ node.child1 ].bounds, m_nodes[ node.child2 ].bounds );
+
+		index = node.parent;
+	}
+}
+
+/*
+====================================================
+DynamicAABBTree::RemoveLeaf
+====================================================
+*/
+void DynamicAABBTree::RemoveLeaf( const int leaf ) {
+	if ( leaf == m_root ) {
+		m_root = NULL_NODE;
+		return;
+	}
+
+	const int parent = m_nodes[ leaf ].parent;
+	const int grandParent = m_nodes[ parent ].parent;
+	const int sibling = ( m_nodes[ parent ].child1 == leaf ) ? m_nodes[ parent ].child2 : m_nodes[ parent ].child1;
+
+	if ( grandParent == NULL_NODE ) {
+		m_root = sibling;
+		m_nodes[ sibling ].parent = NULL_NODE;
+		FreeNode( parent );
+		return;
+	}
+
+	// Destroy the parent and connect the sibling to the grand parent
+	if ( m_nodes[ grandParent ].child1 == parent ) {
+		m_nodes[ grandParent ].child1 = sibling;
+	} else {
+		m_nodes[ grandParent ].child2 = sibling;
+	}
+	m_nodes[ sibling ].parent = grandParent;
+	FreeNode( parent );
+
+	// Adjust the ancestor bounds
+	int index = grandParent;
+	while ( index != NULL_NODE ) {
+		index = Balance( index );
+
+		node_t & node = m_nodes[ index ];
+		node.bounds = Union( m_nodes[ node.child1 ].bounds, m_nodes[ node.child2 ].bounds );
+		node.height = 1 + std::max( m_nodes[ node.child1 ].height, m_nodes[ node.child2 ].height );
+
+		index = node.parent;
+	}
+}
+
+/*
+====================================================
+DynamicAABBTree::Balance
+
+If one child of A is more than one level taller than the other, rotate the
+taller child up into A's place ( A takes the shorter of its grand children ).
+Returns the index of the new subtree root.
+====================================================
+*/
+int DynamicAABBTree::Balance( const int iA ) {
+	node_t * A = &m_nodes[ iA ];
+	if ( A->IsLeaf() || A->height < 2 ) {
+		return iA;
+	}
+
+	const int iB = A->child1;
+	const int iC = A->child2;
+	node_t * B = &m_nodes[ iB ];
+	node_t * C = &m_nodes[ iC ];
+
+	const int balance = C->height - B->height;
+
+	// Rotate C up
+	if ( balance > 1 ) {
+		const int iF = C->child1;
+		const int iG = C->child2;
+		node_t * F = &m_nodes[ iF ];
+		node_t * G = &m_nodes[ iG ];
+
+		// Swap A and C
+		C->child1 = iA;
+		C->parent = A->parent;
+		A->parent = iC;
+
+		// A's old parent should point to C
+		if ( C->parent != NULL_NODE ) {
+			if ( m_nodes[ C->parent ].child1 == iA ) {
+				m_nodes[ C->parent ].child1 = iC;
+			} else {
+				m_nodes[ C->parent ].child2 = iC;
+			}
+		} else {
+			m_root = iC;
+		}
+
+		// Rotate
+		if ( F->height > G->height ) {
+			C->child2 = iF;
+			A->child2 = iG;
+			G->parent = iA;
+			A->bounds = Union( B->bounds, G->bounds );
+			C->bounds = Union( A->bounds, F->bounds );
+
+			A->height = 1 + std::max( B->height, G->height );
+			C->height = 1 + std::max( A->height, F->height );
+		} else {
+			C->child2 = iG;
+			A->child2 = iF;
+			F->parent = iA;
+			A->bounds = Union( B->bounds, F->bounds );
+			C->bounds = Union( A->bounds, G->bounds );
+
+			A->height = 1 + std::max( B->height, F->height );
+			C->height = 1 + std::max( A->height, G->height );
+		}
+		return iC;
+	}
+
+	// Rotate B up
+	if ( balance < -1 ) {
+		const int iD = B->child1;
+		const int iE = B->child2;
+		node_t * D = &m_nodes[ iD ];
+		node_t * E = &m_nodes[ iE ];
+
+		// Swap A and B
+		B->child1 = iA;
+		B->parent = A->parent;
+		A->parent = iB;
+
+		// A's old parent should point to B
+		if ( B->parent != NULL_NODE ) {
+			if ( m_nodes[ B->parent ].child1 == iA ) {
+				m_nodes[ B->parent ].child1 = iB;
+			} else {
+				m_nodes[ B->parent ].child2 = iB;
+			}
+		} else {
+			m_root = iB;
+		}
+
+		// Rotate
+		if ( D->height > E->height ) {
+			B->child2 = iD;
+			A->child1 = iE;
+			E->parent = iA;
+			A->bounds = Union( C->bounds, E->bounds );
+			B->bounds = Union( A->bounds, D->bounds );
+
+			A->height = 1 + std::max( C->height, E->height );
+			B->height = 1 + std::max( A->height, D->height );
+		} else {
+			B->child2 = iE;
+			A->child1 = iD;
+			D->parent = iA;
+			A->bounds = Union( C->bounds, D->bounds );
+			B->bounds = Union( A->bounds, E->bounds );
+
+			A->height = 1 + std::max( C->height, D->height );
+			B->height = 1 + std::max( A->height, E->height );
+		}
+		return iB;
+	}
+
+	return iA;
+}
\ No newline at end of file
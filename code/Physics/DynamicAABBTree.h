@@ -0,0 +1,158 @@
+//
+//	DynamicAABBTree.h
+//
+#pragma once
+#include "../Math/Vector.h"
+#include "../Math/Bounds.h"
+#include <vector>
+#include <assert.h>
+
+/*
+====================================================
+DynamicAABBTree
+
+Bounding volume hierarchy over "fat" bounds. Leaves store bounds padded by a
+margin plus the predicted motion, so a proxy only has to be re-inserted once
+its tight bounds escape the fat ones. Insertion picks the sibling that grows
+the total surface area the least, and every node on the way back up gets
+rotated if its children become unbalanced.
+====================================================
+*/
+class DynamicAABBTree {
+public:
+	static const int NULL_NODE = -1;
+
+	DynamicAABBTree();
+
+	int CreateProxy( const Bounds & bounds, const int userData );
+	void DestroyProxy( const int proxyId );
+	bool MoveProxy( const int proxyId, const Bounds & bounds, const Vec3 & displacement );
+	void Clear();
+
+	int GetUserData( const int proxyId ) const { return m_nodes[ proxyId ].userData; }
+	const Bounds & GetFatBounds( const int proxyId ) const { return m_nodes[ proxyId ].bounds; }
+	int GetHeight() const { return ( m_root == NULL_NODE ) ? 0 : m_nodes[ m_root ].height; }
+
+	// callback( userData ) -> return false to stop the query
+	template< typename callback_t >
+	void QueryBounds( const Bounds & bounds, callback_t && callback ) const;
+
+	// callback( userData, maxFraction ) -> returns the new max fraction along start->end, 0 stops the query
+	template< typename callback_t >
+	void RayCast( const Vec3 & start, const Vec3 & end, callback_t && callback ) const;
+
+	static bool RayBounds( const Vec3 & start, const Vec3 & invDir, const float maxT, const Bounds & bounds );
+	static bool Overlaps( const Bounds & a, const Bounds & b );
+
+private:
+	struct node_t {
+		Bounds bounds;
+		int parent;		// also the next free node, while this node is on the free list
+		int child1;
+		int child2;
+		int height;		// 0 for leaves, -1 for free nodes
+		int userData;
+
+		bool IsLeaf() const { return child1 == NULL_NODE; }
+	};
+
+	int AllocateNode();
+	void FreeNode( const int nodeId );
+
+	void InsertLeaf( const int leaf );
+	void RemoveLeaf( const int leaf );
+	int Balance( const int iA );
+
+	static Bounds Union( const Bounds & a, const Bounds & b );
+
+	static const int MAX_STACK = 256;
+
+	std::vector< node_t > m_nodes;
+	int m_root;
+	int m_freeList;
+};
+
+/*
+====================================================
+DynamicAABBTree::Overlaps
+
+same as Bounds::DoesIntersect, but visible to the compiler for inlining in the query loops
+====================================================
+*/
+inline bool DynamicAABBTree::Overlaps( const Bounds & a, const Bounds & b ) {
+	return	a.mins.x <= b.maxs.x && a.maxs.x >= b.mins.x &&
+			a.mins.y <= b.maxs.y && a.maxs.y >= b.mins.y &&
+			a.mins.z <= b.maxs.z && a.maxs.z >= b.mins.z;
+}
+
+/*
+====================================================
+DynamicAABBTree::QueryBounds
+====================================================
+*/
+template< typename callback_t >
+void DynamicAABBTree::QueryBounds( const Bounds & bounds, callback_t && callback ) const {
+	int stack[ MAX_STACK ];
+	int count = 0;
+	if ( m_root != NULL_NODE ) {
+		stack[ count++ ] = m_root;
+	}
+
+	while ( count > 0 ) {
+		const node_t & node = m_nodes[ stack[ --count ] ];
+		if ( !Overlaps( node.bounds, bounds ) ) {
+			continue;
+		}
+
+		if ( node.IsLeaf() ) {
+			if ( !callback( node.userData ) ) {
+				return;
+			}
+			continue;
+		}
+
+		assert( count + 2 <= MAX_STACK );
+		stack[ count++ ] = node.child1;
+		stack[ count++ ] = node.child2;
+	}
+}
+
+/*
+====================================================
+DynamicAABBTree::RayCast
+====================================================
+*/
+template< typename callback_t >
+void DynamicAABBTree::RayCast( const Vec3 & start, const Vec3 & end, callback_t && callback ) const {
+	const Vec3 dir = end - start;
+	const Vec3 invDir = Vec3( 1.0f / dir.x, 1.0f / dir.y, 1.0f / dir.z );
+	float maxFraction = 1.0f;
+
+	int stack[ MAX_STACK ];
+	int count = 0;
+	if ( m_root != NULL_NODE ) {
+		stack[ count++ ] = m_root;
+	}
+
+	while ( count > 0 ) {
+		const node_t & node = m_nodes[ stack[ --count ] ];
+		if ( !RayBounds( start, invDir, maxFraction, node.bounds ) ) {
+			continue;
+		}
+
+		if ( node.IsLeaf() ) {
+			const float fraction = callback( node.userData, maxFraction );
+			if ( fraction <= 0.0f ) {
+				return;
+			}
+			if ( fraction < maxFraction ) {
+				maxFraction = fraction;
+			}
+			continue;
+		}
+
+		assert( count + 2 <= MAX_STACK );
+		stack[ count++ ] = node.child1;
+		stack[ count++ ] = node.child2;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,77 @@
+//
+//	FrameArena.cpp
+//
+#include "FrameArena.h"
+#include <stdlib.h>
+#include <algorithm>
+
+// the first block, so small scenes never have to chain
+static const size_t MIN_BLOCK_SIZE = 64 * 1024;
+
+/*
+====================================================
+FrameArena::~FrameArena
+====================================================
+*/
+FrameArena::~FrameArena() {
+	for ( int i = 0; i < m_blocks.size(); i++ ) {
+		free( m_blocks[ i ].memory );
+	}
+}
+
+/*
+====================================================
+FrameArena::Reset
+
+if the last step had to chain blocks, swap them for one block that fits it
+====================================================
+*/
+void FrameArena::Reset() {
+	m_highWater = std::max( m_highWater, m_used );
+	m_used = 0;
+
+	if ( m_blocks.size() > 1 ) {
+		for ( int i = 0; i < m_blocks.size(); i++ ) {
+			free( m_blocks[ i ].memory );
+		}
+		m_blocks.clear();
+
+		// with a bit of slack, for alignment and steps that grow a little
+		block_t block;
+		block.size = m_highWater + m_highWater / 4;
+		block.memory = reinterpret_cast< uint8_t * >( malloc( block.size ) );
+		m_blocks.push_back( block );
+	}
+
+	if ( !m_blocks.empty() ) {
+		m_blocks.back().used = 0;
+	}
+}
+
+/*
+====================================================
+FrameArena::AllocBytes
+====================================================
+*/
+void * FrameArena::AllocBytes( const size_t bytes, const size_t alignment ) {
+	if ( !m_blocks.empty() ) {
+		block_t & block = m_blocks.back();
+		const uintptr_t address = reinterpret_cast< uintptr_t >( block.memory ) + block.used;
+		const size_t padding = ( alignment - address % alignment ) % alignment;
+		if ( block.used + padding + bytes <= block.size ) {
+			block.used += padding + bytes;
+			m_used += padding + bytes;
+			return block.memory + block.used - bytes;
+		}
+	}
+
+	// out of room, chain on a block at least as big as everything so far, so chains stay short.
+	// malloc's alignment covers everything we store in here
+	block_t block;
+	block.size = std::max( std::max( MIN_BLOCK_SIZE, bytes ), m_used );
+	block.memory = reinterpret_cast< uint8_t * >( malloc( block.size ) );
+	block.used = bytes;
+	m_blocks.push_back( block );
+	m_used += bytes;
+	return block.memory;
+}
\ No newline at end of file
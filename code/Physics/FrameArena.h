@@ -0,0 +1,103 @@
+//
+//	FrameArena.h
+//
+#pragma once
+#include <vector>
+#include <new>
+#include <type_traits>
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+====================================================
+span_t
+
+a typed run of memory the span doesn't own, e.g. scratch from a FrameArena
+====================================================
+*/
+template< typename T >
+struct span_t {
+	span_t() : data( nullptr ), count( 0 ) {}
+	span_t( T * data_, const int count_ ) : data( data_ ), count( count_ ) {}
+
+	T & operator[]( const int idx ) { assert( idx >= 0 && idx < count ); return data[ idx ]; }
+	const T & operator[]( const int idx ) const { assert( idx >= 0 && idx < count ); return data[ idx ]; }
+
+	T * begin() { return data; }
+	T * end() { return data + count; }
+	const T * begin() const { return data; }
+	const T * end() const { return data + count; }
+	int Size() const { return count; }
+
+	T * data;
+	int count;
+};
+
+/*
+====================================================
+FrameArena
+
+Linear allocator for the scratch memory of one physics step. Alloc just bumps
+a pointer, nothing is ever freed on its own, and Reset at the start of the
+next step hands everything back at once. When a step needs more than the
+current block it chains on another one ( earlier spans stay valid ), and the
+next Reset folds them into a single block big enough for the whole step, so
+after the first few steps there's no heap traffic at all.
+
+Only meant for the thread driving the step: carve out what the workers need
+before handing it to them. Nothing allocated from it gets destructed.
+====================================================
+*/
+class FrameArena {
+public:
+	FrameArena() : m_highWater( 0 ), m_used( 0 ) {}
+	~FrameArena();
+
+	FrameArena( const FrameArena & ) = delete;
+	FrameArena & operator = ( const FrameArena & ) = delete;
+
+	// invalidates every span handed out since the last Reset
+	void Reset();
+
+	// count default constructed Ts
+	template< typename T >
+	span_t< T > Alloc( const int count );
+
+	size_t GetUsed() const { return m_used; }
+	size_t GetHighWater() const { return m_highWater; }
+
+private:
+	void * AllocBytes( const size_t bytes, const size_t alignment );
+
+	struct block_t {
+		uint8_t * memory;
+		size_t size;
+		size_t used;
+	};
+
+	std::vector< block_t > m_blocks;	// the last one is being allocated from
+	size_t m_highWater;					// most used by a single step so far
+	size_t m_used;						// by this step
+};
+
+/*
+====================================================
+FrameArena::Alloc
+====================================================
+*/
+template< typename T >
+span_t< T > FrameArena::Alloc( const int count ) {
+	static_assert( std::is_trivially_destructible< T >::value, "FrameArena never runs destructors" );
+	if ( count <= 0 ) {
+		return span_t< T >();
+	}
+
+	T * data = reinterpret_cast< T * >( AllocBytes( sizeof( T ) * count, alignof( T ) ) );
+	if ( !std::is_trivially_default_constructible< T >::value ) {
+		for ( int i = 0; i < count; i++ ) {
+			new ( data + i ) T();
+		}
+	}
+	return span_t< T >( data, count );
+}
\ No newline at end of file
@@ -2,25 +2,819 @@
 //  GJK.cpp
 //
 #include "GJK.h"
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+
+/*
+================================================================================================
+
+Signed Volumes
+
+================================================================================================
+*/
 
 /*
 ================================
-GJK_DoesIntersect
+SignedVolume1D
+================================
+*/
+static Vec2 SignedVolume1D( const Vec3 & s1, const Vec3 & s2 ) {
+	const Vec3 ab = s2 - s1;	// ray from a to b
+	const Vec3 ap = Vec3( 0.0f ) - s1;	// ray from a to origin
+	const Vec3 p0 = s1 + ab * ab.Dot( ap ) / ab.GetLengthSqr();	// projection of the origin onto the line
+
+	// choose the axis with the greatest difference/length
+	int idx = 0;
+	float mu_max = 0;
+	for ( int i = 0; i < 3; i++ ) {
+		const float mu = s2[ i ] - s1[ i ];
+		if ( mu * mu > mu_max * mu_max ) {
+			mu_max = mu;
+			idx = i;
+		}
+	}
+
+	// project the simplex points and projected origin onto the axis with greatest length
+	const float a = s1[ idx ];
+	const float b = s2[ idx ];
+	const float p = p0[ idx ];
+
+	// get the signed distance from a to p and from p to b
+	const float C1 = p - a;
+	const float C2 = b - p;
+
+	// if p is between [a,b]
+	if ( ( p > a && p < b ) || ( p > b && p < a ) ) {
+		return Vec2( C2 / mu_max, C1 / mu_max );
+	}
+
+	// if p is on the far side of a
+	if ( ( a <= b && p <= a ) || ( a >= b && p >= a ) ) {
+		return Vec2( 1.0f, 0.0f );
+	}
+
+	// p must be on the far side of b
+	return Vec2( 0.0f, 1.0f );
+}
+
+/*
+================================
+CompareSigns
+================================
+*/
+static int CompareSigns( const float a, const float b ) {
+	if ( a > 0.0f && b > 0.0f ) {
+		return 1;
+	}
+	if ( a < 0.0f && b < 0.0f ) {
+		return 1;
+	}
+	return 0;
+}
+
+/*
+================================
+SignedVolume2D
+================================
+*/
+static Vec3 SignedVolume2D( const Vec3 & s1, const Vec3 & s2, const Vec3 & s3 ) {
+	const Vec3 normal = ( s2 - s1 ).Cross( s3 - s1 );
+	const Vec3 p0 = normal * s1.Dot( normal ) / normal.GetLengthSqr();
+
+	// find the axis with the greatest projected area
+	int idx = 0;
+	float area_max = 0;
+	for ( int i = 0; i < 3; i++ ) {
+		const int j = ( i + 1 ) % 3;
+		const int k = ( i + 2 ) % 3;
+
+		const Vec2 a = Vec2( s1[ j ], s1[ k ] );
+		const Vec2 b = Vec2( s2[ j ], s2[ k ] );
+		const Vec2 c = Vec2( s3[ j ], s3[ k ] );
+		const Vec2 ab = b - a;
+		const Vec2 ac = c - a;
+
+		const float area = ab.x * ac.y - ab.y * ac.x;
+		if ( area * area > area_max * area_max ) {
+			idx = i;
+			area_max = area;
+		}
+	}
+
+	// project onto the appropriate axis
+	const int x = ( idx + 1 ) % 3;
+	const int y = ( idx + 2 ) % 3;
+	Vec2 s[ 3 ];
+	s[ 0 ] = Vec2( s1[ x ], s1[ y ] );
+	s[ 1 ] = Vec2( s2[ x ], s2[ y ] );
+	s[ 2 ] = Vec2( s3[ x ], s3[ y ] );
+	const Vec2 p = Vec2( p0[ x ], p0[ y ] );
+
+	// get the sub-areas of the triangles formed from the projected origin and the edges
+	Vec3 areas;
+	for ( int i = 0; i < 3; i++ ) {
+		const int j = ( i + 1 ) % 3;
+		const int k = ( i + 2 ) % 3;
+
+		const Vec2 ab = s[ j ] - p;
+		const Vec2 ac = s[ k ] - p;
+
+		areas[ i ] = ab.x * ac.y - ab.y * ac.x;
+	}
+
+	// if the projected origin is inside the triangle, then return the barycentric points
+	if ( CompareSigns( area_max, areas[ 0 ] ) > 0 && CompareSigns( area_max, areas[ 1 ] ) > 0 && CompareSigns( area_max, areas[ 2 ] ) > 0 ) {
+		return areas / area_max;
+	}
+
+	// otherwise project onto the edges and take the closest point
+	const Vec3 edgesPts[ 3 ] = { s1, s2, s3 };
+	float dist = 1e10f;
+	Vec3 lambdas = Vec3( 1, 0, 0 );
+	for ( int i = 0; i < 3; i++ ) {
+		const int k = ( i + 1 ) % 3;
+		const int l = ( i + 2 ) % 3;
+
+		const Vec2 lambdaEdge = SignedVolume1D( edgesPts[ k ], edgesPts[ l ] );
+		const Vec3 pt = edgesPts[ k ] * lambdaEdge[ 0 ] + edgesPts[ l ] * lambdaEdge[ 1 ];
+		if ( pt.GetLengthSqr() < dist ) {
+			dist = pt.GetLengthSqr();
+			lambdas[ i ] = 0;
+			lambdas[ k ] = lambdaEdge[ 0 ];
+			lambdas[ l ] = lambdaEdge[ 1 ];
+		}
+	}
+
+	return lambdas;
+}
+
+/*
+================================
+SignedVolume3D
+================================
+*/
+static Vec4 SignedVolume3D( const Vec3 & s1, const Vec3 & s2, const Vec3 & s3, const Vec3 & s4 ) {
+	Mat4 M;
+	M.rows[ 0 ] = Vec4( s1.x, s2.x, s3.x, s4.x );
+	M.rows[ 1 ] = Vec4( s1.y, s2.y, s3.y, s4.y );
+	M.rows[ 2 ] = Vec4( s1.z, s2.z, s3.z, s4.z );
+	M.rows[ 3 ] = Vec4( 1.0f, 1.0f, 1.0f, 1.0f );
+
+	Vec4 C4;
+	C4[ 0 ] = M.Cofactor( 3, 0 );
+	C4[ 1 ] = M.Cofactor( 3, 1 );
+	C4[ 2 ] = M.Cofactor( 3, 2 );
+	C4[ 3 ] = M.Cofactor( 3, 3 );
+
+	const float detM = C4[ 0 ] + C4[ 1 ] + C4[ 2 ] + C4[ 3 ];
+
+	// if the barycentric coordinates put the origin inside the simplex, then return them
+	if ( CompareSigns( detM, C4[ 0 ] ) > 0 && CompareSigns( detM, C4[ 1 ] ) > 0 && CompareSigns( detM, C4[ 2 ] ) > 0 && CompareSigns( detM, C4[ 3 ] ) > 0 ) {
+		return C4 * ( 1.0f / detM );
+	}
+
+	// otherwise project the origin onto the faces and take the closest one
+	const Vec3 facePts[ 4 ] = { s1, s2, s3, s4 };
+	Vec4 lambdas;
+	float dist = 1e10f;
+	for ( int i = 0; i < 4; i++ ) {
+		const int j = ( i + 1 ) % 4;
+		const int k = ( i + 2 ) % 4;
+
+		const Vec3 lambdasFace = SignedVolume2D( facePts[ i ], facePts[ j ], facePts[ k ] );
+		const Vec3 pt = facePts[ i ] * lambdasFace[ 0 ] + facePts[ j ] * lambdasFace[ 1 ] + facePts[ k ] * lambdasFace[ 2 ];
+		if ( pt.GetLengthSqr() < dist ) {
+			dist = pt.GetLengthSqr();
+			lambdas.Zero();
+			lambdas[ i ] = lambdasFace[ 0 ];
+			lambdas[ j ] = lambdasFace[ 1 ];
+			lambdas[ k ] = lambdasFace[ 2 ];
+		}
+	}
+
+	return lambdas;
+}
+
+/*
+================================================================================================
+
+Gilbert Johnson Keerthi
+
+================================================================================================
+*/
+
+struct point_t {
+	Vec3 xyz;	// the point on the minkowski sum
+	Vec3 ptA;	// the point on bodyA
+	Vec3 ptB;	// the point on bodyB
+	Vec3 dir;	// the direction it was found along, for warm starting the next query
+
+	point_t() : xyz( 0.0f ), ptA( 0.0f ), ptB( 0.0f ), dir( 0.0f ) {}
+};
+
+/*
+================================
+Support
 ================================
 */
-bool GJK_DoesIntersect( const Body * bodyA, const Body * bodyB ) {
-	// TODO: Add code
+static point_t Support( const Body & bodyA, const Body & bodyB, Vec3 dir, const float bias ) {
+	dir.Normalize();
 
+	point_t point;
+	point.dir = dir;
+
+	// find the point in A furthest in direction
+	point.ptA = bodyA.GetShape()->Support( dir, bodyA.GetPosition(), bodyA.GetOrientation(), bias );
+
+	dir *= -1.0f;
+
+	// find the point in B furthest in the opposite direction
+	point.ptB = bodyB.GetShape()->Support( dir, bodyB.GetPosition(), bodyB.GetOrientation(), bias );
+
+	// return the point, in the minkowski sum, furthest in the direction
+	point.xyz = point.ptA - point.ptB;
+	return point;
+}
+
+/*
+================================
+SimplexSignedVolumes
+
+Projects the origin onto the simplex to acquire the new search direction,
+also checks if the origin is "inside" the simplex.
+================================
+*/
+static bool SimplexSignedVolumes( const point_t * pts, const int num, Vec3 & newDir, Vec4 & lambdasOut ) {
+	const float epsilonf = 0.0001f * 0.0001f;
+	lambdasOut.Zero();
+
+	switch ( num ) {
+		default:
+		case 2: {
+			const Vec2 lambdas = SignedVolume1D( pts[ 0 ].xyz, pts[ 1 ].xyz );
+			lambdasOut[ 0 ] = lambdas[ 0 ];
+			lambdasOut[ 1 ] = lambdas[ 1 ];
+		} break;
+		case 3: {
+			const Vec3 lambdas = SignedVolume2D( pts[ 0 ].xyz, pts[ 1 ].xyz, pts[ 2 ].xyz );
+			lambdasOut[ 0 ] = lambdas[ 0 ];
+			lambdasOut[ 1 ] = lambdas[ 1 ];
+			lambdasOut[ 2 ] = lambdas[ 2 ];
+		} break;
+		case 4: {
+			lambdasOut = SignedVolume3D( pts[ 0 ].xyz, pts[ 1 ].xyz, pts[ 2 ].xyz, pts[ 3 ].xyz );
+		} break;
+	};
+
+	Vec3 v( 0.0f );
+	for ( int i = 0; i < num; i++ ) {
+		v += pts[ i ].xyz * lambdasOut[ i ];
+	}
+	newDir = v * -1.0f;
+	return ( v.GetLengthSqr() < epsilonf );
+}
+
+/*
+================================
+HasPoint
+
+Checks whether the new point already exists in the simplex
+================================
+*/
+static bool HasPoint( const point_t * simplexPoints, const int num, const point_t & newPt ) {
+	const float precision = 1e-6f;
+
+	for ( int i = 0; i < num; i++ ) {
+		const Vec3 delta = simplexPoints[ i ].xyz - newPt.xyz;
+		if ( delta.GetLengthSqr() < precision * precision ) {
+			return true;
+		}
+	}
 	return false;
 }
 
+/*
+================================
+SortValids
+
+Moves the support points with a non zero lambda to the front of the simplex,
+and returns how many of them there are
+================================
+*/
+static int SortValids( point_t simplexPoints[ 4 ], Vec4 & lambdas ) {
+	int validCount = 0;
+	for ( int i = 0; i < 4; i++ ) {
+		if ( 0.0f == lambdas[ i ] ) {
+			continue;
+		}
+		simplexPoints[ validCount ] = simplexPoints[ i ];
+		lambdas[ validCount ] = lambdas[ i ];
+		validCount++;
+	}
+	for ( int i = validCount; i < 4; i++ ) {
+		lambdas[ i ] = 0.0f;
+	}
+	return validCount;
+}
+
+/*
+================================
+GJK_Simplex
+
+Runs GJK until the simplex contains the origin ( returns true ), or the
+search can't get any closer to it ( returns false ). With a cache it starts
+from the simplex the last query ended on, or answers straight away when the
+last query's separating axis still separates the shapes, and leaves the cache
+set up for the next query.
+================================
+*/
+static bool GJK_Simplex( const Body & bodyA, const Body & bodyB, point_t simplexPoints[ 4 ], int & numPts, gjkCache_t * cache, gjkStats_t * stats ) {
+	int numIterations = 0;
+	numPts = 0;
+
+	// the cached directions find the same features again as long as the bodies haven't moved much
+	if ( nullptr != cache && cache->numDirs > 0 ) {
+		for ( int i = 0; i < cache->numDirs; i++ ) {
+			const point_t pt = Support( bodyA, bodyB, cache->dirs[ i ], 0.0f );
+			if ( !HasPoint( simplexPoints, numPts, pt ) ) {
+				simplexPoints[ numPts ] = pt;
+				numPts++;
+			}
+		}
+		numIterations++;
+
+		// no point of the CSO is past the origin along the old axis, so it still can't contain the origin
+		if ( cache->isSeparated && simplexPoints[ 0 ].dir.Dot( simplexPoints[ 0 ].xyz ) < 0.0f ) {
+			if ( nullptr != stats ) {
+				stats->numQueries++;
+				stats->numIterations += numIterations;
+				stats->numEarlyOuts++;
+			}
+			return false;
+		}
+	}
+	if ( 0 == numPts ) {
+		simplexPoints[ 0 ] = Support( bodyA, bodyB, Vec3( 1, 1, 1 ), 0.0f );
+		numPts = 1;
+		numIterations++;
+	}
+
+	bool doesContainOrigin = false;
+	Vec3 newDir = simplexPoints[ 0 ].xyz * -1.0f;
+	if ( numPts > 1 ) {
+		// project the origin onto the warm start simplex, the same as for a new point below
+		Vec4 lambdas;
+		doesContainOrigin = SimplexSignedVolumes( simplexPoints, numPts, newDir, lambdas );
+		if ( !doesContainOrigin ) {
+			numPts = SortValids( simplexPoints, lambdas );
+			doesContainOrigin = ( 4 == numPts );
+		}
+	}
+
+	float closestDist = 1e10f;
+	while ( !doesContainOrigin ) {
+		// get the new point to check on
+		const point_t newPt = Support( bodyA, bodyB, newDir, 0.0f );
+		numIterations++;
+
+		// if the new point is the same as a previous point, then we can't expand any further
+		if ( HasPoint( simplexPoints, numPts, newPt ) ) {
+			break;
+		}
+
+		simplexPoints[ numPts ] = newPt;
+		numPts++;
+
+		// if this new point hasn't moved passed the origin, then the
+		// origin cannot be in the set. And therefore there is no collision.
+		if ( newDir.Dot( newPt.xyz ) < 0.0f ) {
+			break;
+		}
+
+		Vec4 lambdas;
+		doesContainOrigin = SimplexSignedVolumes( simplexPoints, numPts, newDir, lambdas );
+		if ( doesContainOrigin ) {
+			break;
+		}
+
+		// check that the new projection of the origin onto the simplex is closer than the previous
+		const float dist = newDir.GetLengthSqr();
+		if ( dist >= closestDist ) {
+			break;
+		}
+		closestDist = dist;
+
+		// use the lambdas that support the new search direction, and invalidate any points that don't support it
+		numPts = SortValids( simplexPoints, lambdas );
+		doesContainOrigin = ( 4 == numPts );
+	}
+
+	if ( nullptr != cache ) {
+		// a touching pair keeps its simplex, a separate one the last search direction.
+		// any direction makes a sound axis to try, the early out checks it before trusting it
+		cache->isSeparated = !doesContainOrigin;
+		cache->numDirs = doesContainOrigin ? numPts : 1;
+		for ( int i = 0; i < numPts && doesContainOrigin; i++ ) {
+			cache->dirs[ i ] = simplexPoints[ i ].dir;
+		}
+		if ( !doesContainOrigin ) {
+			cache->dirs[ 0 ] = newDir;
+			if ( newDir.GetLengthSqr() < 1e-12f ) {
+				cache->numDirs = 0;
+			}
+		}
+	}
+	if ( nullptr != stats ) {
+		stats->numQueries++;
+		stats->numIterations += numIterations;
+	}
+	return doesContainOrigin;
+}
+
+/*
+================================
+GJK_DoesIntersect
+================================
+*/
+bool GJK_DoesIntersect( const Body & bodyA, const Body & bodyB, gjkCache_t * cache, gjkStats_t * stats ) {
+	int numPts = 0;
+	point_t simplexPoints[ 4 ];
+	return GJK_Simplex( bodyA, bodyB, simplexPoints, numPts, cache, stats );
+}
+
 /*
 ================================
 GJK_ClosestPoints
 ================================
 */
-void GJK_ClosestPoints( const Body * bodyA, const Body * bodyB, Vec3 & ptOnA, Vec3 & ptOnB ) {
-	// TODO: Add code
+void GJK_ClosestPoints( const Body & bodyA, const Body & bodyB, Vec3 & ptOnA, Vec3 & ptOnB ) {
+	float closestDist = 1e10f;
+	const float bias = 0.0f;
+
+	int numPts = 1;
+	point_t simplexPoints[ 4 ];
+	simplexPoints[ 0 ] = Support( bodyA, bodyB, Vec3( 1, 1, 1 ), bias );
+
+	Vec4 lambdas = Vec4( 1, 0, 0, 0 );
+	Vec3 newDir = simplexPoints[ 0 ].xyz * -1.0f;
+	do {
+		// get the new point to check on
+		const point_t newPt = Support( bodyA, bodyB, newDir, bias );
+
+		// if the new point is the same as a previous point, then we can't expand any further
+		if ( HasPoint( simplexPoints, numPts, newPt ) ) {
+			break;
+		}
+
+		// add point and get new search direction
+		simplexPoints[ numPts ] = newPt;
+		numPts++;
+
+		SimplexSignedVolumes( simplexPoints, numPts, newDir, lambdas );
+		numPts = SortValids( simplexPoints, lambdas );
+
+		// check that the new projection of the origin onto the simplex is closer than the previous
+		const float dist = newDir.GetLengthSqr();
+		if ( dist >= closestDist ) {
+			break;
+		}
+		closestDist = dist;
+	} while ( numPts < 4 );
+
+	ptOnA.Zero();
+	ptOnB.Zero();
+	for ( int i = 0; i < numPts; i++ ) {
+		ptOnA += simplexPoints[ i ].ptA * lambdas[ i ];
+		ptOnB += simplexPoints[ i ].ptB * lambdas[ i ];
+	}
+}
+
+/*
+================================================================================================
+
+Expanding Polytope Algorithm
+
+================================================================================================
+*/
+
+// the polytope lives in fixed size buffers on the stack, so a query never touches the heap.
+// if the expansion would overflow one of them it stops there, and answers with the closest face so far
+static constexpr int EPA_MAX_POINTS = 128;
+static constexpr int EPA_MAX_FACES = 2 * EPA_MAX_POINTS;	// a closed triangle mesh of v points has 2v - 4 faces
+static constexpr int EPA_MAX_HORIZON = EPA_MAX_POINTS;
+static constexpr int EPA_MAX_HEAP = 2 * EPA_MAX_FACES;
+// the expansion stops once the support point is no further than this past the closest face
+static constexpr float EPA_TOLERANCE = 1e-4f;
+
+struct epaFace_t {
+	int a, b, c;	// counter clockwise, seen from outside the polytope
+	Vec3 normal;
+	float dist;		// distance of the plane from the origin
+	int serial;		// bumped every time the slot is reused, to spot stale heap entries
+	bool alive;
+};
+
+struct epaHeapEntry_t {
+	float dist;
+	int face;
+	int serial;
+
+	// std::push_heap builds a max heap, so invert it to pop the closest face first
+	bool operator < ( const epaHeapEntry_t & rhs ) const { return dist > rhs.dist; }
+};
+
+struct epaPolytope_t {
+	point_t points[ EPA_MAX_POINTS ];
+	epaFace_t faces[ EPA_MAX_FACES ];
+	int liveFaces[ EPA_MAX_FACES ];		// compact list of the live faces
+	int freeFaces[ EPA_MAX_FACES ];		// slots of dead faces, reused before growing numFaces
+	epaHeapEntry_t heap[ EPA_MAX_HEAP ];
+	int numPoints;
+	int numFaces;
+	int numLive;
+	int numFree;
+	int numHeap;
+};
+
+/*
+================================
+BarycentricCoordinates
+
+This borrows our signed volume code to perform the barycentric coordinates.
+================================
+*/
+static Vec3 BarycentricCoordinates( Vec3 s1, Vec3 s2, Vec3 s3, const Vec3 & pt ) {
+	s1 = s1 - pt;
+	s2 = s2 - pt;
+	s3 = s3 - pt;
+
+	const Vec3 normal = ( s2 - s1 ).Cross( s3 - s1 );
+	const Vec3 p0 = normal * s1.Dot( normal ) / normal.GetLengthSqr();
+
+	// find the axis with the greatest projected area
+	int idx = 0;
+	float area_max = 0;
+	for ( int i = 0; i < 3; i++ ) {
+		const int j = ( i + 1 ) % 3;
+		const int k = ( i + 2 ) % 3;
+
+		const Vec2 a = Vec2( s1[ j ], s1[ k ] );
+		const Vec2 b = Vec2( s2[ j ], s2[ k ] );
+		const Vec2 c = Vec2( s3[ j ], s3[ k ] );
+		const Vec2 ab = b - a;
+		const Vec2 ac = c - a;
+
+		const float area = ab.x * ac.y - ab.y * ac.x;
+		if ( area * area > area_max * area_max ) {
+			idx = i;
+			area_max = area;
+		}
+	}
+
+	// project onto the appropriate axis
+	const int x = ( idx + 1 ) % 3;
+	const int y = ( idx + 2 ) % 3;
+	Vec2 s[ 3 ];
+	s[ 0 ] = Vec2( s1[ x ], s1[ y ] );
+	s[ 1 ] = Vec2( s2[ x ], s2[ y ] );
+	s[ 2 ] = Vec2( s3[ x ], s3[ y ] );
+	const Vec2 p = Vec2( p0[ x ], p0[ y ] );
+
+	// get the sub-areas of the triangles formed from the projected origin and the edges
+	Vec3 areas;
+	for ( int i = 0; i < 3; i++ ) {
+		const int j = ( i + 1 ) % 3;
+		const int k = ( i + 2 ) % 3;
+
+		const Vec2 ab = s[ j ] - p;
+		const Vec2 ac = s[ k ] - p;
+
+		areas[ i ] = ab.x * ac.y - ab.y * ac.x;
+	}
+
+	Vec3 lambdas = areas / area_max;
+	if ( !lambdas.IsValid() ) {
+		lambdas = Vec3( 1, 0, 0 );
+	}
+	return lambdas;
+}
+
+/*
+================================
+EPA_AddFace
+
+Adds the triangle to the polytope and queues it by its distance from the origin.
+Returns false when the polytope is out of face slots.
+================================
+*/
+static bool EPA_AddFace( epaPolytope_t & poly, const int a, const int b, const int c ) {
+	int idx;
+	if ( poly.numFree > 0 ) {
+		idx = poly.freeFaces[ --poly.numFree ];
+	} else if ( poly.numFaces < EPA_MAX_FACES ) {
+		idx = poly.numFaces++;
+		poly.faces[ idx ].serial = 0;
+	} else {
+		return false;
+	}
+
+	epaFace_t & face = poly.faces[ idx ];
+	face.a = a;
+	face.b = b;
+	face.c = c;
+	face.serial++;
+	face.alive = true;
+
+	const Vec3 & ptA = poly.points[ a ].xyz;
+	face.normal = ( poly.points[ b ].xyz - ptA ).Cross( poly.points[ c ].xyz - ptA );
+	const float lengthSqr = face.normal.GetLengthSqr();
+	if ( lengthSqr > 1e-12f ) {
+		face.normal /= sqrtf( lengthSqr );
+		face.dist = face.normal.Dot( ptA );
+	} else {
+		// a sliver, keep it in the mesh but never expand through it
+		face.dist = 1e10f;
+	}
+	poly.liveFaces[ poly.numLive++ ] = idx;
+
+	// the heap only ever holds entries for faces created since the last rebuild,
+	// when it fills up throw away the stale entries by rebuilding it from the live faces
+	if ( poly.numHeap == EPA_MAX_HEAP ) {
+		poly.numHeap = 0;
+		for ( int i = 0; i < poly.numLive; i++ ) {
+			const epaFace_t & live = poly.faces[ poly.liveFaces[ i ] ];
+			poly.heap[ poly.numHeap++ ] = { live.dist, poly.liveFaces[ i ], live.serial };
+		}
+		std::make_heap( poly.heap, poly.heap + poly.numHeap );
+	} else {
+		poly.heap[ poly.numHeap++ ] = { face.dist, idx, face.serial };
+		std::push_heap( poly.heap, poly.heap + poly.numHeap );
+	}
+	return true;
+}
+
+/*
+================================
+EPA_PopClosestFace
+
+Returns the live face closest to the origin, skipping heap entries of faces that have been removed
+================================
+*/
+static int EPA_PopClosestFace( epaPolytope_t & poly ) {
+	while ( poly.numHeap > 0 ) {
+		std::pop_heap( poly.heap, poly.heap + poly.numHeap );
+		const epaHeapEntry_t & entry = poly.heap[ --poly.numHeap ];
+		const epaFace_t & face = poly.faces[ entry.face ];
+		if ( face.alive && face.serial == entry.serial ) {
+			return entry.face;
+		}
+	}
+	return -1;
+}
+
+/*
+================================
+EPA_Expand
+================================
+*/
+static float EPA_Expand( const Body & bodyA, const Body & bodyB, const float bias, const point_t simplexPoints[ 4 ], Vec3 & ptOnA, Vec3 & ptOnB ) {
+	epaPolytope_t poly;
+	poly.numPoints = 4;
+	poly.numFaces = 0;
+	poly.numLive = 0;
+	poly.numFree = 0;
+	poly.numHeap = 0;
+
+	Vec3 center( 0.0f );
+	for ( int i = 0; i < 4; i++ ) {
+		poly.points[ i ] = simplexPoints[ i ];
+		center += simplexPoints[ i ].xyz;
+	}
+	center *= 0.25f;
+
+	// build the tetrahedron, with every face wound to point away from the unused point
+	for ( int i = 0; i < 4; i++ ) {
+		int a = i;
+		int b = ( i + 1 ) % 4;
+		const int c = ( i + 2 ) % 4;
+		const Vec3 & unusedPt = poly.points[ ( i + 3 ) % 4 ].xyz;
+
+		const Vec3 & ptA = poly.points[ a ].xyz;
+		const Vec3 normal = ( poly.points[ b ].xyz - ptA ).Cross( poly.points[ c ].xyz - ptA );
+		if ( normal.Dot( unusedPt - ptA ) > 0.0f ) {
+			std::swap( a, b );
+		}
+		EPA_AddFace( poly, a, b, c );
+	}
+
+	//
+	//	Expand the polytope towards the closest face of the CSO to the origin
+	//
+	int closest = EPA_PopClosestFace( poly );
+	while ( closest >= 0 && poly.numPoints < EPA_MAX_POINTS ) {
+		const epaFace_t & closestFace = poly.faces[ closest ];
+		const point_t newPt = Support( bodyA, bodyB, closestFace.normal, bias );
+
+		// stop once the CSO doesn't reach meaningfully past the closest face
+		if ( closestFace.normal.Dot( newPt.xyz ) - closestFace.dist < EPA_TOLERANCE ) {
+			break;
+		}
+
+		// if w already exists, then we can't expand any further
+		bool hasPoint = false;
+		for ( int i = 0; i < poly.numPoints && !hasPoint; i++ ) {
+			hasPoint = ( newPt.xyz - poly.points[ i ].xyz ).GetLengthSqr() < 0.001f * 0.001f;
+		}
+		if ( hasPoint ) {
+			break;
+		}
+
+		// collect the faces that can see the new point, and the horizon around them.
+		// an edge shared by two visible faces shows up once in each winding, and cancels out.
+		int visible[ EPA_MAX_FACES ];
+		int numVisible = 0;
+		int horizon[ EPA_MAX_HORIZON ][ 2 ];
+		int numHorizon = 0;
+		bool overflow = false;
+		for ( int i = 0; i < poly.numLive && !overflow; i++ ) {
+			const epaFace_t & face = poly.faces[ poly.liveFaces[ i ] ];
+			if ( face.normal.Dot( newPt.xyz - poly.points[ face.a ].xyz ) <= 0.0f ) {
+				continue;
+			}
+			visible[ numVisible++ ] = i;
+
+			const int edges[ 3 ][ 2 ] = { { face.a, face.b }, { face.b, face.c }, { face.c, face.a } };
+			for ( int e = 0; e < 3; e++ ) {
+				int shared = -1;
+				for ( int h = 0; h < numHorizon; h++ ) {
+					if ( horizon[ h ][ 0 ] == edges[ e ][ 1 ] && horizon[ h ][ 1 ] == edges[ e ][ 0 ] ) {
+						shared = h;
+						break;
+					}
+				}
+				if ( shared >= 0 ) {
+					numHorizon--;
+					horizon[ shared ][ 0 ] = horizon[ numHorizon ][ 0 ];
+					horizon[ shared ][ 1 ] = horizon[ numHorizon ][ 1 ];
+				} else if ( numHorizon < EPA_MAX_HORIZON ) {
+					horizon[ numHorizon ][ 0 ] = edges[ e ][ 0 ];
+					horizon[ numHorizon ][ 1 ] = edges[ e ][ 1 ];
+					numHorizon++;
+				} else {
+					overflow = true;
+				}
+			}
+		}
+
+		// the new faces replace the visible ones, make sure they fit before touching the polytope
+		const int slotsLeft = poly.numFree + numVisible + ( EPA_MAX_FACES - poly.numFaces );
+		if ( overflow || 0 == numVisible || numHorizon < 3 || numHorizon > slotsLeft ) {
+			break;
+		}
+
+		// remove the visible faces, back to front so the swaps don't move one still to be removed
+		for ( int i = numVisible - 1; i >= 0; i-- ) {
+			const int idx = poly.liveFaces[ visible[ i ] ];
+			poly.faces[ idx ].alive = false;
+			poly.freeFaces[ poly.numFree++ ] = idx;
+			poly.liveFaces[ visible[ i ] ] = poly.liveFaces[ --poly.numLive ];
+		}
+
+		// the horizon edges keep the winding of the faces they came from,
+		// so fanning them out to the new point keeps the new faces pointing outward
+		const int newIdx = poly.numPoints++;
+		poly.points[ newIdx ] = newPt;
+		for ( int h = 0; h < numHorizon; h++ ) {
+			EPA_AddFace( poly, horizon[ h ][ 0 ], horizon[ h ][ 1 ], newIdx );
+		}
+
+		closest = EPA_PopClosestFace( poly );
+	}
+
+	if ( closest < 0 ) {
+		ptOnA = simplexPoints[ 0 ].ptA;
+		ptOnB = simplexPoints[ 0 ].ptB;
+		return 0.0f;
+	}
+
+	// get the projection of the origin on the closest triangle
+	const epaFace_t & tri = poly.faces[ closest ];
+	const point_t & ptA = poly.points[ tri.a ];
+	const point_t & ptB = poly.points[ tri.b ];
+	const point_t & ptC = poly.points[ tri.c ];
+	const Vec3 lambdas = BarycentricCoordinates( ptA.xyz, ptB.xyz, ptC.xyz, Vec3( 0.0f ) );
+
+	// get the point on shape A
+	ptOnA = ptA.ptA * lambdas[ 0 ] + ptB.ptA * lambdas[ 1 ] + ptC.ptA * lambdas[ 2 ];
+
+	// get the point on shape B
+	ptOnB = ptA.ptB * lambdas[ 0 ] + ptB.ptB * lambdas[ 1 ] + ptC.ptB * lambdas[ 2 ];
+
+	// return the penetration distance
+	const Vec3 delta = ptOnB - ptOnA;
+	return delta.GetMagnitude();
 }
 
 /*
@@ -28,8 +822,274 @@ void GJK_ClosestPoints( const Body * bodyA, const Body * bodyB, Vec3 & ptOnA, Ve
 GJK_DoesIntersect
 ================================
 */
-bool GJK_DoesIntersect( const Body * bodyA, const Body * bodyB, const float bias, Vec3 & ptOnA, Vec3 & ptOnB ) {
-	// TODO: Add code
+bool GJK_DoesIntersect( const Body & bodyA, const Body & bodyB, const float bias, Vec3 & ptOnA, Vec3 & ptOnB, gjkCache_t * cache, gjkStats_t * stats ) {
+	int numPts = 0;
+	point_t simplexPoints[ 4 ];
+	if ( !GJK_Simplex( bodyA, bodyB, simplexPoints, numPts, cache, stats ) ) {
+		return false;
+	}
 
-	return false;
+	//
+	//	Check that we have a 3-simplex (EPA expects a tetrahedron)
+	//
+	if ( 1 == numPts ) {
+		const Vec3 searchDir = simplexPoints[ 0 ].xyz * -1.0f;
+		simplexPoints[ numPts ] = Support( bodyA, bodyB, searchDir, 0.0f );
+		numPts++;
+	}
+	if ( 2 == numPts ) {
+		const Vec3 ab = simplexPoints[ 1 ].xyz - simplexPoints[ 0 ].xyz;
+		Vec3 u, v;
+		ab.GetOrtho( u, v );
+
+		simplexPoints[ numPts ] = Support( bodyA, bodyB, u, 0.0f );
+		numPts++;
+	}
+	if ( 3 == numPts ) {
+		const Vec3 ab = simplexPoints[ 1 ].xyz - simplexPoints[ 0 ].xyz;
+		const Vec3 ac = simplexPoints[ 2 ].xyz - simplexPoints[ 0 ].xyz;
+		const Vec3 norm = ab.Cross( ac );
+
+		simplexPoints[ numPts ] = Support( bodyA, bodyB, norm, 0.0f );
+		numPts++;
+	}
+
+	//
+	// Expand the simplex by the bias amount
+	//
+
+	// get the center point of the simplex
+	Vec3 avg = Vec3( 0, 0, 0 );
+	for ( int i = 0; i < 4; i++ ) {
+		avg += simplexPoints[ i ].xyz;
+	}
+	avg *= 0.25f;
+
+	// now expand the simplex by the bias amount
+	for ( int i = 0; i < numPts; i++ ) {
+		point_t & pt = simplexPoints[ i ];
+
+		Vec3 dir = pt.xyz - avg;	// ray from "center" to witness point
+		dir.Normalize();
+		pt.ptA += dir * bias;
+		pt.ptB -= dir * bias;
+		pt.xyz = pt.ptA - pt.ptB;
+	}
+
+	//
+	// Perform EPA expansion of the simplex to find the closest face on the CSO
+	//
+	EPA_Expand( bodyA, bodyB, bias, simplexPoints, ptOnA, ptOnB );
+	return true;
+}
+
+/*
+================================================================================================
+
+GJK Cache
+
+================================================================================================
+*/
+
+/*
+================================
+GJKCacheTable::FindOrAdd
+
+a slot that got reused by another body keeps the old body's cache, that's
+harmless, a cache is only ever a starting guess that GJK checks
+================================
+*/
+int GJKCacheTable::FindOrAdd( const Body & bodyA, const Body & bodyB ) {
+	const uint64_t key = PairTable::PairKey( bodyA, bodyB );
+	const uint32_t slotA = bodyA.GetHandle().slot;
+
+	int idx = m_pairs.Find( key );
+	if ( idx < 0 ) {
+		idx = m_pairs.Add( key );
+
+		entry_t entry;
+		entry.slotA = slotA;
+		m_entries.push_back( entry );
+	}
+
+	// the directions are for bodyA - bodyB, they flip when the bodies come in the other way around
+	entry_t & entry = m_entries[ idx ];
+	if ( entry.slotA != slotA ) {
+		for ( int i = 0; i < entry.cache.numDirs; i++ ) {
+			entry.cache.dirs[ i ] *= -1.0f;
+		}
+		entry.slotA = slotA;
+	}
+	entry.isUsed = true;
+	return idx;
+}
+
+/*
+================================
+GJKCacheTable::RemoveUnused
+================================
+*/
+void GJKCacheTable::RemoveUnused() {
+	// back to front, so whatever gets swapped into a hole has already been looked at
+	for ( int i = static_cast< int >( m_entries.size() ) - 1; i >= 0; i-- ) {
+		if ( m_entries[ i ].isUsed ) {
+			m_entries[ i ].isUsed = false;
+			continue;
+		}
+
+		m_pairs.Remove( i );
+		m_entries[ i ] = m_entries.back();
+		m_entries.pop_back();
+	}
+}
+
+/*
+================================
+GJKCacheTable::Clear
+================================
+*/
+void GJKCacheTable::Clear() {
+	m_pairs.Clear();
+	m_entries.clear();
+}
+
+/*
+====================================================
+BenchmarkGJK
+====================================================
+*/
+void BenchmarkGJK( const int numHulls, const int numPairs, const int numRuns ) {
+	const int numCloudPts = 256;
+	const int numDirs = 10000;
+	typedef std::chrono::high_resolution_clock clock_t;
+
+	// points on random ellipsoids, so nearly all of them end up on the hull and there's a real graph to climb
+	srand( 1234 );
+	auto random = []( const float range ) { return ( float( rand() ) / float( RAND_MAX ) * 2.0f - 1.0f ) * range; };
+	std::vector< Vec3 > cloud( numCloudPts );
+	std::vector< ShapeConvex * > hulls;
+	hulls.reserve( numHulls );
+	int numHullPts = 0;
+	double buildSec = 0.0;
+	for ( int h = 0; h < numHulls; h++ ) {
+		const Vec3 extents( 1.0f + random( 0.5f ), 1.0f + random( 0.5f ), 1.0f + random( 0.5f ) );
+		for ( int i = 0; i < numCloudPts; i++ ) {
+			Vec3 pt( random( 1.0f ), random( 1.0f ), random( 1.0f ) );
+			pt.Normalize();
+			cloud[ i ] = Vec3( pt.x * extents.x, pt.y * extents.y, pt.z * extents.z );
+		}
+
+		const clock_t::time_point start = clock_t::now();
+		hulls.push_back( new ShapeConvex( cloud.data(), numCloudPts ) );
+		buildSec += std::chrono::duration< double >( clock_t::now() - start ).count();
+		numHullPts += (int)hulls.back()->m_points.size();
+	}
+
+	// the same directions down both support paths, the climb walks from one to the next like it would from step to step
+	std::vector< Vec3 > dirs( numDirs );
+	for ( int i = 0; i < numDirs; i++ ) {
+		dirs[ i ] = Vec3( random( 1.0f ), random( 1.0f ), random( 1.0f ) );
+		dirs[ i ].Normalize();
+	}
+	std::vector< int > climbed( numHulls * numDirs );
+	const clock_t::time_point climbStart = clock_t::now();
+	for ( int h = 0; h < numHulls; h++ ) {
+		for ( int i = 0; i < numDirs; i++ ) {
+			climbed[ h * numDirs + i ] = hulls[ h ]->FindSupportPoint( dirs[ i ] );
+		}
+	}
+	const clock_t::time_point climbEnd = clock_t::now();
+
+	std::vector< int > scanned( numHulls * numDirs );
+	const clock_t::time_point scanStart = clock_t::now();
+	for ( int h = 0; h < numHulls; h++ ) {
+		for ( int i = 0; i < numDirs; i++ ) {
+			scanned[ h * numDirs + i ] = hulls[ h ]->FindSupportPointLinear( dirs[ i ] );
+		}
+	}
+	const clock_t::time_point scanEnd = clock_t::now();
+
+	int numSupportMismatches = 0;
+	for ( int h = 0; h < numHulls; h++ ) {
+		const std::vector< Vec3 > & pts = hulls[ h ]->m_points;
+		for ( int i = 0; i < numDirs; i++ ) {
+			const float climbDist = dirs[ i ].Dot( pts[ climbed[ h * numDirs + i ] ] );
+			const float scanDist = dirs[ i ].Dot( pts[ scanned[ h * numDirs + i ] ] );
+			if ( scanDist - climbDist > 1e-5f ) {
+				numSupportMismatches++;
+			}
+		}
+	}
+
+	// pairs close enough that about a quarter of them touch, drifting a little each run like they would from step to step
+	BodyStore bodies;
+	std::vector< Vec3 > basePositions;
+	std::vector< Vec3 > drifts;
+	std::vector< Vec3 > spinAxes;
+	for ( int i = 0; i < numPairs * 2; i++ ) {
+		Vec3 position( random( 100.0f ), random( 100.0f ), random( 100.0f ) );
+		if ( i & 1 ) {
+			position = basePositions[ i - 1 ] + Vec3( random( 2.5f ), random( 2.5f ), random( 2.5f ) );
+		}
+		basePositions.push_back( position );
+		drifts.push_back( Vec3( random( 0.5f ), random( 0.5f ), random( 0.5f ) ) );
+		spinAxes.push_back( Vec3( random( 1.0f ), random( 1.0f ), random( 1.0f ) ) );
+
+		bodyDesc_t body;
+		body.position = position;
+		body.invMass = 1.0f;
+		body.shape = hulls[ i % numHulls ];
+		bodies.Add( body );
+	}
+	auto placeBodies = [ & ]( const int run ) {
+		for ( int i = 0; i < bodies.Size(); i++ ) {
+			const float t = float( run ) / float( numRuns );
+			bodies.m_positions[ i ] = basePositions[ i ] + drifts[ i ] * t;
+			bodies.m_orientations[ i ] = Quat( spinAxes[ i ], 0.5f * t );
+		}
+	};
+
+	gjkStats_t coldStats;
+	std::vector< char > coldHits( numPairs * numRuns );
+	double coldSec = 0.0;
+	for ( int run = 0; run < numRuns; run++ ) {
+		placeBodies( run );
+		const clock_t::time_point start = clock_t::now();
+		for ( int i = 0; i < numPairs; i++ ) {
+			coldHits[ run * numPairs + i ] = GJK_DoesIntersect( bodies.GetBodyAt( i * 2 ), bodies.GetBodyAt( i * 2 + 1 ), nullptr, &coldStats );
+		}
+		coldSec += std::chrono::duration< double >( clock_t::now() - start ).count();
+	}
+
+	gjkStats_t warmStats;
+	std::vector< gjkCache_t > caches( numPairs );
+	int numHits = 0;
+	int numMismatches = 0;
+	double warmSec = 0.0;
+	for ( int run = 0; run < numRuns; run++ ) {
+		placeBodies( run );
+		const clock_t::time_point start = clock_t::now();
+		for ( int i = 0; i < numPairs; i++ ) {
+			const bool hit = GJK_DoesIntersect( bodies.GetBodyAt( i * 2 ), bodies.GetBodyAt( i * 2 + 1 ), &caches[ i ], &warmStats );
+			numHits += hit ? 1 : 0;
+			numMismatches += ( hit != ( coldHits[ run * numPairs + i ] != 0 ) ) ? 1 : 0;
+		}
+		warmSec += std::chrono::duration< double >( clock_t::now() - start ).count();
+	}
+
+	for ( int h = 0; h < numHulls; h++ ) {
+		delete hulls[ h ];
+	}
+
+	const double climbSec = std::chrono::duration< double >( climbEnd - climbStart ).count();
+	const double scanSec = std::chrono::duration< double >( scanEnd - scanStart ).count();
+	const double numSupports = double( numHulls ) * double( numDirs );
+	const double numQueries = double( numPairs ) * double( numRuns );
+	printf( "GJK benchmark, %i hulls of %i points, %i pairs x %i runs, %.1f%% touching\n", numHulls, numHullPts / numHulls, numPairs, numRuns, 100.0 * numHits / numQueries );
+	printf( "    ShapeConvex      %8.3f ms per hull\n", buildSec / numHulls * 1e3 );
+	printf( "    support scan     %8.2f M dirs/s\n", numSupports / scanSec * 1e-6 );
+	printf( "    support climb    %8.2f M dirs/s ( %.1fx ), %i dirs disagree\n", numSupports / climbSec * 1e-6, scanSec / climbSec, numSupportMismatches );
+	printf( "    GJK              %8.2f M pairs/s, %.2f iterations per query\n", numQueries / coldSec * 1e-6, coldStats.GetAverageIterations() );
+	printf( "    GJK cached       %8.2f M pairs/s ( %.1fx ), %.2f iterations per query, %.1f%% early outs\n", numQueries / warmSec * 1e-6, coldSec / warmSec, warmStats.GetAverageIterations(), 100.0 * warmStats.numEarlyOuts / std::max( 1, warmStats.numQueries ) );
+	printf( "    %i queries disagree on touching\n", numMismatches );
 }
\ No newline at end of file
@@ -8,7 +8,86 @@
 #include "../Math/Bounds.h"
 #include "Body.h"
 #include "Shapes.h"
+#include "PairTable.h"
+#include <vector>
 
-bool GJK_DoesIntersect( const Body * bodyA, const Body * bodyB );
-bool GJK_DoesIntersect( const Body * bodyA, const Body * bodyB, const float bias, Vec3 & ptOnA, Vec3 & ptOnB );
-void GJK_ClosestPoints( const Body * bodyA, const Body * bodyB, Vec3 & ptOnA, Vec3 & ptOnB );
+/*
+====================================================
+gjkCache_t
+
+what a GJK query leaves behind to warm start the next one on the same pair.
+the directions its last simplex was sampled along, rather than the points,
+so they're still good after the bodies have moved. for a pair that didn't
+touch it's the separating axis instead, one support point along it is
+usually enough to show the pair still doesn't touch
+====================================================
+*/
+struct gjkCache_t {
+	gjkCache_t() : numDirs( 0 ), isSeparated( false ) {}
+
+	Vec3	dirs[ 4 ];		// in the minkowski space of bodyA - bodyB
+	int		numDirs;
+	bool	isSeparated;	// dirs[ 0 ] is the separating axis
+};
+
+/*
+====================================================
+gjkStats_t
+====================================================
+*/
+struct gjkStats_t {
+	gjkStats_t() : numQueries( 0 ), numIterations( 0 ), numEarlyOuts( 0 ) {}
+
+	void Add( const gjkStats_t & rhs ) {
+		numQueries += rhs.numQueries;
+		numIterations += rhs.numIterations;
+		numEarlyOuts += rhs.numEarlyOuts;
+	}
+	float GetAverageIterations() const { return numQueries > 0 ? float( numIterations ) / float( numQueries ) : 0.0f; }
+
+	int		numQueries;
+	int		numIterations;	// support points taken, warm starting from a cached simplex counts as one
+	int		numEarlyOuts;	// queries answered by the cached separating axis alone
+};
+
+/*
+====================================================
+GJKCacheTable
+
+One gjkCache_t per pair of bodies the narrowphase runs GJK on, found through
+a PairTable the same way as the manifolds. Looking a pair up marks it as used,
+and RemoveUnused drops every pair that wasn't looked up since the last call,
+so pairs the broadphase stopped reporting don't pile up.
+====================================================
+*/
+class GJKCacheTable {
+public:
+	GJKCacheTable() {}
+
+	// the index of the pair's cache, oriented for bodyA first. not thread safe,
+	// look the pairs up first, then run the queries on their caches in parallel
+	int FindOrAdd( const Body & bodyA, const Body & bodyB );
+	gjkCache_t & Get( const int idx ) { return m_entries[ idx ].cache; }
+
+	void RemoveUnused();
+	void Clear();
+	int Size() const { return static_cast< int >( m_entries.size() ); }
+
+private:
+	struct entry_t {
+		gjkCache_t cache;
+		uint32_t slotA;		// the body the cache's directions treat as bodyA
+		bool isUsed;
+	};
+
+	PairTable m_pairs;		// index into m_entries of each pair
+	std::vector< entry_t > m_entries;
+};
+
+// the cache and stats are optional, with a cache the query starts from wherever the last one on the pair ended
+bool GJK_DoesIntersect( const Body & bodyA, const Body & bodyB, gjkCache_t * cache = nullptr, gjkStats_t * stats = nullptr );
+bool GJK_DoesIntersect( const Body & bodyA, const Body & bodyB, const float bias, Vec3 & ptOnA, Vec3 & ptOnB, gjkCache_t * cache = nullptr, gjkStats_t * stats = nullptr );
+void GJK_ClosestPoints( const Body & bodyA, const Body & bodyB, Vec3 & ptOnA, Vec3 & ptOnB );
+
+// times building hulls, the two ways of finding their support points, and GJK with and without the cache on convex pairs
+void BenchmarkGJK( const int numHulls, const int numPairs, const int numRuns );
@@ -0,0 +1,364 @@
+//
+//	Integrator.cpp
+//
+#include "Integrator.h"
+#include "Body.h"
+#include "Shapes.h"
+#include "../Math/Simd.h"
+#include "../Config.h"
+#include <algorithm>
+#include <chrono>
+#include <type_traits>
+#include <stdio.h>
+#include <stdlib.h>
+
+/*
+====================================================
+IntegrateLanes
+
+Body::Update for lane_t::WIDTH consecutive lanes ( or one, for floats ).
+returns false without touching anything if one of the lanes spins too fast
+for the polynomials, so the caller can redo them one at a time
+====================================================
+*/
+template< typename lane_t >
+static bool IntegrateLanes( float * const * streams, const int lane ) {
+	lane_t px, py, pz, qw, qx, qy, qz, vx, vy, vz, wx, wy, wz, cx, cy, cz;
+	lane_t ixx, ixy, ixz, iyy, iyz, izz;
+	lane_t invxx, invxy, invxz, invyy, invyz, invzz;
+	SimdLoad( px, streams[ BodyIntegrator::POS_X ] + lane );
+	SimdLoad( py, streams[ BodyIntegrator::POS_Y ] + lane );
+	SimdLoad( pz, streams[ BodyIntegrator::POS_Z ] + lane );
+	SimdLoad( qw, streams[ BodyIntegrator::ORIENT_W ] + lane );
+	SimdLoad( qx, streams[ BodyIntegrator::ORIENT_X ] + lane );
+	SimdLoad( qy, streams[ BodyIntegrator::ORIENT_Y ] + lane );
+	SimdLoad( qz, streams[ BodyIntegrator::ORIENT_Z ] + lane );
+	SimdLoad( vx, streams[ BodyIntegrator::LIN_VEL_X ] + lane );
+	SimdLoad( vy, streams[ BodyIntegrator::LIN_VEL_Y ] + lane );
+	SimdLoad( vz, streams[ BodyIntegrator::LIN_VEL_Z ] + lane );
+	SimdLoad( wx, streams[ BodyIntegrator::ANG_VEL_X ] + lane );
+	SimdLoad( wy, streams[ BodyIntegrator::ANG_VEL_Y ] + lane );
+	SimdLoad( wz, streams[ BodyIntegrator::ANG_VEL_Z ] + lane );
+	SimdLoad( cx, streams[ BodyIntegrator::COM_X ] + lane );
+	SimdLoad( cy, streams[ BodyIntegrator::COM_Y ] + lane );
+	SimdLoad( cz, streams[ BodyIntegrator::COM_Z ] + lane );
+	SimdLoad( ixx, streams[ BodyIntegrator::INERTIA_XX ] + lane );
+	SimdLoad( ixy, streams[ BodyIntegrator::INERTIA_XY ] + lane );
+	SimdLoad( ixz, streams[ BodyIntegrator::INERTIA_XZ ] + lane );
+	SimdLoad( iyy, streams[ BodyIntegrator::INERTIA_YY ] + lane );
+	SimdLoad( iyz, streams[ BodyIntegrator::INERTIA_YZ ] + lane );
+	SimdLoad( izz, streams[ BodyIntegrator::INERTIA_ZZ ] + lane );
+	SimdLoad( invxx, streams[ BodyIntegrator::INV_INERTIA_XX ] + lane );
+	SimdLoad( invxy, streams[ BodyIntegrator::INV_INERTIA_XY ] + lane );
+	SimdLoad( invxz, streams[ BodyIntegrator::INV_INERTIA_XZ ] + lane );
+	SimdLoad( invyy, streams[ BodyIntegrator::INV_INERTIA_YY ] + lane );
+	SimdLoad( invyz, streams[ BodyIntegrator::INV_INERTIA_YZ ] + lane );
+	SimdLoad( invzz, streams[ BodyIntegrator::INV_INERTIA_ZZ ] + lane );
+	lane_t dt;
+	SimdLoad( dt, streams[ BodyIntegrator::DT ] + lane );
+
+	// 1. position
+	px = px + vx * dt;
+	py = py + vy * dt;
+	pz = pz + vz * dt;
+
+	// 2. rotation matrix of the current orientation, and the center of mass in world space
+	const lane_t xx = qx * qx, yy = qy * qy, zz = qz * qz;
+	const lane_t xy = qx * qy, xz = qx * qz, yz = qy * qz;
+	const lane_t wx2 = qw * qx, wy2 = qw * qy, wz2 = qw * qz;
+	const lane_t r00 = 1.0f - 2.0f * ( yy + zz ), r01 = 2.0f * ( xy - wz2 ), r02 = 2.0f * ( xz + wy2 );
+	const lane_t r10 = 2.0f * ( xy + wz2 ), r11 = 1.0f - 2.0f * ( xx + zz ), r12 = 2.0f * ( yz - wx2 );
+	const lane_t r20 = 2.0f * ( xz - wy2 ), r21 = 2.0f * ( yz + wx2 ), r22 = 1.0f - 2.0f * ( xx + yy );
+
+	const lane_t comOffsetX = r00 * cx + r01 * cy + r02 * cz;
+	const lane_t comOffsetY = r10 * cx + r11 * cy + r12 * cz;
+	const lane_t comOffsetZ = r20 * cx + r21 * cy + r22 * cz;
+	const lane_t comX = px + comOffsetX;
+	const lane_t comY = py + comOffsetY;
+	const lane_t comZ = pz + comOffsetZ;
+
+	// 3. gyroscopic term, I^-1 ( w X I * w ). Body::Update builds its world tensor as ToMat3() * I * ToMat3()^T,
+	//    and ToMat3() is the transpose of the rotation above, so going to local space is R * w and coming back is R^T
+	const lane_t ux = r00 * wx + r01 * wy + r02 * wz;
+	const lane_t uy = r10 * wx + r11 * wy + r12 * wz;
+	const lane_t uz = r20 * wx + r21 * wy + r22 * wz;
+	const lane_t lx = ixx * ux + ixy * uy + ixz * uz;
+	const lane_t ly = ixy * ux + iyy * uy + iyz * uz;
+	const lane_t lz = ixz * ux + iyz * uy + izz * uz;
+	const lane_t tx = uy * lz - uz * ly;
+	const lane_t ty = uz * lx - ux * lz;
+	const lane_t tz = ux * ly - uy * lx;
+	const lane_t ax = invxx * tx + invxy * ty + invxz * tz;
+	const lane_t ay = invxy * tx + invyy * ty + invyz * tz;
+	const lane_t az = invxz * tx + invyz * ty + invzz * tz;
+	wx = wx + ( r00 * ax + r10 * ay + r20 * az ) * dt;
+	wy = wy + ( r01 * ax + r11 * ay + r21 * az ) * dt;
+	wz = wz + ( r02 * ax + r12 * ay + r22 * az ) * dt;
+
+	// 4. orientation, the quaternion for rotating by angle |w| * dt around w
+	const lane_t dx = wx * dt;
+	const lane_t dy = wy * dt;
+	const lane_t dz = wz * dt;
+	const lane_t h2 = 0.25f * ( dx * dx + dy * dy + dz * dz );
+	if ( !std::is_same< lane_t, float >::value && SimdAnyGreater( h2, MAX_POLY_HALF_ANGLE_SQR ) ) {
+		return false;
+	}
+	lane_t cosH, sincH;
+	SimdHalfAngleCosSinc( h2, cosH, sincH );
+	const lane_t dqw = cosH;
+	const lane_t dqx = dx * ( 0.5f * sincH );
+	const lane_t dqy = dy * ( 0.5f * sincH );
+	const lane_t dqz = dz * ( 0.5f * sincH );
+
+	lane_t nw = dqw * qw - dqx * qx - dqy * qy - dqz * qz;
+	lane_t nx = dqx * qw + dqw * qx + dqy * qz - dqz * qy;
+	lane_t ny = dqy * qw + dqw * qy + dqz * qx - dqx * qz;
+	lane_t nz = dqz * qw + dqw * qz + dqx * qy - dqy * qx;
+	const lane_t invMag = 1.0f / SimdSqrt( nw * nw + nx * nx + ny * ny + nz * nz );
+	nw = nw * invMag;
+	nx = nx * invMag;
+	ny = ny * invMag;
+	nz = nz * invMag;
+
+	// 5. the body rotated about its center of mass, so rotate the position around it too
+	//    v' = v + w * t + u X t, with t = 2 * ( u X v )
+	const lane_t rx = -comOffsetX;
+	const lane_t ry = -comOffsetY;
+	const lane_t rz = -comOffsetZ;
+	const lane_t t0 = 2.0f * ( dqy * rz - dqz * ry );
+	const lane_t t1 = 2.0f * ( dqz * rx - dqx * rz );
+	const lane_t t2 = 2.0f * ( dqx * ry - dqy * rx );
+	px = comX + rx + dqw * t0 + ( dqy * t2 - dqz * t1 );
+	py = comY + ry + dqw * t1 + ( dqz * t0 - dqx * t2 );
+	pz = comZ + rz + dqw * t2 + ( dqx * t1 - dqy * t0 );
+
+	SimdStore( px, streams[ BodyIntegrator::POS_X ] + lane );
+	SimdStore( py, streams[ BodyIntegrator::POS_Y ] + lane );
+	SimdStore( pz, streams[ BodyIntegrator::POS_Z ] + lane );
+	SimdStore( nw, streams[ BodyIntegrator::ORIENT_W ] + lane );
+	SimdStore( nx, streams[ BodyIntegrator::ORIENT_X ] + lane );
+	SimdStore( ny, streams[ BodyIntegrator::ORIENT_Y ] + lane );
+	SimdStore( nz, streams[ BodyIntegrator::ORIENT_Z ] + lane );
+	SimdStore( wx, streams[ BodyIntegrator::ANG_VEL_X ] + lane );
+	SimdStore( wy, streams[ BodyIntegrator::ANG_VEL_Y ] + lane );
+	SimdStore( wz, streams[ BodyIntegrator::ANG_VEL_Z ] + lane );
+	return true;
+}
+
+/*
+====================================================
+BodyIntegrator::Gather
+
+the time step is a stream like everything else, either dt_sec for every
+lane or each body's own from bodyDt_sec when that isn't null
+====================================================
+*/
+void BodyIntegrator::Gather( const BodyStore & bodies, const float dt_sec, const float * bodyDt_sec ) {
+	m_ids.clear();
+	for ( int i = 0; i < bodies.Size(); i++ ) {
+		if ( !bodies.IsActive( i ) ) {
+			continue;
+		}
+		if ( bodyDt_sec != nullptr && bodyDt_sec[ i ] <= 0.0f ) {
+			continue;
+		}
+		m_ids.push_back( i );
+	}
+	m_numLanes = static_cast< int >( m_ids.size() );
+
+	// the padding lanes are at rest with an identity orientation, so they go through the kernel without any NaNs
+	m_stride = SimdStreamStride( m_numLanes );
+	m_lanes.assign( NUM_STREAMS * m_stride, 0.0f );
+	float * orientW = GetStream( ORIENT_W );
+	for ( int lane = m_numLanes; lane < m_stride; lane++ ) {
+		orientW[ lane ] = 1.0f;
+	}
+
+	float * streams[ NUM_STREAMS ];
+	for ( int s = 0; s < NUM_STREAMS; s++ ) {
+		streams[ s ] = GetStream( s );
+	}
+	for ( int lane = 0; lane < m_numLanes; lane++ ) {
+		const int id = m_ids[ lane ];
+		const Vec3 & pos = bodies.m_positions[ id ];
+		const Quat & orient = bodies.m_orientations[ id ];
+		const Vec3 & linVel = bodies.m_linearVelocities[ id ];
+		const Vec3 & angVel = bodies.m_angularVelocities[ id ];
+		const Vec3 & com = bodies.m_centersOfMass[ id ];
+		const Mat3 & inertia = bodies.m_inertiaGeometric[ id ];
+		const Mat3 & invInertia = bodies.m_invInertiaGeometric[ id ];
+
+		streams[ POS_X ][ lane ] = pos.x;
+		streams[ POS_Y ][ lane ] = pos.y;
+		streams[ POS_Z ][ lane ] = pos.z;
+		streams[ ORIENT_W ][ lane ] = orient.w;
+		streams[ ORIENT_X ][ lane ] = orient.x;
+		streams[ ORIENT_Y ][ lane ] = orient.y;
+		streams[ ORIENT_Z ][ lane ] = orient.z;
+		streams[ LIN_VEL_X ][ lane ] = linVel.x;
+		streams[ LIN_VEL_Y ][ lane ] = linVel.y;
+		streams[ LIN_VEL_Z ][ lane ] = linVel.z;
+		streams[ ANG_VEL_X ][ lane ] = angVel.x;
+		streams[ ANG_VEL_Y ][ lane ] = angVel.y;
+		streams[ ANG_VEL_Z ][ lane ] = angVel.z;
+		streams[ COM_X ][ lane ] = com.x;
+		streams[ COM_Y ][ lane ] = com.y;
+		streams[ COM_Z ][ lane ] = com.z;
+
+		// inertia tensors are symmetric, so the upper triangle is all we need
+		streams[ INERTIA_XX ][ lane ] = inertia.rows[ 0 ][ 0 ];
+		streams[ INERTIA_XY ][ lane ] = inertia.rows[ 0 ][ 1 ];
+		streams[ INERTIA_XZ ][ lane ] = inertia.rows[ 0 ][ 2 ];
+		streams[ INERTIA_YY ][ lane ] = inertia.rows[ 1 ][ 1 ];
+		streams[ INERTIA_YZ ][ lane ] = inertia.rows[ 1 ][ 2 ];
+		streams[ INERTIA_ZZ ][ lane ] = inertia.rows[ 2 ][ 2 ];
+		streams[ INV_INERTIA_XX ][ lane ] = invInertia.rows[ 0 ][ 0 ];
+		streams[ INV_INERTIA_XY ][ lane ] = invInertia.rows[ 0 ][ 1 ];
+		streams[ INV_INERTIA_XZ ][ lane ] = invInertia.rows[ 0 ][ 2 ];
+		streams[ INV_INERTIA_YY ][ lane ] = invInertia.rows[ 1 ][ 1 ];
+		streams[ INV_INERTIA_YZ ][ lane ] = invInertia.rows[ 1 ][ 2 ];
+		streams[ INV_INERTIA_ZZ ][ lane ] = invInertia.rows[ 2 ][ 2 ];
+
+		streams[ DT ][ lane ] = ( bodyDt_sec != nullptr ) ? bodyDt_sec[ id ] : dt_sec;
+	}
+}
+
+/*
+====================================================
+BodyIntegrator::Scatter
+====================================================
+*/
+void BodyIntegrator::Scatter( BodyStore & bodies ) const {
+	const float * posX = GetStream( POS_X );
+	const float * posY = GetStream( POS_Y );
+	const float * posZ = GetStream( POS_Z );
+	const float * orientW = GetStream( ORIENT_W );
+	const float * orientX = GetStream( ORIENT_X );
+	const float * orientY = GetStream( ORIENT_Y );
+	const float * orientZ = GetStream( ORIENT_Z );
+	const float * angVelX = GetStream( ANG_VEL_X );
+	const float * angVelY = GetStream( ANG_VEL_Y );
+	const float * angVelZ = GetStream( ANG_VEL_Z );
+
+	// linear velocity is the only thing integrating doesn't change. the orientation did though, so
+	// this is where the world space inverse inertia gets brought up to date for the contacts
+	for ( int lane = 0; lane < m_numLanes; lane++ ) {
+		const int id = m_ids[ lane ];
+		bodies.m_positions[ id ] = Vec3( posX[ lane ], posY[ lane ], posZ[ lane ] );
+		bodies.m_orientations[ id ] = Quat( orientX[ lane ], orientY[ lane ], orientZ[ lane ], orientW[ lane ] );
+		bodies.m_angularVelocities[ id ] = Vec3( angVelX[ lane ], angVelY[ lane ], angVelZ[ lane ] );
+		bodies.RefreshWorldInertia( id );
+	}
+}
+
+/*
+====================================================
+BodyIntegrator::Integrate
+====================================================
+*/
+void BodyIntegrator::Integrate( BodyStore & bodies, const float dt_sec ) {
+	Gather( bodies, dt_sec, nullptr );
+	IntegrateGathered();
+	Scatter( bodies );
+}
+
+void BodyIntegrator::Integrate( BodyStore & bodies, const float * bodyDt_sec ) {
+	Gather( bodies, 0.0f, bodyDt_sec );
+	IntegrateGathered();
+	Scatter( bodies );
+}
+
+/*
+====================================================
+BodyIntegrator::IntegrateGathered
+====================================================
+*/
+void BodyIntegrator::IntegrateGathered() {
+	if ( m_numLanes == 0 ) {
+		return;
+	}
+
+	float * streams[ NUM_STREAMS ];
+	for ( int s = 0; s < NUM_STREAMS; s++ ) {
+		streams[ s ] = GetStream( s );
+	}
+
+	if ( SIMD_INTEGRATOR ) {
+		// the stride is a whole number of batches, the padding lanes just come along for the ride
+		for ( int lane = 0; lane < m_numLanes; lane += SIMD_WIDTH ) {
+			if ( IntegrateLanes< simdf_t >( streams, lane ) ) {
+				continue;
+			}
+
+			// something in this batch spins too fast for the polynomials
+			for ( int k = lane; k < lane + SIMD_WIDTH; k++ ) {
+				IntegrateLanes< float >( streams, k );
+			}
+		}
+	} else {
+		for ( int lane = 0; lane < m_numLanes; lane++ ) {
+			IntegrateLanes< float >( streams, lane );
+		}
+	}
+}
+
+/*
+====================================================
+BenchmarkIntegrator
+====================================================
+*/
+void BenchmarkIntegrator( const int numBodies, const int numSteps ) {
+	const float dt_sec = 1.0f / 60.0f;
+	ShapeSphere sphere( 0.5f );
+
+	// the same random bodies in two stores, one for each path
+	BodyStore scalarBodies;
+	BodyStore batchBodies;
+	srand( 1234 );
+	auto random = []( const float range ) { return ( float( rand() ) / float( RAND_MAX ) * 2.0f - 1.0f ) * range; };
+	for ( int i = 0; i < numBodies; i++ ) {
+		bodyDesc_t body;
+		body.position = Vec3( random( 100.0f ), random( 100.0f ), random( 100.0f ) );
+		body.orientation = Quat( Vec3( random( 1.0f ), random( 1.0f ), random( 1.0f ) ), random( 3.0f ) );
+		body.linearVelocity = Vec3( random( 10.0f ), random( 10.0f ), random( 10.0f ) );
+		body.angularVelocity = Vec3( random( 10.0f ), random( 10.0f ), random( 10.0f ) );
+		body.invMass = 1.0f;
+		body.shape = &sphere;
+		scalarBodies.Add( body );
+		batchBodies.Add( body );
+	}
+
+	typedef std::chrono::high_resolution_clock clock_t;
+	const clock_t::time_point scalarStart = clock_t::now();
+	for ( int step = 0; step < numSteps; step++ ) {
+		for ( int i = 0; i < scalarBodies.Size(); i++ ) {
+			scalarBodies.GetBodyAt( i ).Update( dt_sec );
+		}
+	}
+	const clock_t::time_point scalarEnd = clock_t::now();
+
+	BodyIntegrator integrator;
+	const clock_t::time_point batchStart = clock_t::now();
+	for ( int step = 0; step < numSteps; step++ ) {
+		integrator.Integrate( batchBodies, dt_sec );
+	}
+	const clock_t::time_point batchEnd = clock_t::now();
+
+	float maxPositionError = 0.0f;
+	float maxOrientationError = 0.0f;
+	for ( int i = 0; i < numBodies; i++ ) {
+		const Quat & qa = scalarBodies.m_orientations[ i ];
+		const Quat & qb = batchBodies.m_orientations[ i ];
+		const float orientationError = fabsf( qa.w - qb.w ) + fabsf( qa.x - qb.x ) + fabsf( qa.y - qb.y ) + fabsf( qa.z - qb.z );
+		maxPositionError = std::max( maxPositionError, ( scalarBodies.m_positions[ i ] - batchBodies.m_positions[ i ] ).GetMagnitude() );
+		maxOrientationError = std::max( maxOrientationError, orientationError );
+	}
+
+	const double scalarSec = std::chrono::duration< double >( scalarEnd - scalarStart ).count();
+	const double batchSec = std::chrono::duration< double >( batchEnd - batchStart ).count();
+	const double numUpdates = double( numBodies ) * double( numSteps );
+	printf( "Integrator benchmark, %i bodies x %i steps\n", numBodies, numSteps );
+	printf( "    Body::Update     %8.2f M bodies/s\n", numUpdates / scalarSec * 1e-6 );
+	printf( "    BodyIntegrator   %8.2f M bodies/s ( %i wide, %.1fx )\n", numUpdates / batchSec * 1e-6, SIMD_INTEGRATOR ? SIMD_WIDTH : 1, scalarSec / batchSec );
+	printf( "    max difference   position %g, orientation %g\n", maxPositionError, maxOrientationError );
+}
\ No newline at end of file
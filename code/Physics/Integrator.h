@@ -0,0 +1,62 @@
+//
+//	Integrator.h
+//
+#pragma once
+#include "BodyStore.h"
+#include "../Math/Matrix.h"
+#include <vector>
+
+/*
+====================================================
+BodyIntegrator
+
+Batch version of Body::Update, for stepping every active body of a store
+at once. The bodies get gathered into lanes ( one float stream per
+component ), advanced SIMD_WIDTH at a time and scattered back. The kernel
+does the gyroscopic term in the shape's local space, so the world inertia
+tensor never has to be built, and the shape's inverse comes cached from
+the store. It turns the angular velocity into a quaternion with a short
+polynomial instead of sinf / cosf.
+Bodies spinning too fast for the polynomial fall back to the same kernel
+instantiated for plain floats, which uses the real trig functions.
+====================================================
+*/
+class BodyIntegrator {
+public:
+	BodyIntegrator() : m_numLanes( 0 ), m_stride( 0 ) {}
+
+	// advances every active body by dt_sec, same as calling Body::Update on each of them
+	void Integrate( BodyStore & bodies, const float dt_sec );
+
+	// same, but every body has its own time to go ( indexed like the store ), bodies with none left are skipped
+	void Integrate( BodyStore & bodies, const float * bodyDt_sec );
+
+	enum laneStream_t {
+		POS_X, POS_Y, POS_Z,
+		ORIENT_W, ORIENT_X, ORIENT_Y, ORIENT_Z,
+		LIN_VEL_X, LIN_VEL_Y, LIN_VEL_Z,
+		ANG_VEL_X, ANG_VEL_Y, ANG_VEL_Z,
+		COM_X, COM_Y, COM_Z,							// center of mass, model space
+		INERTIA_XX, INERTIA_XY, INERTIA_XZ, INERTIA_YY, INERTIA_YZ, INERTIA_ZZ,
+		INV_INERTIA_XX, INV_INERTIA_XY, INV_INERTIA_XZ, INV_INERTIA_YY, INV_INERTIA_YZ, INV_INERTIA_ZZ,
+		DT,
+		NUM_STREAMS
+	};
+
+private:
+	void Gather( const BodyStore & bodies, const float dt_sec, const float * bodyDt_sec );
+	void IntegrateGathered();
+	void Scatter( BodyStore & bodies ) const;
+
+	float * GetStream( const int stream ) { return &m_lanes[ stream * m_stride ]; }
+	const float * GetStream( const int stream ) const { return &m_lanes[ stream * m_stride ]; }
+
+	// the active bodies, one lane each, padded out to a whole number of SIMD batches
+	std::vector< int > m_ids;
+	std::vector< float > m_lanes;
+	int m_numLanes;
+	int m_stride;
+};
+
+// steps the same bodies with Body::Update and with BodyIntegrator, and prints throughput and the largest difference
+void BenchmarkIntegrator( const int numBodies, const int numSteps );
\ No newline at end of file
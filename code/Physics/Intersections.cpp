@@ -98,17 +98,29 @@ bool SphereSphereDynamic( const ShapeSphere * shapeA, const ShapeSphere * shapeB
 	return true;
 }
 
+/*
+====================================================
+WorldSpaceToBodySpace
+
+Body::WorldSpaceToBodySpace for a body at the given position and orientation
+====================================================
+*/
+static Vec3 WorldSpaceToBodySpace( const Vec3 & worldPt, const Vec3 & position, const Quat & orientation, const Vec3 & centerOfMass ) {
+	const Vec3 centerOfMass_WS = position + orientation.RotatePoint( centerOfMass );
+	return orientation.Inverse().RotatePoint( worldPt - centerOfMass_WS );
+}
+
 /*
 ====================================================
 Intersect - sphere to sphere only
 ====================================================
 */
-bool Intersect( Body * bodyA, Body * bodyB ) {
-	const ShapeSphere * sphereA = reinterpret_cast< ShapeSphere * >( bodyA->m_shape );
-	const ShapeSphere * sphereB = reinterpret_cast< ShapeSphere * >( bodyB->m_shape );
+bool Intersect( Body bodyA, Body bodyB ) {
+	const ShapeSphere * sphereA = reinterpret_cast< ShapeSphere * >( bodyA.GetShape() );
+	const ShapeSphere * sphereB = reinterpret_cast< ShapeSphere * >( bodyB.GetShape() );
 	assert( IS_SPHERES( sphereA, sphereB ) );
 
-	const float distSquared	  = ( bodyA->m_position - bodyB->m_position ).GetLengthSqr();
+	const float distSquared	  = ( bodyA.GetPosition() - bodyB.GetPosition() ).GetLengthSqr();
 	const float radiusSum     = sphereA->m_radius + sphereB->m_radius;
 	const float radSumSquared = radiusSum * radiusSum;
 
@@ -120,19 +132,19 @@ bool Intersect( Body * bodyA, Body * bodyB ) {
 Intersect
 ====================================================
 */
-bool Intersect( Body * bodyA, Body * bodyB, contact_t & outContact ) {
-	const ShapeSphere * sphereA = reinterpret_cast< ShapeSphere * >( bodyA->m_shape );
-	const ShapeSphere * sphereB = reinterpret_cast< ShapeSphere * >( bodyB->m_shape );
+bool Intersect( Body bodyA, Body bodyB, contact_t & outContact ) {
+	const ShapeSphere * sphereA = reinterpret_cast< ShapeSphere * >( bodyA.GetShape() );
+	const ShapeSphere * sphereB = reinterpret_cast< ShapeSphere * >( bodyB.GetShape() );
 	assert( IS_SPHERES( sphereA, sphereB ) );
 
 	// populate contact with relevant data
 	outContact.bodyA  = bodyA;
 	outContact.bodyB  = bodyB;
-	const Vec3 pathAB = bodyB->m_position - bodyA->m_position;
+	const Vec3 pathAB = bodyB.GetPosition() - bodyA.GetPosition();
 	outContact.normal = pathAB; 
 	outContact.normal.Normalize();
-	outContact.ptOnA_WorldSpace = bodyA->m_position + outContact.normal * sphereA->m_radius;
-	outContact.ptOnB_WorldSpace = bodyB->m_position - outContact.normal * sphereB->m_radius;
+	outContact.ptOnA_WorldSpace = bodyA.GetPosition() + outContact.normal * sphereA->m_radius;
+	outContact.ptOnB_WorldSpace = bodyB.GetPosition() - outContact.normal * sphereB->m_radius;
 
 	const float radiiSumAB = sphereA->m_radius + sphereB->m_radius;
 	const float distABSq   = pathAB.GetLengthSqr();
@@ -149,44 +161,82 @@ bool Intersect( Body * bodyA, Body * bodyB, contact_t & outContact ) {
 Intersect
 ====================================================
 */
-bool Intersect( Body * bodyA, Body * bodyB, const float dt, contact_t & contact ) {
+bool Intersect( Body bodyA, Body bodyB, const float dt, contact_t & contact ) {
 	contact.bodyA = bodyA;
 	contact.bodyB = bodyB;
 
-	if ( bodyA->m_shape->GetType() != Shape::SHAPE_SPHERE ||
-		 bodyB->m_shape->GetType() != Shape::SHAPE_SPHERE ) {
+	if ( bodyA.GetShape()->GetType() != Shape::SHAPE_SPHERE ||
+		 bodyB.GetShape()->GetType() != Shape::SHAPE_SPHERE ) {
 		return false;
 	}
 
-	const ShapeSphere * sphereA = reinterpret_cast< ShapeSphere * >( bodyA->m_shape );
-	const ShapeSphere * sphereB = reinterpret_cast< ShapeSphere * >( bodyB->m_shape );
-	Vec3 posA = bodyA->m_position;
-	Vec3 posB = bodyB->m_position;
-	Vec3 velA = bodyA->m_linearVelocity;
-	Vec3 velB = bodyB->m_linearVelocity;
+	const ShapeSphere * sphereA = reinterpret_cast< const ShapeSphere * >( bodyA.GetShape() );
+	const ShapeSphere * sphereB = reinterpret_cast< const ShapeSphere * >( bodyB.GetShape() );
+	Vec3 posA = bodyA.GetPosition();
+	Vec3 posB = bodyB.GetPosition();
+	Vec3 velA = bodyA.GetLinearVelocity();
+	Vec3 velB = bodyB.GetLinearVelocity();
 
 	if ( !SphereSphereDynamic( sphereA, sphereB, posA, posB, velA, velB, dt, 
 		 contact.ptOnA_WorldSpace, contact.ptOnB_WorldSpace, contact.timeOfImpact ) ) {
 		return false;
 	}
 
-	// step bodies fwd in time to be at local space collision points
-	bodyA->Update( contact.timeOfImpact );
-	bodyB->Update( contact.timeOfImpact );
+	// where the bodies will be at the time of impact, the bodies themselves stay put
+	// so pairs can be tested from any number of threads at once
+	Quat orientA = bodyA.GetOrientation();
+	Quat orientB = bodyB.GetOrientation();
+	Vec3 angVelA = bodyA.GetAngularVelocity();
+	Vec3 angVelB = bodyB.GetAngularVelocity();
+	Vec3 toiPosA = posA;
+	Vec3 toiPosB = posB;
+	bodyA.PredictState( contact.timeOfImpact, toiPosA, orientA, angVelA );
+	bodyB.PredictState( contact.timeOfImpact, toiPosB, orientB, angVelB );
 
 	// Convert world space contact to local space
-	contact.ptOnA_LocalSpace = bodyA->WorldSpaceToBodySpace( contact.ptOnA_WorldSpace );
-	contact.ptOnB_LocalSpace = bodyB->WorldSpaceToBodySpace( contact.ptOnB_WorldSpace );
+	contact.ptOnA_LocalSpace = WorldSpaceToBodySpace( contact.ptOnA_WorldSpace, toiPosA, orientA, bodyA.GetCenterOfMassModelSpace() );
+	contact.ptOnB_LocalSpace = WorldSpaceToBodySpace( contact.ptOnB_WorldSpace, toiPosB, orientB, bodyB.GetCenterOfMassModelSpace() );
 
-	contact.normal = bodyA->m_position - bodyB->m_position;
+	contact.normal = toiPosA - toiPosB;
 	contact.normal.Normalize();
 
-	// undo the step forward from above
-	bodyA->Update( -contact.timeOfImpact );
-	bodyB->Update( -contact.timeOfImpact );
-
 	// Calculate separation distance
-	Vec3 ab = bodyB->m_position - bodyA->m_position;
+	Vec3 ab = posB - posA;
 	contact.separationDistance = ab.GetMagnitude() - ( sphereA->m_radius + sphereB->m_radius );
 	return true;
+}
+
+/*
+====================================================
+IntersectConvex
+====================================================
+*/
+bool IntersectConvex( Body bodyA, Body bodyB, gjkCache_t & cache, gjkStats_t & stats, contact_t & contact ) {
+	contact.bodyA = bodyA;
+	contact.bodyB = bodyB;
+	contact.timeOfImpact = 0.0f;
+
+	// EPA runs on the shapes grown by the bias, so it still has a volume to expand when they only just touch
+	const float bias = 0.001f;
+	Vec3 ptOnA;
+	Vec3 ptOnB;
+	if ( !GJK_DoesIntersect( bodyA, bodyB, bias, ptOnA, ptOnB, &cache, &stats ) ) {
+		return false;
+	}
+
+	// same as the spheres, the normal points from B to A
+	Vec3 normal = ptOnB - ptOnA;
+	normal.Normalize();
+
+	// back from the grown shapes onto the real ones
+	ptOnA += normal * bias;
+	ptOnB -= normal * bias;
+
+	contact.normal = normal;
+	contact.ptOnA_WorldSpace = ptOnA;
+	contact.ptOnB_WorldSpace = ptOnB;
+	contact.ptOnA_LocalSpace = bodyA.WorldSpaceToBodySpace( ptOnA );
+	contact.ptOnB_LocalSpace = bodyB.WorldSpaceToBodySpace( ptOnB );
+	contact.separationDistance = -( ptOnA - ptOnB ).GetMagnitude();
+	return true;
 }
\ No newline at end of file
@@ -4,6 +4,15 @@
 #pragma once
 #include "Contact.h"
 
-bool Intersect( Body * bodyA, Body * bodyB );
-bool Intersect( Body * bodyA, Body * bodyB, contact_t & contact );
-bool Intersect( Body * bodyA, Body * bodyB, const float dt, contact_t & contact );
\ No newline at end of file
+struct gjkCache_t;
+struct gjkStats_t;
+
+bool RaySphere( const Vec3 & rayStart, const Vec3 & rayPath, const Vec3 & sphereCenter, const float sphereRadii, float & t1, float & t2 );
+
+bool Intersect( Body bodyA, Body bodyB );
+bool Intersect( Body bodyA, Body bodyB, contact_t & contact );
+bool Intersect( Body bodyA, Body bodyB, const float dt, contact_t & contact );
+
+// any convex shapes, through GJK and EPA. only finds contacts between shapes that already overlap ( time of impact 0 ).
+// the pair's cache warm starts GJK, and both it and the stats can be written from one thread per pair
+bool IntersectConvex( Body bodyA, Body bodyB, gjkCache_t & cache, gjkStats_t & stats, contact_t & contact );
\ No newline at end of file
@@ -0,0 +1,96 @@
+//
+//	Island.cpp
+//
+#include "Island.h"
+
+/*
+====================================================
+IslandGraph::Reset
+====================================================
+*/
+void IslandGraph::Reset( const int numBodies ) {
+	m_parents.resize( numBodies );
+	m_sizes.resize( numBodies );
+	for ( int i = 0; i < numBodies; i++ ) {
+		m_parents[ i ] = i;
+		m_sizes[ i ] = 1;
+	}
+}
+
+/*
+====================================================
+IslandGraph::Find
+
+path halving, every lookup flattens the tree a bit more
+====================================================
+*/
+int IslandGraph::Find( const int id ) {
+	int root = id;
+	while ( m_parents[ root ] != root ) {
+		m_parents[ root ] = m_parents[ m_parents[ root ] ];
+		root = m_parents[ root ];
+	}
+	return root;
+}
+
+/*
+====================================================
+IslandGraph::Link
+====================================================
+*/
+void IslandGraph::Link( const int a, const int b ) {
+	int rootA = Find( a );
+	int rootB = Find( b );
+	if ( rootA == rootB ) {
+		return;
+	}
+
+	// hang the smaller island off the bigger one, to keep the trees shallow
+	if ( m_sizes[ rootA ] < m_sizes[ rootB ] ) {
+		const int tmp = rootA;
+		rootA = rootB;
+		rootB = tmp;
+	}
+	m_parents[ rootB ] = rootA;
+	m_sizes[ rootA ] += m_sizes[ rootB ];
+}
+
+/*
+====================================================
+SleepingIslandTable::Add
+====================================================
+*/
+int SleepingIslandTable::Add() {
+	int islandId = m_freeIsland;
+	if ( islandId >= 0 ) {
+		m_freeIsland = m_islands[ islandId ].nextFree;
+	} else {
+		islandId = static_cast< int >( m_islands.size() );
+		m_islands.push_back( island_t() );
+	}
+
+	m_islands[ islandId ].members.clear();
+	m_islands[ islandId ].nextFree = -1;
+	return islandId;
+}
+
+/*
+====================================================
+SleepingIslandTable::Remove
+====================================================
+*/
+void SleepingIslandTable::Remove( const int islandId ) {
+	m_islands[ islandId ].members.clear();
+	m_islands[ islandId ].nextFree = m_freeIsland;
+	m_freeIsland = islandId;
+}
+
+/*
+====================================================
+SleepingIslandTable::Clear
+====================================================
+*/
+void SleepingIslandTable::Clear() {
+	m_islands.clear();
+	m_freeIsland = -1;
+}
\ No newline at end of file
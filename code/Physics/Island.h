@@ -0,0 +1,61 @@
+//
+//	Island.h
+//
+#pragma once
+#include "BodyStore.h"
+#include <vector>
+
+/*
+====================================================
+IslandGraph
+
+Union-find over body ids. Every body starts out as its own island, and each
+contact or constraint between two dynamic bodies merges their islands.
+Static bodies must never be linked, or everything resting on the floor
+would end up in one giant island.
+====================================================
+*/
+class IslandGraph {
+public:
+	void Reset( const int numBodies );
+
+	void Link( const int a, const int b );
+	int Find( const int id );
+
+	int GetNumBodies() const { return static_cast< int >( m_parents.size() ); }
+
+private:
+	std::vector< int > m_parents;
+	std::vector< int > m_sizes;
+};
+
+/*
+====================================================
+SleepingIslandTable
+
+The bodies of every island that's asleep, so waking one up only touches its own
+members. The id a sleeping body carries is its island's slot in here, which stays
+put while the island sleeps no matter how the body store gets shuffled. Members
+are kept as handles, a body removed while asleep just gets skipped on waking.
+Woken slots go on a free list and keep their capacity for the next island.
+====================================================
+*/
+class SleepingIslandTable {
+public:
+	SleepingIslandTable() : m_freeIsland( -1 ) {}
+
+	int Add();
+	void Remove( const int islandId );
+	void Clear();
+
+	void AddMember( const int islandId, const bodyHandle_t handle ) { m_islands[ islandId ].members.push_back( handle ); }
+	const std::vector< bodyHandle_t > & GetMembers( const int islandId ) const { return m_islands[ islandId ].members; }
+
+private:
+	struct island_t {
+		std::vector< bodyHandle_t > members;
+		int nextFree;
+	};
+	std::vector< island_t > m_islands;
+	int m_freeIsland;
+};
\ No newline at end of file
@@ -2,7 +2,10 @@
 //  Manifold.cpp
 //
 #include "Manifold.h"
+#include <algorithm>
 
+// contacts whose anchors have drifted further apart than this, or that have separated, get dropped
+static const float CONTACT_DRIFT_THRESHOLD = 0.02f;
 
 /*
 ================================================================================================
@@ -14,47 +17,100 @@ ManifoldCollector
 
 /*
 ================================
-ManifoldCollector::AddContact
+ManifoldCollector::RemoveManifold
+
+swaps the last manifold into the hole, the same as the pair table does with its index
 ================================
 */
-void ManifoldCollector::AddContact( const contact_t & contact ) {
-	// TODO: Add Code
+void ManifoldCollector::RemoveManifold( const int manifoldIdx ) {
+	m_pairs.Remove( manifoldIdx );
+
+	const int last = static_cast< int >( m_manifolds.size() ) - 1;
+	if ( manifoldIdx != last ) {
+		m_manifolds[ manifoldIdx ] = m_manifolds[ last ];
+	}
+	m_manifolds.pop_back();
 }
 
 /*
 ================================
-ManifoldCollector::RemoveExpired
+ManifoldCollector::Find
 ================================
 */
-void ManifoldCollector::RemoveExpired() {
-	// TODO: Add Code
+Manifold * ManifoldCollector::Find( const Body & bodyA, const Body & bodyB ) {
+	const int idx = m_pairs.Find( PairTable::PairKey( bodyA, bodyB ) );
+	if ( idx < 0 ) {
+		return nullptr;
+	}
+
+	// the slots match, but the handles might be from before one of the bodies got removed
+	Manifold & manifold = m_manifolds[ idx ];
+	const bool sameOrder = manifold.m_bodyA == bodyA && manifold.m_bodyB == bodyB;
+	const bool swapped = manifold.m_bodyA == bodyB && manifold.m_bodyB == bodyA;
+	return ( sameOrder || swapped ) ? &manifold : nullptr;
 }
 
 /*
 ================================
-ManifoldCollector::PreSolve
+ManifoldCollector::AddContact
 ================================
 */
-void ManifoldCollector::PreSolve( const float dt_sec ) {
-	// TODO: Add Code
+void ManifoldCollector::AddContact( const contact_t & contact ) {
+	const uint64_t key = PairTable::PairKey( contact.bodyA, contact.bodyB );
+	const int idx = m_pairs.Find( key );
+	if ( idx >= 0 ) {
+		Manifold & manifold = m_manifolds[ idx ];
+
+		// a manifold left over from a body that used to be in one of these slots starts over
+		const bool sameOrder = manifold.m_bodyA == contact.bodyA && manifold.m_bodyB == contact.bodyB;
+		const bool swapped = manifold.m_bodyA == contact.bodyB && manifold.m_bodyB == contact.bodyA;
+		if ( !sameOrder && !swapped ) {
+			manifold = Manifold();
+			manifold.m_bodyA = contact.bodyA;
+			manifold.m_bodyB = contact.bodyB;
+		}
+		manifold.AddContact( contact );
+		return;
+	}
+
+	Manifold manifold;
+	manifold.m_bodyA = contact.bodyA;
+	manifold.m_bodyB = contact.bodyB;
+	manifold.AddContact( contact );
+
+	m_manifolds.push_back( manifold );
+	m_pairs.Add( key );
 }
 
 /*
 ================================
-ManifoldCollector::Solve
+ManifoldCollector::RemoveExpired
 ================================
 */
-void ManifoldCollector::Solve() {
-	// TODO: Add Code
+void ManifoldCollector::RemoveExpired() {
+	// back to front, so whatever gets swapped into a hole has already been looked at
+	for ( int i = static_cast< int >( m_manifolds.size() ) - 1; i >= 0; i-- ) {
+		Manifold & manifold = m_manifolds[ i ];
+		if ( !manifold.m_bodyA.IsValid() || !manifold.m_bodyB.IsValid() ) {
+			RemoveManifold( i );
+			continue;
+		}
+
+		manifold.RemoveExpiredContacts();
+		if ( 0 == manifold.m_numContacts ) {
+			RemoveManifold( i );
+		}
+	}
 }
 
 /*
 ================================
-Manifold::PostSolve
+ManifoldCollector::Clear
 ================================
 */
-void ManifoldCollector::PostSolve() {
-	// TODO: Add Code
+void ManifoldCollector::Clear() {
+	m_manifolds.clear();
+	m_pairs.Clear();
 }
 
 /*
@@ -71,7 +127,34 @@ Manifold::RemoveExpiredContacts
 ================================
 */
 void Manifold::RemoveExpiredContacts() {
-	// TODO: Add Code
+	// remove any contacts that have drifted too far
+	for ( int i = 0; i < m_numContacts; i++ ) {
+		const contact_t & contact = m_contacts[ i ];
+
+		// Get the tangential distance of the point on A and the point on B
+		const Vec3 a = m_bodyA.BodySpaceToWorldSpace( contact.ptOnA_LocalSpace );
+		const Vec3 b = m_bodyB.BodySpaceToWorldSpace( contact.ptOnB_LocalSpace );
+		const Vec3 normal = m_bodyA.GetOrientation().RotatePoint( m_constraints[ i ].m_normal );
+
+		// Calculate the tangential separation and penetration depth
+		const Vec3 ab = b - a;
+		const float penetrationDepth = normal.Dot( ab );
+		const Vec3 abTangent = ab - normal * penetrationDepth;
+
+		// If the tangential displacement is less than a specific threshold, it's okay to keep it
+		if ( abTangent.GetLengthSqr() < CONTACT_DRIFT_THRESHOLD * CONTACT_DRIFT_THRESHOLD && penetrationDepth <= 0.0f ) {
+			continue;
+		}
+
+		// This contact has moved beyond its threshold and should be removed
+		for ( int j = i; j < m_numContacts - 1; j++ ) {
+			m_constraints[ j ] = m_constraints[ j + 1 ];
+			m_contacts[ j ] = m_contacts[ j + 1 ];
+		}
+		m_numContacts--;
+		m_constraints[ m_numContacts ].m_cachedLambda.Zero();
+		i--;
+	}
 }
 
 /*
@@ -80,7 +163,77 @@ Manifold::AddContact
 ================================
 */
 void Manifold::AddContact( const contact_t & contact_old ) {
-	// TODO: Add Code
+	// Make sure the contact's BodyA and BodyB are of the correct order
+	contact_t contact = contact_old;
+	if ( contact_old.bodyA != m_bodyA ) {
+		contact.ptOnA_LocalSpace = contact_old.ptOnB_LocalSpace;
+		contact.ptOnB_LocalSpace = contact_old.ptOnA_LocalSpace;
+		contact.ptOnA_WorldSpace = contact_old.ptOnB_WorldSpace;
+		contact.ptOnB_WorldSpace = contact_old.ptOnA_WorldSpace;
+		contact.normal = contact_old.normal * -1.0f;
+
+		contact.bodyA = m_bodyA;
+		contact.bodyB = m_bodyB;
+	}
+
+	// a contact whose anchors are close to an old one's, on both bodies, is the same contact point
+	// from an earlier step. it takes over the fresh geometry but keeps the impulses accumulated so
+	// far, that's what the next PreSolve warm starts from
+	int matchedSlot = -1;
+	float closestDistSqr = CONTACT_DRIFT_THRESHOLD * CONTACT_DRIFT_THRESHOLD;
+	for ( int i = 0; i < m_numContacts; i++ ) {
+		const float distSqrA = ( contact.ptOnA_LocalSpace - m_contacts[ i ].ptOnA_LocalSpace ).GetLengthSqr();
+		const float distSqrB = ( contact.ptOnB_LocalSpace - m_contacts[ i ].ptOnB_LocalSpace ).GetLengthSqr();
+		if ( distSqrA < closestDistSqr && distSqrB < CONTACT_DRIFT_THRESHOLD * CONTACT_DRIFT_THRESHOLD ) {
+			closestDistSqr = distSqrA;
+			matchedSlot = i;
+		}
+	}
+
+	// If we're all full on contacts, then keep the contacts that are furthest away from each other
+	int newSlot = ( matchedSlot >= 0 ) ? matchedSlot : m_numContacts;
+	if ( newSlot >= MAX_CONTACTS ) {
+		Vec3 avg = contact.ptOnA_LocalSpace;
+		for ( int i = 0; i < MAX_CONTACTS; i++ ) {
+			avg += m_contacts[ i ].ptOnA_LocalSpace;
+		}
+		avg *= 1.0f / float( MAX_CONTACTS + 1 );
+
+		float minDist = ( avg - contact.ptOnA_LocalSpace ).GetLengthSqr();
+		int newIdx = -1;
+		for ( int i = 0; i < MAX_CONTACTS; i++ ) {
+			const float dist2 = ( avg - m_contacts[ i ].ptOnA_LocalSpace ).GetLengthSqr();
+			if ( dist2 < minDist ) {
+				minDist = dist2;
+				newIdx = i;
+			}
+		}
+
+		if ( -1 == newIdx ) {
+			return;
+		}
+		newSlot = newIdx;
+	}
+
+	m_contacts[ newSlot ] = contact;
+
+	ConstraintPenetration & constraint = m_constraints[ newSlot ];
+	constraint.m_bodyA = contact.bodyA;
+	constraint.m_bodyB = contact.bodyB;
+	constraint.m_anchorA = contact.ptOnA_LocalSpace;
+	constraint.m_anchorB = contact.ptOnB_LocalSpace;
+
+	// Get the normal in BodyA's space
+	constraint.m_normal = m_bodyA.GetOrientation().Inverse().RotatePoint( contact.normal * -1.0f );
+	constraint.m_normal.Normalize();
+
+	if ( newSlot != matchedSlot ) {
+		constraint.m_cachedLambda.Zero();
+	}
+
+	if ( newSlot == m_numContacts ) {
+		m_numContacts++;
+	}
 }
 
 /*
@@ -89,7 +242,15 @@ Manifold::PreSolve
 ================================
 */
 void Manifold::PreSolve( const float dt_sec ) {
-	// TODO: Add Code
+	// the impulses would wake a sleeping pair back up
+	m_isSolved = m_bodyA.IsActive() || m_bodyB.IsActive();
+	if ( !m_isSolved ) {
+		return;
+	}
+
+	for ( int i = 0; i < m_numContacts; i++ ) {
+		m_constraints[ i ].PreSolve( dt_sec );
+	}
 }
 
 /*
@@ -97,8 +258,17 @@ void Manifold::PreSolve( const float dt_sec ) {
 Manifold::Solve
 ================================
 */
-void Manifold::Solve() {
-	// TODO: Add Code
+float Manifold::Solve( const float relaxation ) {
+	if ( !m_isSolved ) {
+		return 0.0f;
+	}
+
+	float maxImpulseDelta = 0.0f;
+	for ( int i = 0; i < m_numContacts; i++ ) {
+		m_constraints[ i ].Solve( relaxation );
+		maxImpulseDelta = std::max( maxImpulseDelta, m_constraints[ i ].m_impulseDelta );
+	}
+	return maxImpulseDelta;
 }
 
 /*
@@ -107,5 +277,11 @@ Manifold::PostSolve
 ================================
 */
 void Manifold::PostSolve() {
-	// TODO: Add Code
+	if ( !m_isSolved ) {
+		return;
+	}
+
+	for ( int i = 0; i < m_numContacts; i++ ) {
+		m_constraints[ i ].PostSolve();
+	}
 }
\ No newline at end of file
@@ -5,6 +5,9 @@
 #include "Body.h"
 #include "Constraints.h"
 #include "Contact.h"
+#include "PairTable.h"
+#include <vector>
+#include <stdint.h>
 
 /*
 ================================
@@ -13,35 +16,49 @@ Manifold
 */
 class Manifold {
 public:
-	Manifold() : m_bodyA( NULL ), m_bodyB( NULL ), m_numContacts( 0 ) {}
+	Manifold() : m_numContacts( 0 ), m_isSolved( false ) {}
 
 	void AddContact( const contact_t & contact );
 	void RemoveExpiredContacts();
 
 	void PreSolve( const float dt_sec );
-	void Solve();
+	float Solve( const float relaxation );	// returns the largest change to any contact's accumulated impulses
 	void PostSolve();
 
 	contact_t GetContact( const int idx ) const { return m_contacts[ idx ]; }
 	int GetNumContacts() const { return m_numContacts; }
 
-private:
+	Body GetBodyA() const { return m_bodyA; }
+	Body GetBodyB() const { return m_bodyB; }
+	bool IsSolved() const { return m_isSolved; }	// as of the last PreSolve
+
 	static const int MAX_CONTACTS = 4;
+
+private:
 	contact_t m_contacts[ MAX_CONTACTS ];
 
 	int m_numContacts;
 
-	Body * m_bodyA;
-	Body * m_bodyB;
+	Body m_bodyA;
+	Body m_bodyB;
 
 	ConstraintPenetration m_constraints[ MAX_CONTACTS ];
 
+	// decided once per step in PreSolve, pairs where neither body can move are left alone
+	bool m_isSolved;
+
 	friend class ManifoldCollector;
+	friend class ContactBatch;
 };
 
 /*
 ================================
 ManifoldCollector
+
+Keeps one manifold per touching pair of bodies, found through a PairTable
+( so the order the narrowphase reports the bodies in doesn't matter ). The
+manifolds themselves stay densely packed for the solver loops, expiring one
+swaps the last manifold into its place.
 ================================
 */
 class ManifoldCollector {
@@ -50,13 +67,19 @@ public:
 
 	void AddContact( const contact_t & contact );
 
-	void PreSolve( const float dt_sec );
-	void Solve();
-	void PostSolve();
-
 	void RemoveExpired();
-	void Clear() { m_manifolds.clear(); }	// For resetting the demo
+	void Clear();	// For resetting the demo
+
+	// the manifold between the two bodies, in either order, or null
+	Manifold * Find( const Body & bodyA, const Body & bodyB );
+	int Size() const { return static_cast< int >( m_manifolds.size() ); }
+
+private:
+	void RemoveManifold( const int manifoldIdx );
 
 public:
 	std::vector< Manifold > m_manifolds;
+
+private:
+	PairTable m_pairs;	// index into m_manifolds of each pair
 };
\ No newline at end of file
@@ -0,0 +1,166 @@
+//
+//  PairTable.cpp
+//
+#include "PairTable.h"
+#include <algorithm>
+
+// the table is grown before it gets more than half full, so probe runs stay short
+static const int MIN_TABLE_SIZE = 64;
+
+/*
+================================
+PairTable::PairKey
+================================
+*/
+uint64_t PairTable::PairKey( const Body & bodyA, const Body & bodyB ) {
+	const uint32_t slotA = bodyA.GetHandle().slot;
+	const uint32_t slotB = bodyB.GetHandle().slot;
+	const uint64_t lo = slotA < slotB ? slotA : slotB;
+	const uint64_t hi = slotA < slotB ? slotB : slotA;
+	return ( lo << 32 ) | hi;
+}
+
+/*
+================================
+PairTable::HashKey
+
+fibonacci hashing, the high bits of the product are the well mixed ones
+================================
+*/
+uint32_t PairTable::HashKey( const uint64_t key ) {
+	return static_cast< uint32_t >( ( key * 0x9E3779B97F4A7C15ull ) >> 32 );
+}
+
+/*
+================================
+PairTable::FindEntry
+
+the table entry holding the pair with this key, or -1
+================================
+*/
+int PairTable::FindEntry( const uint64_t key ) const {
+	if ( m_table.empty() ) {
+		return -1;
+	}
+
+	const int mask = static_cast< int >( m_table.size() ) - 1;
+	for ( int entry = HashKey( key ) & mask; m_table[ entry ] >= 0; entry = ( entry + 1 ) & mask ) {
+		if ( m_keys[ m_table[ entry ] ] == key ) {
+			return entry;
+		}
+	}
+	return -1;
+}
+
+/*
+================================
+PairTable::InsertEntry
+================================
+*/
+void PairTable::InsertEntry( const int idx ) {
+	const int mask = static_cast< int >( m_table.size() ) - 1;
+	int entry = HashKey( m_keys[ idx ] ) & mask;
+	while ( m_table[ entry ] >= 0 ) {
+		entry = ( entry + 1 ) & mask;
+	}
+	m_table[ entry ] = idx;
+}
+
+/*
+================================
+PairTable::EraseEntry
+
+backward shift deletion, every entry after the hole that would still be
+found from its home entry with the hole closed gets pulled back into it
+================================
+*/
+void PairTable::EraseEntry( const int entry ) {
+	const int mask = static_cast< int >( m_table.size() ) - 1;
+
+	int hole = entry;
+	for ( int next = ( entry + 1 ) & mask; m_table[ next ] >= 0; next = ( next + 1 ) & mask ) {
+		const int home = HashKey( m_keys[ m_table[ next ] ] ) & mask;
+
+		// how far the entry is from its home, versus how far the hole is
+		if ( ( ( next - home ) & mask ) >= ( ( next - hole ) & mask ) ) {
+			m_table[ hole ] = m_table[ next ];
+			hole = next;
+		}
+	}
+	m_table[ hole ] = -1;
+}
+
+/*
+================================
+PairTable::Rehash
+================================
+*/
+void PairTable::Rehash( const int numEntries ) {
+	m_table.assign( numEntries, -1 );
+	for ( int i = 0; i < m_keys.size(); i++ ) {
+		InsertEntry( i );
+	}
+}
+
+/*
+================================
+PairTable::Find
+================================
+*/
+int PairTable::Find( const uint64_t key ) const {
+	const int entry = FindEntry( key );
+	return ( entry >= 0 ) ? m_table[ entry ] : -1;
+}
+
+/*
+================================
+PairTable::Add
+================================
+*/
+int PairTable::Add( const uint64_t key ) {
+	if ( ( m_keys.size() + 1 ) * 2 > m_table.size() ) {
+		Rehash( m_table.empty() ? MIN_TABLE_SIZE : static_cast< int >( m_table.size() ) * 2 );
+	}
+
+	m_keys.push_back( key );
+	InsertEntry( static_cast< int >( m_keys.size() ) - 1 );
+	return static_cast< int >( m_keys.size() ) - 1;
+}
+
+/*
+================================
+PairTable::Remove
+
+swaps the last pair into the hole, so only its table entry has to be fixed up
+================================
+*/
+void PairTable::Remove( const int idx ) {
+	EraseEntry( FindEntry( m_keys[ idx ] ) );
+
+	const int last = static_cast< int >( m_keys.size() ) - 1;
+	if ( idx != last ) {
+		m_table[ FindEntry( m_keys[ last ] ) ] = idx;
+		m_keys[ idx ] = m_keys[ last ];
+	}
+	m_keys.pop_back();
+}
+
+/*
+================================
+PairTable::Clear
+
+keeps the table's memory, a table that's cleared every step doesn't reallocate
+================================
+*/
+void PairTable::Clear() {
+	// a few pairs in a big table are cheaper to erase one by one than to wipe the whole table
+	if ( m_keys.size() * 8 < m_table.size() ) {
+		while ( !m_keys.empty() ) {
+			Remove( Size() - 1 );
+		}
+		return;
+	}
+
+	m_keys.clear();
+	std::fill( m_table.begin(), m_table.end(), -1 );
+}
\ No newline at end of file
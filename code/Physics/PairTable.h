@@ -0,0 +1,54 @@
+//
+//	PairTable.h
+//
+#pragma once
+#include "Body.h"
+#include <vector>
+#include <stdint.h>
+
+/*
+====================================================
+PairTable
+
+Maps pairs of bodies to dense indices, for state that persists per pair
+across steps ( manifolds, GJK caches ) in an array owned by the caller.
+An open addressing hash table keyed on the pair ( lower slot first, so the
+order the bodies come in doesn't matter ). Removing an index swaps the last
+one into its place, the caller does the same swap on its array, and the
+table is fixed up with backward shift deletion instead of tombstones, so
+lookups never slow down over time. The keys are just 64 bit numbers, the
+sweep and prune broadphase uses the table for pairs of dense body ids too.
+====================================================
+*/
+class PairTable {
+public:
+	PairTable() {}
+
+	// same key for ( a, b ) and ( b, a ). slots never move, so neither does the key
+	static uint64_t PairKey( const Body & bodyA, const Body & bodyB );
+
+	// the index of the pair with this key, or -1
+	int Find( const uint64_t key ) const;
+
+	// the new pair gets index Size() - 1
+	int Add( const uint64_t key );
+
+	// moves the last pair into idx
+	void Remove( const int idx );
+
+	void Clear();
+
+	uint64_t GetKey( const int idx ) const { return m_keys[ idx ]; }
+	int Size() const { return static_cast< int >( m_keys.size() ); }
+
+private:
+	static uint32_t HashKey( const uint64_t key );
+
+	int FindEntry( const uint64_t key ) const;
+	void InsertEntry( const int idx );
+	void EraseEntry( const int entry );
+	void Rehash( const int numEntries );
+
+	std::vector< uint64_t > m_keys;		// PairKey of each index
+	std::vector< int > m_table;			// index of the pair, or -1 for an empty entry. always a power of two in size
+};
\ No newline at end of file
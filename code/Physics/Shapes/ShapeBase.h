@@ -21,6 +21,8 @@ Shape
 */
 class Shape {
 public:
+	virtual ~Shape() {}
+
 	virtual Mat3 InertiaTensorGeometric() const = 0;
 
 	virtual Bounds GetBounds( const Vec3 & pos, const Quat & orient ) const = 0;
@@ -31,10 +33,14 @@ public:
 	enum shapeType_t {
 		SHAPE_SPHERE,
 		SHAPE_LOADED_MESH,
+		SHAPE_CONVEX,
 	};
 
 	virtual shapeType_t GetType() const = 0;
 
+	// world space point of the shape furthest along dir ( dir is normalized ), pushed out by bias
+	virtual Vec3 Support( const Vec3 & dir, const Vec3 & pos, const Quat & orient, const float bias ) const = 0;
+
 	shapeColor_t color = DEFAULT;
 
 protected:
@@ -0,0 +1,1140 @@
+//
+//  ShapeConvex.cpp
+//
+#include "ShapeConvex.h"
+#include "../../Math/Simd.h"
+#include <float.h>
+#include <assert.h>
+#include <algorithm>
+
+// below this many points a SIMD scan over all of them is cheaper than walking the edge graph
+static const int HILL_CLIMB_MIN_POINTS = 32;
+
+// points that don't enclose a volume are treated as little balls this fraction of their spread across, or at least this big
+static const float POINT_CLOUD_RADIUS_SCALE = 0.01f;
+static const float POINT_CLOUD_MIN_RADIUS = 0.01f;
+
+// how many float epsilons, relative to the size of the hull, the hull builder treats as coplanar
+static const float HULL_EPSILON_SCALE = 3.0f;
+
+// how many epsilons a point may end up in front of a face, in the debug checks of the finished hull.
+// past the work limit, points * faces, only the edges get checked
+static const float HULL_VALIDATE_TOLERANCE = 10.0f;
+static const double HULL_VALIDATE_MAX_WORK = 1e7;
+
+/*
+====================================================
+DistanceFromTriangle
+====================================================
+*/
+static float DistanceFromTriangle( const Vec3 & a, const Vec3 & b, const Vec3 & c, const Vec3 & pt ) {
+	Vec3 ab = b - a;
+	Vec3 ac = c - a;
+	Vec3 normal = ab.Cross( ac );
+	normal.Normalize();
+
+	Vec3 ray = pt - a;
+	float dist = ray.Dot( normal );
+	return dist;
+}
+
+/*
+========================================================================================================
+
+Quickhull
+
+========================================================================================================
+*/
+
+/*
+====================================================
+hullFace_t
+
+a triangle of the hull while it's being built, wound counter clockwise seen
+from outside. adjacent[ i ] is the face across the edge from v[ i ] to
+v[ i + 1 ], and outside holds the points in front of this face that haven't
+been added yet ( its conflict list )
+====================================================
+*/
+struct hullFace_t {
+	int v[ 3 ];
+	int adjacent[ 3 ];
+	Vec3 normal;
+	float dist;
+	std::vector< int > outside;
+	int furthest;			// the point of outside furthest in front of the face, -1 when outside is empty
+	float furthestDist;
+	int visited;			// the pass that last looked at this face
+	bool isVisible;
+	bool isAlive;
+};
+
+struct horizonEdge_t {
+	int a;
+	int b;
+	int face;				// the face on the far side, that stays
+	int edge;				// and its edge, from b to a
+};
+
+struct horizonVisit_t {
+	int face;
+	int startEdge;
+	int numDone;
+};
+
+struct quickHull_t {
+	const Vec3 * pts;
+	float epsilon;			// anything closer than this to a plane counts as on it
+	int pass;
+
+	std::vector< hullFace_t > faces;
+	std::vector< int > freeFaces;		// removed faces, their slots and outside lists get reused
+	std::vector< int > pending;			// faces that might still have outside points
+	std::vector< int > visible;
+	std::vector< horizonEdge_t > horizon;
+	std::vector< horizonVisit_t > stack;
+	std::vector< int > newFaces;
+	std::vector< int > reassign;		// the outside points of a removed face, while they find a new one
+};
+
+/*
+================================
+QH_FaceDistance
+================================
+*/
+static float QH_FaceDistance( const hullFace_t & face, const Vec3 & pt ) {
+	return face.normal.Dot( pt ) - face.dist;
+}
+
+/*
+================================
+QH_TrianglePlane
+
+in double, the normal of a long thin triangle is mostly rounding in float, and a
+wrong normal lets points in front of it slip through as inside
+================================
+*/
+static void QH_TrianglePlane( const Vec3 & ptA, const Vec3 & ptB, const Vec3 & ptC, Vec3 & normalOut, float & distOut ) {
+	const double ab[ 3 ] = { (double)ptB.x - ptA.x, (double)ptB.y - ptA.y, (double)ptB.z - ptA.z };
+	const double ac[ 3 ] = { (double)ptC.x - ptA.x, (double)ptC.y - ptA.y, (double)ptC.z - ptA.z };
+	double normal[ 3 ] = {
+		ab[ 1 ] * ac[ 2 ] - ab[ 2 ] * ac[ 1 ],
+		ab[ 2 ] * ac[ 0 ] - ab[ 0 ] * ac[ 2 ],
+		ab[ 0 ] * ac[ 1 ] - ab[ 1 ] * ac[ 0 ],
+	};
+	const double length = sqrt( normal[ 0 ] * normal[ 0 ] + normal[ 1 ] * normal[ 1 ] + normal[ 2 ] * normal[ 2 ] );
+	if ( length > 0.0 ) {
+		normal[ 0 ] /= length;
+		normal[ 1 ] /= length;
+		normal[ 2 ] /= length;
+	}
+	normalOut = Vec3( (float)normal[ 0 ], (float)normal[ 1 ], (float)normal[ 2 ] );
+	distOut = (float)( normal[ 0 ] * ptA.x + normal[ 1 ] * ptA.y + normal[ 2 ] * ptA.z );
+}
+
+/*
+================================
+QH_AddFace
+================================
+*/
+static int QH_AddFace( quickHull_t & hull, const int a, const int b, const int c ) {
+	int faceIdx;
+	if ( !hull.freeFaces.empty() ) {
+		faceIdx = hull.freeFaces.back();
+		hull.freeFaces.pop_back();
+	} else {
+		faceIdx = (int)hull.faces.size();
+		hull.faces.push_back( hullFace_t() );
+	}
+
+	hullFace_t & face = hull.faces[ faceIdx ];
+	face.v[ 0 ] = a;
+	face.v[ 1 ] = b;
+	face.v[ 2 ] = c;
+	face.adjacent[ 0 ] = -1;
+	face.adjacent[ 1 ] = -1;
+	face.adjacent[ 2 ] = -1;
+
+	QH_TrianglePlane( hull.pts[ a ], hull.pts[ b ], hull.pts[ c ], face.normal, face.dist );
+	face.furthest = -1;
+	face.furthestDist = 0.0f;
+	face.visited = 0;
+	face.isVisible = false;
+	face.isAlive = true;
+	face.outside.clear();
+	return faceIdx;
+}
+
+/*
+================================
+QH_FindEdge
+
+the edge of a face that borders another face
+================================
+*/
+static int QH_FindEdge( const hullFace_t & face, const int neighbor ) {
+	for ( int i = 0; i < 3; i++ ) {
+		if ( face.adjacent[ i ] == neighbor ) {
+			return i;
+		}
+	}
+	assert( false );
+	return 0;
+}
+
+/*
+================================
+QH_IsFurther
+
+whether a point beats the one a face has lined up to add next. heights within
+epsilon of each other are a tie, and a tie goes to the point further from the
+middle of the face, which is always a corner of whatever they lie on. going by
+height alone picks the middle of a row of collinear points just as happily,
+and that one would then stay on the hull for good
+================================
+*/
+static bool QH_IsFurther( const quickHull_t & hull, const hullFace_t & face, const int ptIdx, const float dist ) {
+	if ( face.furthest < 0 || dist > face.furthestDist + hull.epsilon ) {
+		return true;
+	}
+	if ( dist < face.furthestDist - hull.epsilon ) {
+		return false;
+	}
+
+	const Vec3 center = ( hull.pts[ face.v[ 0 ] ] + hull.pts[ face.v[ 1 ] ] + hull.pts[ face.v[ 2 ] ] ) / 3.0f;
+	const Vec3 & current = hull.pts[ face.outside[ face.furthest ] ];
+	return ( hull.pts[ ptIdx ] - center ).GetLengthSqr() > ( current - center ).GetLengthSqr();
+}
+
+/*
+================================
+QH_AssignPoint
+
+puts a point in the conflict list of whichever face it's furthest in front of.
+points that aren't in front of any of them are inside the hull for good
+================================
+*/
+static void QH_AssignPoint( quickHull_t & hull, const int * faceIdxs, const int numFaces, const int ptIdx ) {
+	int bestFace = -1;
+	float bestDist = hull.epsilon;
+	for ( int i = 0; i < numFaces; i++ ) {
+		const float dist = QH_FaceDistance( hull.faces[ faceIdxs[ i ] ], hull.pts[ ptIdx ] );
+		if ( dist > bestDist ) {
+			bestDist = dist;
+			bestFace = faceIdxs[ i ];
+		}
+	}
+	if ( bestFace < 0 ) {
+		return;
+	}
+
+	hullFace_t & face = hull.faces[ bestFace ];
+	if ( QH_IsFurther( hull, face, ptIdx, bestDist ) ) {
+		face.furthest = (int)face.outside.size();
+		face.furthestDist = bestDist;
+	}
+	face.outside.push_back( ptIdx );
+}
+
+/*
+================================
+QH_BuildSimplex
+
+the starting tetrahedron, from the two points furthest apart along an axis, the
+point furthest from the line through them, and the point furthest from the plane
+through all three. false if the points don't span a volume
+================================
+*/
+static bool QH_BuildSimplex( quickHull_t & hull, const int num ) {
+	const Vec3 * pts = hull.pts;
+
+	int mins[ 3 ] = { 0, 0, 0 };
+	int maxs[ 3 ] = { 0, 0, 0 };
+	for ( int i = 1; i < num; i++ ) {
+		for ( int axis = 0; axis < 3; axis++ ) {
+			if ( pts[ i ][ axis ] < pts[ mins[ axis ] ][ axis ] ) {
+				mins[ axis ] = i;
+			}
+			if ( pts[ i ][ axis ] > pts[ maxs[ axis ] ][ axis ] ) {
+				maxs[ axis ] = i;
+			}
+		}
+	}
+
+	int longest = 0;
+	for ( int axis = 1; axis < 3; axis++ ) {
+		if ( pts[ maxs[ axis ] ][ axis ] - pts[ mins[ axis ] ][ axis ] > pts[ maxs[ longest ] ][ longest ] - pts[ mins[ longest ] ][ longest ] ) {
+			longest = axis;
+		}
+	}
+
+	int simplex[ 4 ];
+	simplex[ 0 ] = mins[ longest ];
+	simplex[ 1 ] = maxs[ longest ];
+	if ( pts[ simplex[ 1 ] ][ longest ] - pts[ simplex[ 0 ] ][ longest ] <= hull.epsilon ) {
+		return false;
+	}
+
+	Vec3 lineDir = pts[ simplex[ 1 ] ] - pts[ simplex[ 0 ] ];
+	lineDir.Normalize();
+	float maxDist = hull.epsilon;
+	simplex[ 2 ] = -1;
+	for ( int i = 0; i < num; i++ ) {
+		const float dist = ( pts[ i ] - pts[ simplex[ 0 ] ] ).Cross( lineDir ).GetMagnitude();
+		if ( dist > maxDist ) {
+			maxDist = dist;
+			simplex[ 2 ] = i;
+		}
+	}
+	if ( simplex[ 2 ] < 0 ) {
+		return false;
+	}
+
+	maxDist = hull.epsilon;
+	simplex[ 3 ] = -1;
+	for ( int i = 0; i < num; i++ ) {
+		const float dist = fabsf( DistanceFromTriangle( pts[ simplex[ 0 ] ], pts[ simplex[ 1 ] ], pts[ simplex[ 2 ] ], pts[ i ] ) );
+		if ( dist > maxDist ) {
+			maxDist = dist;
+			simplex[ 3 ] = i;
+		}
+	}
+	if ( simplex[ 3 ] < 0 ) {
+		return false;
+	}
+
+	// the fourth point has to end up behind the first face, for all of them to face outwards
+	if ( DistanceFromTriangle( pts[ simplex[ 0 ] ], pts[ simplex[ 1 ] ], pts[ simplex[ 2 ] ], pts[ simplex[ 3 ] ] ) > 0.0f ) {
+		std::swap( simplex[ 0 ], simplex[ 1 ] );
+	}
+
+	int faceIdxs[ 4 ];
+	faceIdxs[ 0 ] = QH_AddFace( hull, simplex[ 0 ], simplex[ 1 ], simplex[ 2 ] );
+	faceIdxs[ 1 ] = QH_AddFace( hull, simplex[ 0 ], simplex[ 2 ], simplex[ 3 ] );
+	faceIdxs[ 2 ] = QH_AddFace( hull, simplex[ 2 ], simplex[ 1 ], simplex[ 3 ] );
+	faceIdxs[ 3 ] = QH_AddFace( hull, simplex[ 1 ], simplex[ 0 ], simplex[ 3 ] );
+
+	// every edge a to b of one face is b to a of another
+	for ( int f = 0; f < 4; f++ ) {
+		hullFace_t & face = hull.faces[ faceIdxs[ f ] ];
+		for ( int e = 0; e < 3; e++ ) {
+			const int a = face.v[ e ];
+			const int b = face.v[ ( e + 1 ) % 3 ];
+			for ( int g = 0; g < 4; g++ ) {
+				const hullFace_t & other = hull.faces[ faceIdxs[ g ] ];
+				for ( int k = 0; k < 3; k++ ) {
+					if ( other.v[ k ] == b && other.v[ ( k + 1 ) % 3 ] == a ) {
+						face.adjacent[ e ] = faceIdxs[ g ];
+					}
+				}
+			}
+		}
+	}
+
+	for ( int i = 0; i < num; i++ ) {
+		if ( i == simplex[ 0 ] || i == simplex[ 1 ] || i == simplex[ 2 ] || i == simplex[ 3 ] ) {
+			continue;
+		}
+		QH_AssignPoint( hull, faceIdxs, 4, i );
+	}
+
+	for ( int f = 0; f < 4; f++ ) {
+		hull.pending.push_back( faceIdxs[ f ] );
+	}
+	return true;
+}
+
+/*
+================================
+QH_CanSee
+
+whether the eye sees a face across the edge from a to b of a face it already
+sees. a face the eye is level with ( within epsilon ) only counts if the new
+triangle from that edge to the eye would lie folded back over it, otherwise it
+stays and the new triangle gets merged into it
+================================
+*/
+static bool QH_CanSee( const quickHull_t & hull, const hullFace_t & face, const int a, const int b, const Vec3 & eye ) {
+	const float dist = QH_FaceDistance( face, eye );
+	if ( dist > hull.epsilon ) {
+		return true;
+	}
+	if ( dist < -hull.epsilon ) {
+		return false;
+	}
+
+	const Vec3 & ptA = hull.pts[ a ];
+	const Vec3 & ptB = hull.pts[ b ];
+	return ( ptB - ptA ).Cross( eye - ptA ).Dot( face.normal ) <= 0.0f;
+}
+
+/*
+================================
+QH_FindHorizon
+
+floods out from a face the eye can see, over every face it can see. the edges
+where that stops are the horizon, and walking each face's edges starting after
+the one it was entered by gives them in order around the hole, each one
+starting where the one before it ended
+================================
+*/
+static void QH_FindHorizon( quickHull_t & hull, const int startFace, const Vec3 & eye ) {
+	hull.pass++;
+	hull.visible.clear();
+	hull.horizon.clear();
+	hull.stack.clear();
+
+	hull.faces[ startFace ].visited = hull.pass;
+	hull.faces[ startFace ].isVisible = true;
+	hull.visible.push_back( startFace );
+	hull.stack.push_back( { startFace, 0, 0 } );
+
+	while ( !hull.stack.empty() ) {
+		horizonVisit_t & visit = hull.stack.back();
+		if ( visit.numDone == 3 ) {
+			hull.stack.pop_back();
+			continue;
+		}
+		const int faceIdx = visit.face;
+		const int e = ( visit.startEdge + visit.numDone ) % 3;
+		visit.numDone++;
+
+		const hullFace_t & face = hull.faces[ faceIdx ];
+		const int neighborIdx = face.adjacent[ e ];
+		hullFace_t & neighbor = hull.faces[ neighborIdx ];
+		if ( neighbor.visited != hull.pass ) {
+			neighbor.visited = hull.pass;
+			neighbor.isVisible = QH_CanSee( hull, neighbor, face.v[ e ], face.v[ ( e + 1 ) % 3 ], eye );
+			if ( neighbor.isVisible ) {
+				// the edge it was entered by counts as done
+				hull.visible.push_back( neighborIdx );
+				hull.stack.push_back( { neighborIdx, QH_FindEdge( neighbor, faceIdx ), 1 } );
+				continue;
+			}
+		}
+		if ( neighbor.isVisible ) {
+			continue;
+		}
+
+		horizonEdge_t edge;
+		edge.a = face.v[ e ];
+		edge.b = face.v[ ( e + 1 ) % 3 ];
+		edge.face = neighborIdx;
+		edge.edge = QH_FindEdge( neighbor, faceIdx );
+		hull.horizon.push_back( edge );
+	}
+}
+
+/*
+================================
+QH_AddPoint
+
+replaces everything the eye can see with a fan of triangles from the horizon to
+the eye. false if rounding left the horizon as something other than one loop,
+then nothing has changed and the point is just dropped, it can only be within a
+few epsilon of the hull anyway
+================================
+*/
+
+static bool QH_AddPoint( quickHull_t & hull, const int faceIdx, const int eyeIdx ) {
+	const Vec3 & eye = hull.pts[ eyeIdx ];
+	QH_FindHorizon( hull, faceIdx, eye );
+
+	const int numHorizon = (int)hull.horizon.size();
+	for ( int i = 0; i < numHorizon; i++ ) {
+		if ( hull.horizon[ i ].b != hull.horizon[ ( i + 1 ) % numHorizon ].a ) {
+			return false;
+		}
+	}
+
+	hull.newFaces.clear();
+	for ( int i = 0; i < numHorizon; i++ ) {
+		const horizonEdge_t & edge = hull.horizon[ i ];
+		const int newIdx = QH_AddFace( hull, edge.a, edge.b, eyeIdx );
+		hull.newFaces.push_back( newIdx );
+
+		hullFace_t & newFace = hull.faces[ newIdx ];
+		hullFace_t & across = hull.faces[ edge.face ];
+		newFace.adjacent[ 0 ] = edge.face;
+		across.adjacent[ edge.edge ] = newIdx;
+
+		// merge a new face that came out level with the one across the horizon into the same flat
+		// polygon. they share a plane from now on, so a later point sees both of them or neither,
+		// and can't carve a crease into what should be one flat side
+		if ( QH_FaceDistance( across, eye ) >= -hull.epsilon ) {
+			newFace.normal = across.normal;
+			newFace.dist = across.dist;
+		}
+	}
+
+	// the fan, each one's second edge runs along the next one's third
+	for ( int i = 0; i < numHorizon; i++ ) {
+		hull.faces[ hull.newFaces[ i ] ].adjacent[ 1 ] = hull.newFaces[ ( i + 1 ) % numHorizon ];
+		hull.faces[ hull.newFaces[ i ] ].adjacent[ 2 ] = hull.newFaces[ ( i + numHorizon - 1 ) % numHorizon ];
+	}
+
+	// the points the removed faces had go to the new faces, or are inside now
+	for ( int i = 0; i < hull.visible.size(); i++ ) {
+		hullFace_t & face = hull.faces[ hull.visible[ i ] ];
+		face.isAlive = false;
+
+		// copied out rather than moved, the face's slot keeps its list's memory for whichever face reuses it
+		hull.reassign.assign( face.outside.begin(), face.outside.end() );
+		face.outside.clear();
+		for ( int k = 0; k < hull.reassign.size(); k++ ) {
+			if ( hull.reassign[ k ] != eyeIdx ) {
+				QH_AssignPoint( hull, hull.newFaces.data(), numHorizon, hull.reassign[ k ] );
+			}
+		}
+		hull.freeFaces.push_back( hull.visible[ i ] );
+	}
+
+	for ( int i = 0; i < numHorizon; i++ ) {
+		if ( !hull.faces[ hull.newFaces[ i ] ].outside.empty() ) {
+			hull.pending.push_back( hull.newFaces[ i ] );
+		}
+	}
+	return true;
+}
+
+/*
+================================
+QH_DropPoint
+
+takes a point off a face's conflict list without adding it
+================================
+*/
+static void QH_DropPoint( quickHull_t & hull, const int faceIdx, const int outsideIdx ) {
+	hullFace_t & face = hull.faces[ faceIdx ];
+	face.outside[ outsideIdx ] = face.outside.back();
+	face.outside.pop_back();
+
+	face.furthest = -1;
+	face.furthestDist = 0.0f;
+	for ( int i = 0; i < face.outside.size(); i++ ) {
+		const float dist = QH_FaceDistance( face, hull.pts[ face.outside[ i ] ] );
+		if ( QH_IsFurther( hull, face, face.outside[ i ], dist ) ) {
+			face.furthest = i;
+			face.furthestDist = dist;
+		}
+	}
+}
+
+/*
+================================
+QH_IsCoplanar
+
+whether two faces are the same flat side, each one's corners within epsilon of the other's plane
+================================
+*/
+static bool QH_IsCoplanar( const quickHull_t & hull, const hullFace_t & faceA, const hullFace_t & faceB ) {
+	if ( faceA.normal.Dot( faceB.normal ) <= 0.0f ) {
+		return false;
+	}
+	for ( int k = 0; k < 3; k++ ) {
+		if ( fabsf( QH_FaceDistance( faceA, hull.pts[ faceB.v[ k ] ] ) ) > hull.epsilon ||
+			 fabsf( QH_FaceDistance( faceB, hull.pts[ faceA.v[ k ] ] ) ) > hull.epsilon ) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/*
+================================
+QH_FindCorners
+
+a point can get added while it's still outside, and only later turn out to sit
+in the middle of a flat side, or on a straight edge between two of them. a real
+corner has at least three different sides around it. true if anything other
+than corners made it onto the hull, the corners' indices are left in corners either way
+================================
+*/
+static bool QH_FindCorners( const quickHull_t & hull, const int num, std::vector< int > & corners ) {
+	// a face from each of the first two sides around each point, and a count that stops at three
+	std::vector< int > sides( num * 2 );
+	std::vector< int > numSides( num, 0 );
+	for ( int i = 0; i < hull.faces.size(); i++ ) {
+		const hullFace_t & face = hull.faces[ i ];
+		if ( !face.isAlive ) {
+			continue;
+		}
+		for ( int k = 0; k < 3; k++ ) {
+			const int v = face.v[ k ];
+			if ( numSides[ v ] > 2 ) {
+				continue;
+			}
+
+			bool isKnown = false;
+			for ( int j = 0; j < numSides[ v ]; j++ ) {
+				isKnown = isKnown || QH_IsCoplanar( hull, hull.faces[ sides[ v * 2 + j ] ], face );
+			}
+			if ( !isKnown ) {
+				if ( numSides[ v ] < 2 ) {
+					sides[ v * 2 + numSides[ v ] ] = i;
+				}
+				numSides[ v ]++;
+			}
+		}
+	}
+
+	bool hasRedundant = false;
+	for ( int v = 0; v < num; v++ ) {
+		if ( numSides[ v ] > 2 ) {
+			corners.push_back( v );
+		} else if ( numSides[ v ] > 0 ) {
+			hasRedundant = true;
+		}
+	}
+	return hasRedundant;
+}
+
+/*
+====================================================
+CalculateMassProperties
+
+exact center of mass and inertia tensor of the solid hull, per unit mass. every
+triangle makes a tetrahedron with a point inside the hull and the tetrahedra's
+volume, first and second moments have closed forms, so it's just a sum over them
+====================================================
+*/
+static void CalculateMassProperties( const std::vector< Vec3 > & pts, const std::vector< tri_t > & tris, Vec3 & cm, Mat3 & tensor ) {
+	cm.Zero();
+	tensor.Zero();
+	if ( pts.empty() || tris.empty() ) {
+		return;
+	}
+
+	// the moments go relative to a point near the middle, far from the origin they'd lose their precision
+	Vec3 ref( 0.0f );
+	for ( int i = 0; i < pts.size(); i++ ) {
+		ref += pts[ i ];
+	}
+	ref /= (float)pts.size();
+
+	// six times the volume, and the first and second moments each scaled by their own constant
+	double volume6 = 0.0;
+	double first[ 3 ] = { 0.0, 0.0, 0.0 };
+	double second[ 3 ][ 3 ] = { { 0.0, 0.0, 0.0 }, { 0.0, 0.0, 0.0 }, { 0.0, 0.0, 0.0 } };
+	for ( int t = 0; t < tris.size(); t++ ) {
+		const tri_t & tri = tris[ t ];
+		const Vec3 pa = pts[ tri.a ] - ref;
+		const Vec3 pb = pts[ tri.b ] - ref;
+		const Vec3 pc = pts[ tri.c ] - ref;
+		const double a[ 3 ] = { pa.x, pa.y, pa.z };
+		const double b[ 3 ] = { pb.x, pb.y, pb.z };
+		const double c[ 3 ] = { pc.x, pc.y, pc.z };
+
+		// signed volume of the tetrahedron ( ref, a, b, c ) times six
+		const double det =
+			a[ 0 ] * ( b[ 1 ] * c[ 2 ] - b[ 2 ] * c[ 1 ] ) +
+			a[ 1 ] * ( b[ 2 ] * c[ 0 ] - b[ 0 ] * c[ 2 ] ) +
+			a[ 2 ] * ( b[ 0 ] * c[ 1 ] - b[ 1 ] * c[ 0 ] );
+		volume6 += det;
+
+		double sum[ 3 ];
+		for ( int i = 0; i < 3; i++ ) {
+			sum[ i ] = a[ i ] + b[ i ] + c[ i ];
+			first[ i ] += det * sum[ i ];
+		}
+
+		// the covariance of a tetrahedron with a corner on the origin is det / 120 * ( sum( v v^T ) + sum( v ) sum( v )^T )
+		for ( int i = 0; i < 3; i++ ) {
+			for ( int j = 0; j < 3; j++ ) {
+				second[ i ][ j ] += det * ( a[ i ] * a[ j ] + b[ i ] * b[ j ] + c[ i ] * c[ j ] + sum[ i ] * sum[ j ] );
+			}
+		}
+	}
+
+	if ( volume6 <= 0.0 ) {
+		cm = ref;
+		return;
+	}
+
+	// the centroid of each tetrahedron is ( a + b + c ) / 4, weighted by its volume det / 6
+	double centroid[ 3 ];
+	for ( int i = 0; i < 3; i++ ) {
+		centroid[ i ] = first[ i ] / ( 4.0 * volume6 );
+	}
+
+	// covariance per unit volume, moved from ref onto the center of mass
+	double covariance[ 3 ][ 3 ];
+	for ( int i = 0; i < 3; i++ ) {
+		for ( int j = 0; j < 3; j++ ) {
+			covariance[ i ][ j ] = second[ i ][ j ] / ( 20.0 * volume6 ) - centroid[ i ] * centroid[ j ];
+		}
+	}
+
+	// the inertia tensor is trace( C ) * I - C
+	const double trace = covariance[ 0 ][ 0 ] + covariance[ 1 ][ 1 ] + covariance[ 2 ][ 2 ];
+	for ( int i = 0; i < 3; i++ ) {
+		for ( int j = 0; j < 3; j++ ) {
+			tensor.rows[ i ][ j ] = (float)( ( ( i == j ) ? trace : 0.0 ) - covariance[ i ][ j ] );
+		}
+	}
+
+	cm = ref + Vec3( (float)centroid[ 0 ], (float)centroid[ 1 ], (float)centroid[ 2 ] );
+}
+
+/*
+====================================================
+CalculatePointMassProperties
+
+for points that don't enclose a volume, all on a plane or a line or fewer than
+four of them. each point gets an equal share of the mass, and a little thickness
+so there's no axis without inertia, a tensor like that couldn't be inverted
+====================================================
+*/
+static void CalculatePointMassProperties( const std::vector< Vec3 > & pts, const Bounds & bounds, Vec3 & cm, Mat3 & tensor ) {
+	cm.Zero();
+	for ( int i = 0; i < pts.size(); i++ ) {
+		cm += pts[ i ];
+	}
+	cm /= (float)pts.size();
+
+	tensor.Zero();
+	for ( int i = 0; i < pts.size(); i++ ) {
+		const Vec3 pt = pts[ i ] - cm;
+		const float distSqr = pt.Dot( pt );
+		for ( int r = 0; r < 3; r++ ) {
+			for ( int c = 0; c < 3; c++ ) {
+				tensor.rows[ r ][ c ] += ( ( r == c ) ? distSqr : 0.0f ) - pt[ r ] * pt[ c ];
+			}
+		}
+	}
+	tensor *= 1.0f / (float)pts.size();
+
+	// a solid sphere's inertia is 2/5 r^2 about every axis
+	const float width = std::max( bounds.WidthX(), std::max( bounds.WidthY(), bounds.WidthZ() ) );
+	const float radius = std::max( POINT_CLOUD_RADIUS_SCALE * width, POINT_CLOUD_MIN_RADIUS );
+	for ( int i = 0; i < 3; i++ ) {
+		tensor.rows[ i ][ i ] += 0.4f * radius * radius;
+	}
+}
+
+#ifndef NDEBUG
+/*
+================================
+QH_IsConvex
+
+every point on the hull is behind every face, and no edge is folded. the tolerance
+comes from the size of the hull rather than from hull.epsilon, an epsilon that's
+too big is how a fold gets built in the first place. checking every point against
+every face is too slow for big hulls even in a debug build, those only get the
+edges checked, a closed mesh with no fold at any edge has no fold anywhere
+================================
+*/
+static bool QH_IsConvex( const quickHull_t & hull, const int num ) {
+	std::vector< int > hullPts;
+	std::vector< char > isOnHull( num, 0 );
+	Bounds bounds;
+	int numFaces = 0;
+	for ( int i = 0; i < hull.faces.size(); i++ ) {
+		const hullFace_t & face = hull.faces[ i ];
+		if ( !face.isAlive ) {
+			continue;
+		}
+		numFaces++;
+		for ( int k = 0; k < 3; k++ ) {
+			if ( !isOnHull[ face.v[ k ] ] ) {
+				isOnHull[ face.v[ k ] ] = 1;
+				hullPts.push_back( face.v[ k ] );
+				bounds.Expand( hull.pts[ face.v[ k ] ] );
+			}
+		}
+	}
+
+	const float size = 0.5f * ( bounds.WidthX() + bounds.WidthY() + bounds.WidthZ() );
+	const float tolerance = HULL_VALIDATE_TOLERANCE * HULL_EPSILON_SCALE * FLT_EPSILON * size;
+	const bool checkAll = double( hullPts.size() ) * double( numFaces ) <= HULL_VALIDATE_MAX_WORK;
+	for ( int i = 0; i < hull.faces.size(); i++ ) {
+		const hullFace_t & face = hull.faces[ i ];
+		if ( !face.isAlive ) {
+			continue;
+		}
+
+		if ( checkAll ) {
+			for ( int j = 0; j < hullPts.size(); j++ ) {
+				if ( QH_FaceDistance( face, hull.pts[ hullPts[ j ] ] ) > tolerance ) {
+					return false;
+				}
+			}
+		}
+
+		// against the planes the triangles really have, a face merged into a flat side keeps the side's
+		// plane, and that's just what hides a fold. the plane of a sliver tilts a long way for a tiny
+		// shift of its point though, so it can have the face across it in front. an edge only really
+		// folds if each face has the other in front
+		Vec3 normal;
+		float dist;
+		QH_TrianglePlane( hull.pts[ face.v[ 0 ] ], hull.pts[ face.v[ 1 ] ], hull.pts[ face.v[ 2 ] ], normal, dist );
+		for ( int k = 0; k < 3; k++ ) {
+			const hullFace_t & across = hull.faces[ face.adjacent[ k ] ];
+			Vec3 acrossNormal;
+			float acrossDist;
+			QH_TrianglePlane( hull.pts[ across.v[ 0 ] ], hull.pts[ across.v[ 1 ] ], hull.pts[ across.v[ 2 ] ], acrossNormal, acrossDist );
+
+			const Vec3 & acrossPt = hull.pts[ across.v[ ( QH_FindEdge( across, i ) + 2 ) % 3 ] ];
+			const Vec3 & facePt = hull.pts[ face.v[ ( k + 2 ) % 3 ] ];
+			const float acrossInFront = normal.Dot( acrossPt ) - dist;
+			const float faceInFront = acrossNormal.Dot( facePt ) - acrossDist;
+			if ( std::min( acrossInFront, faceInFront ) > tolerance ) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+#endif
+
+/*
+================================
+QH_Build
+
+false if some of the points on the hull turned out not to be corners, the corners
+are in corners then and the hull should be built again from just them
+================================
+*/
+static bool QH_Build( const std::vector< Vec3 > & verts, std::vector< Vec3 > & hullPts, std::vector< tri_t > & hullTris, std::vector< Vec3 > * corners ) {
+	const int num = (int)verts.size();
+
+	// built around the middle of the points, far from the origin the plane distances would be
+	// mostly rounding. the rounding that's left grows with the size of the hull, and so does epsilon
+	Bounds bounds;
+	bounds.Expand( verts.data(), num );
+	const Vec3 center = ( bounds.mins + bounds.maxs ) * 0.5f;
+	std::vector< Vec3 > local( num );
+	Vec3 maxAbs( 0.0f );
+	for ( int i = 0; i < num; i++ ) {
+		local[ i ] = verts[ i ] - center;
+		maxAbs.x = std::max( maxAbs.x, fabsf( local[ i ].x ) );
+		maxAbs.y = std::max( maxAbs.y, fabsf( local[ i ].y ) );
+		maxAbs.z = std::max( maxAbs.z, fabsf( local[ i ].z ) );
+	}
+
+	quickHull_t hull;
+	hull.pts = local.data();
+	hull.pass = 0;
+	hull.epsilon = HULL_EPSILON_SCALE * FLT_EPSILON * ( maxAbs.x + maxAbs.y + maxAbs.z );
+
+	// flat or worse, there's no hull
+	if ( !QH_BuildSimplex( hull, num ) ) {
+		return true;
+	}
+
+	while ( !hull.pending.empty() ) {
+		const int faceIdx = hull.pending.back();
+		const hullFace_t & face = hull.faces[ faceIdx ];
+		if ( !face.isAlive || face.outside.empty() ) {
+			hull.pending.pop_back();
+			continue;
+		}
+
+		const int outsideIdx = face.furthest;
+		if ( !QH_AddPoint( hull, faceIdx, face.outside[ outsideIdx ] ) ) {
+			QH_DropPoint( hull, faceIdx, outsideIdx );
+		}
+	}
+
+	assert( QH_IsConvex( hull, num ) );
+
+	if ( corners != nullptr ) {
+		std::vector< int > cornerIdxs;
+		if ( QH_FindCorners( hull, num, cornerIdxs ) ) {
+			for ( int i = 0; i < cornerIdxs.size(); i++ ) {
+				corners->push_back( verts[ cornerIdxs[ i ] ] );
+			}
+			return false;
+		}
+	}
+
+	// only the points the faces use, in the order they're first used
+	std::vector< int > remap( num, -1 );
+	for ( int i = 0; i < hull.faces.size(); i++ ) {
+		const hullFace_t & face = hull.faces[ i ];
+		if ( !face.isAlive ) {
+			continue;
+		}
+
+		int v[ 3 ];
+		for ( int k = 0; k < 3; k++ ) {
+			if ( remap[ face.v[ k ] ] < 0 ) {
+				remap[ face.v[ k ] ] = (int)hullPts.size();
+				hullPts.push_back( verts[ face.v[ k ] ] );
+			}
+			v[ k ] = remap[ face.v[ k ] ];
+		}
+
+		tri_t tri;
+		tri.a = v[ 0 ];
+		tri.b = v[ 1 ];
+		tri.c = v[ 2 ];
+		hullTris.push_back( tri );
+	}
+	return true;
+}
+
+/*
+====================================================
+BuildConvexHull
+
+quickhull. starting from a tetrahedron, every point is filed under a face it's in
+front of, and the point furthest in front of a face is added next, which swallows
+everything between it and the old hull. points that end up behind every face are
+never looked at again, so the cost goes with the points on the hull instead of
+all of them times all the triangles
+====================================================
+*/
+void BuildConvexHull( const std::vector< Vec3 > & verts, std::vector< Vec3 > & hullPts, std::vector< tri_t > & hullTris ) {
+	hullPts.clear();
+	hullTris.clear();
+	if ( verts.size() < 4 ) {
+		return;
+	}
+
+	// the second time around there's nothing but corners, and nothing gets added that isn't one
+	std::vector< Vec3 > corners;
+	if ( !QH_Build( verts, hullPts, hullTris, &corners ) ) {
+		hullPts.clear();
+		hullTris.clear();
+		QH_Build( corners, hullPts, hullTris, nullptr );
+	}
+}
+
+/*
+========================================================================================================
+
+ShapeConvex
+
+========================================================================================================
+*/
+
+/*
+====================================================
+ShapeConvex::Build
+====================================================
+*/
+void ShapeConvex::Build( const Vec3 * pts, const int num ) {
+	assert( num > 0 );
+
+	m_points.clear();
+	m_points.reserve( num );
+	for ( int i = 0; i < num; i++ ) {
+		m_points.push_back( pts[ i ] );
+	}
+
+	// Expand into a convex hull
+	std::vector< Vec3 > hullPoints;
+	std::vector< tri_t > hullTriangles;
+	BuildConvexHull( m_points, hullPoints, hullTriangles );
+
+	// no volume to take the hull of, the points themselves are what Support searches then
+	const bool isDegenerate = hullTriangles.empty();
+	if ( !isDegenerate ) {
+		m_points = hullPoints;
+	}
+
+	// Expand the bounds
+	m_bounds.Clear();
+	m_bounds.Expand( m_points.data(), (int)m_points.size() );
+
+	if ( isDegenerate ) {
+		CalculatePointMassProperties( m_points, m_bounds, m_centerOfMass, m_inertiaTensor );
+	} else {
+		CalculateMassProperties( hullPoints, hullTriangles, m_centerOfMass, m_inertiaTensor );
+	}
+
+	// the padding repeats the first point, so it can only ever tie with it
+	const int numPoints = (int)m_points.size();
+	const int padded = ( ( numPoints + SIMD_WIDTH - 1 ) / SIMD_WIDTH ) * SIMD_WIDTH;
+	m_pointsX.resize( padded );
+	m_pointsY.resize( padded );
+	m_pointsZ.resize( padded );
+	for ( int i = 0; i < padded; i++ ) {
+		const Vec3 & pt = m_points[ ( i < numPoints ) ? i : 0 ];
+		m_pointsX[ i ] = pt.x;
+		m_pointsY[ i ] = pt.y;
+		m_pointsZ[ i ] = pt.z;
+	}
+
+	BuildAdjacency( hullTriangles );
+	m_lastSupport.store( 0, std::memory_order_relaxed );
+}
+
+/*
+====================================================
+ShapeConvex::BuildAdjacency
+
+every edge of a closed hull is shared by two triangles that wind it in opposite
+directions, so taking each triangle's three directed edges lists every neighbor
+exactly once without having to look for duplicates
+====================================================
+*/
+void ShapeConvex::BuildAdjacency( const std::vector< tri_t > & tris ) {
+	const int num = (int)m_points.size();
+	m_neighborOffsets.assign( num + 1, 0 );
+	m_neighbors.resize( tris.size() * 3 );
+
+	for ( int i = 0; i < tris.size(); i++ ) {
+		m_neighborOffsets[ tris[ i ].a + 1 ]++;
+		m_neighborOffsets[ tris[ i ].b + 1 ]++;
+		m_neighborOffsets[ tris[ i ].c + 1 ]++;
+	}
+	for ( int i = 0; i < num; i++ ) {
+		m_neighborOffsets[ i + 1 ] += m_neighborOffsets[ i ];
+	}
+
+	std::vector< int > fill( m_neighborOffsets.begin(), m_neighborOffsets.end() - 1 );
+	for ( int i = 0; i < tris.size(); i++ ) {
+		const tri_t & tri = tris[ i ];
+		m_neighbors[ fill[ tri.a ]++ ] = tri.b;
+		m_neighbors[ fill[ tri.b ]++ ] = tri.c;
+		m_neighbors[ fill[ tri.c ]++ ] = tri.a;
+	}
+}
+
+/*
+====================================================
+ShapeConvex::FindSupportPointLinear
+
+every point, SIMD_WIDTH at a time. the lanes keep their first best, and the
+reduction prefers the lower index on a tie, so this picks the same point a
+plain loop would
+====================================================
+*/
+int ShapeConvex::FindSupportPointLinear( const Vec3 & dir ) const {
+	static const float laneOffsets[ 8 ] = { 0, 1, 2, 3, 4, 5, 6, 7 };
+
+	const simdf_t dirX( dir.x );
+	const simdf_t dirY( dir.y );
+	const simdf_t dirZ( dir.z );
+	const simdf_t step( (float)SIMD_WIDTH );
+
+	simdf_t bestDist( -FLT_MAX );
+	simdf_t bestIdx( 0.0f );
+	simdf_t idx;
+	SimdLoad( idx, laneOffsets );
+
+	const int padded = (int)m_pointsX.size();
+	for ( int i = 0; i < padded; i += SIMD_WIDTH ) {
+		simdf_t x, y, z;
+		SimdLoad( x, m_pointsX.data() + i );
+		SimdLoad( y, m_pointsY.data() + i );
+		SimdLoad( z, m_pointsZ.data() + i );
+
+		const simdf_t dist = x * dirX + y * dirY + z * dirZ;
+		const simdf_t isBetter = SimdLess( bestDist, dist );
+		bestDist = SimdSelect( isBetter, dist, bestDist );
+		bestIdx = SimdSelect( isBetter, idx, bestIdx );
+		idx = idx + step;
+	}
+
+	float dists[ SIMD_WIDTH ];
+	float idxs[ SIMD_WIDTH ];
+	SimdStore( bestDist, dists );
+	SimdStore( bestIdx, idxs );
+
+	int maxLane = 0;
+	for ( int k = 1; k < SIMD_WIDTH; k++ ) {
+		if ( dists[ k ] > dists[ maxLane ] || ( dists[ k ] == dists[ maxLane ] && idxs[ k ] < idxs[ maxLane ] ) ) {
+			maxLane = k;
+		}
+	}
+	const int maxIdx = (int)idxs[ maxLane ];
+	return ( maxIdx < (int)m_points.size() ) ? maxIdx : 0;
+}
+
+/*
+====================================================
+ShapeConvex::FindSupportPointHillClimb
+
+walks the edge graph towards dir until no neighbor is any further along it. on a
+convex hull a point that beats all its neighbors beats every point, so this
+finds the same support as the linear scan, usually in a step or two when the
+start is the answer to a nearby dir
+====================================================
+*/
+int ShapeConvex::FindSupportPointHillClimb( const Vec3 & dir, const int startIdx ) const {
+	int maxIdx = startIdx;
+	float maxDist = dir.Dot( m_points[ maxIdx ] );
+
+	int current = -1;
+	while ( current != maxIdx ) {
+		current = maxIdx;
+
+		const int end = m_neighborOffsets[ current + 1 ];
+		for ( int i = m_neighborOffsets[ current ]; i < end; i++ ) {
+			const int neighbor = m_neighbors[ i ];
+			const float dist = dir.Dot( m_points[ neighbor ] );
+			if ( dist > maxDist ) {
+				maxDist = dist;
+				maxIdx = neighbor;
+			}
+		}
+	}
+	return maxIdx;
+}
+
+/*
+====================================================
+ShapeConvex::FindSupportPoint
+====================================================
+*/
+int ShapeConvex::FindSupportPoint( const Vec3 & dir ) const {
+	// a degenerate shape has no edge graph to climb
+	if ( m_points.size() < HILL_CLIMB_MIN_POINTS || m_neighbors.empty() ) {
+		return FindSupportPointLinear( dir );
+	}
+
+	// two threads racing on the hint only cost each other a few extra steps, any start gets to the answer
+	const int startIdx = m_lastSupport.load( std::memory_order_relaxed );
+	const int maxIdx = FindSupportPointHillClimb( dir, startIdx );
+	m_lastSupport.store( maxIdx, std::memory_order_relaxed );
+
+#ifndef NDEBUG
+	// the climb only finds the furthest point if the hull really is convex, a fold leaves it stuck short
+	const float scale = std::max( m_bounds.mins.GetMagnitude(), m_bounds.maxs.GetMagnitude() ) * dir.GetMagnitude();
+	const float tolerance = HULL_VALIDATE_TOLERANCE * HULL_EPSILON_SCALE * FLT_EPSILON * scale;
+	assert( dir.Dot( m_points[ maxIdx ] ) >= dir.Dot( m_points[ FindSupportPointLinear( dir ) ] ) - tolerance );
+#endif
+	return maxIdx;
+}
+
+/*
+====================================================
+ShapeConvex::Support
+
+searches in local space, one rotation of dir instead of one per point
+====================================================
+*/
+Vec3 ShapeConvex::Support( const Vec3 & dir, const Vec3 & pos, const Quat & orient, const float bias ) const {
+	const Vec3 localDir = orient.Inverse().RotatePoint( dir );
+	const Vec3 & maxPt = m_points[ FindSupportPoint( localDir ) ];
+	return orient.RotatePoint( maxPt ) + pos + dir * bias;
+}
+
+/*
+====================================================
+ShapeConvex::GetBounds
+====================================================
+*/
+Bounds ShapeConvex::GetBounds( const Vec3 & pos, const Quat & orient ) const {
+	Vec3 corners[ 8 ];
+	corners[ 0 ] = Vec3( m_bounds.mins.x, m_bounds.mins.y, m_bounds.mins.z );
+	corners[ 1 ] = Vec3( m_bounds.mins.x, m_bounds.mins.y, m_bounds.maxs.z );
+	corners[ 2 ] = Vec3( m_bounds.mins.x, m_bounds.maxs.y, m_bounds.mins.z );
+	corners[ 3 ] = Vec3( m_bounds.maxs.x, m_bounds.mins.y, m_bounds.mins.z );
+
+	corners[ 4 ] = Vec3( m_bounds.maxs.x, m_bounds.maxs.y, m_bounds.maxs.z );
+	corners[ 5 ] = Vec3( m_bounds.maxs.x, m_bounds.maxs.y, m_bounds.mins.z );
+	corners[ 6 ] = Vec3( m_bounds.maxs.x, m_bounds.mins.y, m_bounds.maxs.z );
+	corners[ 7 ] = Vec3( m_bounds.mins.x, m_bounds.maxs.y, m_bounds.maxs.z );
+
+	Bounds bounds;
+	for ( int i = 0; i < 8; i++ ) {
+		corners[ i ] = orient.RotatePoint( corners[ i ] ) + pos;
+		bounds.Expand( corners[ i ] );
+	}
+
+	return bounds;
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+//
+//	ShapeConvex.h
+//
+#pragma once
+#include "ShapeBase.h"
+#include <atomic>
+
+struct tri_t {
+	int a;
+	int b;
+	int c;
+};
+
+void BuildConvexHull( const std::vector< Vec3 > & verts, std::vector< Vec3 > & hullPts, std::vector< tri_t > & hullTris );
+
+/*
+====================================================
+ShapeConvex
+====================================================
+*/
+class ShapeConvex : public Shape {
+public:
+	explicit ShapeConvex( const Vec3 * pts, const int num ) : m_lastSupport( 0 ) {
+		Build( pts, num );
+	}
+	void Build( const Vec3 * pts, const int num );
+
+	Vec3 Support( const Vec3 & dir, const Vec3 & pos, const Quat & orient, const float bias ) const override;
+
+	Mat3 InertiaTensorGeometric() const override { return m_inertiaTensor; }
+
+	Bounds GetBounds( const Vec3 & pos, const Quat & orient ) const override;
+	Bounds GetBounds() const override { return m_bounds; }
+
+	shapeType_t GetType() const override { return SHAPE_CONVEX; }
+
+	// index of the hull point furthest along a local space dir
+	int FindSupportPoint( const Vec3 & dir ) const;
+	int FindSupportPointLinear( const Vec3 & dir ) const;
+	int FindSupportPointHillClimb( const Vec3 & dir, const int startIdx ) const;
+
+private:
+	void BuildAdjacency( const std::vector< tri_t > & tris );
+
+public:
+	std::vector< Vec3 > m_points;
+	Bounds m_bounds;
+	Mat3 m_inertiaTensor;
+
+	// the hull points again, one padded stream per component, for the SIMD scan
+	std::vector< float > m_pointsX;
+	std::vector< float > m_pointsY;
+	std::vector< float > m_pointsZ;
+
+	// the hull's edge graph, the neighbors of point i are m_neighbors[ m_neighborOffsets[ i ] ] up to m_neighborOffsets[ i + 1 ]
+	std::vector< int > m_neighborOffsets;
+	std::vector< int > m_neighbors;
+
+private:
+	// where the last hill climb ended up, only ever a starting guess so it's shared by every body and thread using the shape
+	mutable std::atomic< int > m_lastSupport;
+};
\ No newline at end of file
@@ -13,6 +13,17 @@ ShapeLoadedMesh
 ========================================================================================================
 */
 
+/*
+====================================================
+ShapeLoadedMesh::Support
+
+same bounding sphere as the bounds below, until this shape gets a real hull
+====================================================
+*/
+Vec3 ShapeLoadedMesh::Support( const Vec3 & dir, const Vec3 & pos, const Quat & orient, const float bias ) const {
+	return ( pos + dir * ( m_radius + bias ) );
+}
+
 /*
 ====================================================
 ShapeLoadedMesh::InertiaTensor
@@ -27,6 +27,8 @@ public:
 		assert( nBones <= 80 );
 		matrixPalette.resize( nBones );
 	}
+	Vec3 Support( const Vec3 & dir, const Vec3 & pos, const Quat & orient, const float bias ) const override;
+
 	Mat3 InertiaTensorGeometric() const override;
 
 	Bounds GetBounds( const Vec3 & pos, const Quat & orient ) const override;
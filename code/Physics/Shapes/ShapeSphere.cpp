@@ -11,6 +11,15 @@ ShapeSphere
 ========================================================================================================
 */
 
+/*
+====================================================
+ShapeSphere::Support
+====================================================
+*/
+Vec3 ShapeSphere::Support( const Vec3 & dir, const Vec3 & pos, const Quat & orient, const float bias ) const {
+	return ( pos + dir * ( m_radius + bias ) );
+}
+
 /*
 ====================================================
 ShapeSphere::InertiaTensor
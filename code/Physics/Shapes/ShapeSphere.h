@@ -14,6 +14,8 @@ public:
 	explicit ShapeSphere( const float radius ) : m_radius( radius ) {
 		m_centerOfMass.Zero();
 	}
+	Vec3 Support( const Vec3 & dir, const Vec3 & pos, const Quat & orient, const float bias ) const override;
+
 	Mat3 InertiaTensorGeometric() const override;
 
 	Bounds GetBounds( const Vec3 & pos, const Quat & orient ) const override;
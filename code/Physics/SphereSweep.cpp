@@ -0,0 +1,427 @@
+//
+//	SphereSweep.cpp
+//
+#include "SphereSweep.h"
+#include "Intersections.h"
+#include "Shapes.h"
+#include "../Math/Simd.h"
+#include "../Config.h"
+#include <algorithm>
+#include <chrono>
+#include <type_traits>
+#include <stdio.h>
+#include <stdlib.h>
+
+/*
+====================================================
+ToBodySpace
+
+rotates the offset r of a point from the body's position into body space,
+with the orientation the body will have after spinning at w for time t.
+the same math as Body::PredictState followed by WorldSpaceToBodySpace, for
+a sphere ( its center of mass is its position, and it has no gyroscopic
+term ). returns false without writing anything if the rotation is too big
+for the polynomials
+====================================================
+*/
+template< typename lane_t >
+static bool ToBodySpace( const lane_t & qw, const lane_t & qx, const lane_t & qy, const lane_t & qz,
+						 const lane_t & wx, const lane_t & wy, const lane_t & wz, const lane_t & t,
+						 const lane_t & rx, const lane_t & ry, const lane_t & rz,
+						 lane_t & outX, lane_t & outY, lane_t & outZ ) {
+	const lane_t dx = wx * t;
+	const lane_t dy = wy * t;
+	const lane_t dz = wz * t;
+	const lane_t h2 = 0.25f * ( dx * dx + dy * dy + dz * dz );
+	if ( !std::is_same< lane_t, float >::value && SimdAnyGreater( h2, MAX_POLY_HALF_ANGLE_SQR ) ) {
+		return false;
+	}
+	lane_t cosH, sincH;
+	SimdHalfAngleCosSinc( h2, cosH, sincH );
+	const lane_t dqw = cosH;
+	const lane_t dqx = dx * ( 0.5f * sincH );
+	const lane_t dqy = dy * ( 0.5f * sincH );
+	const lane_t dqz = dz * ( 0.5f * sincH );
+
+	lane_t nw = dqw * qw - dqx * qx - dqy * qy - dqz * qz;
+	lane_t nx = dqx * qw + dqw * qx + dqy * qz - dqz * qy;
+	lane_t ny = dqy * qw + dqw * qy + dqz * qx - dqx * qz;
+	lane_t nz = dqz * qw + dqw * qz + dqx * qy - dqy * qx;
+	const lane_t invMag = 1.0f / SimdSqrt( nw * nw + nx * nx + ny * ny + nz * nz );
+	nw = nw * invMag;
+	nx = nx * invMag;
+	ny = ny * invMag;
+	nz = nz * invMag;
+
+	// by the inverse of the new orientation, v' = v + w * t + u X t, with u = -xyz and t = 2 * ( u X v )
+	const lane_t ux = -nx;
+	const lane_t uy = -ny;
+	const lane_t uz = -nz;
+	const lane_t t0 = 2.0f * ( uy * rz - uz * ry );
+	const lane_t t1 = 2.0f * ( uz * rx - ux * rz );
+	const lane_t t2 = 2.0f * ( ux * ry - uy * rx );
+	outX = rx + nw * t0 + ( uy * t2 - uz * t1 );
+	outY = ry + nw * t1 + ( uz * t0 - ux * t2 );
+	outZ = rz + nw * t2 + ( ux * t1 - uy * t0 );
+	return true;
+}
+
+/*
+====================================================
+SweepLanes
+
+SphereSphereDynamic plus the rest of Intersect, for lane_t::WIDTH pairs
+( or one, for floats ). every branch of the scalar version is computed for
+every lane and picked with a mask instead. returns false without touching
+anything if one of the bodies spins too far for the polynomials
+====================================================
+*/
+template< typename lane_t >
+static bool SweepLanes( float * const * streams, const int lane, const float dt_sec ) {
+	lane_t pax, pay, paz, pbx, pby, pbz, vax, vay, vaz, vbx, vby, vbz;
+	lane_t qaw, qax, qay, qaz, qbw, qbx, qby, qbz;
+	lane_t wax, way, waz, wbx, wby, wbz, ra, rb;
+	SimdLoad( pax, streams[ SphereSweepBatch::POS_A_X ] + lane );
+	SimdLoad( pay, streams[ SphereSweepBatch::POS_A_Y ] + lane );
+	SimdLoad( paz, streams[ SphereSweepBatch::POS_A_Z ] + lane );
+	SimdLoad( pbx, streams[ SphereSweepBatch::POS_B_X ] + lane );
+	SimdLoad( pby, streams[ SphereSweepBatch::POS_B_Y ] + lane );
+	SimdLoad( pbz, streams[ SphereSweepBatch::POS_B_Z ] + lane );
+	SimdLoad( vax, streams[ SphereSweepBatch::VEL_A_X ] + lane );
+	SimdLoad( vay, streams[ SphereSweepBatch::VEL_A_Y ] + lane );
+	SimdLoad( vaz, streams[ SphereSweepBatch::VEL_A_Z ] + lane );
+	SimdLoad( vbx, streams[ SphereSweepBatch::VEL_B_X ] + lane );
+	SimdLoad( vby, streams[ SphereSweepBatch::VEL_B_Y ] + lane );
+	SimdLoad( vbz, streams[ SphereSweepBatch::VEL_B_Z ] + lane );
+	SimdLoad( qaw, streams[ SphereSweepBatch::ORIENT_A_W ] + lane );
+	SimdLoad( qax, streams[ SphereSweepBatch::ORIENT_A_X ] + lane );
+	SimdLoad( qay, streams[ SphereSweepBatch::ORIENT_A_Y ] + lane );
+	SimdLoad( qaz, streams[ SphereSweepBatch::ORIENT_A_Z ] + lane );
+	SimdLoad( qbw, streams[ SphereSweepBatch::ORIENT_B_W ] + lane );
+	SimdLoad( qbx, streams[ SphereSweepBatch::ORIENT_B_X ] + lane );
+	SimdLoad( qby, streams[ SphereSweepBatch::ORIENT_B_Y ] + lane );
+	SimdLoad( qbz, streams[ SphereSweepBatch::ORIENT_B_Z ] + lane );
+	SimdLoad( wax, streams[ SphereSweepBatch::ANG_VEL_A_X ] + lane );
+	SimdLoad( way, streams[ SphereSweepBatch::ANG_VEL_A_Y ] + lane );
+	SimdLoad( waz, streams[ SphereSweepBatch::ANG_VEL_A_Z ] + lane );
+	SimdLoad( wbx, streams[ SphereSweepBatch::ANG_VEL_B_X ] + lane );
+	SimdLoad( wby, streams[ SphereSweepBatch::ANG_VEL_B_Y ] + lane );
+	SimdLoad( wbz, streams[ SphereSweepBatch::ANG_VEL_B_Z ] + lane );
+	SimdLoad( ra, streams[ SphereSweepBatch::RADIUS_A ] + lane );
+	SimdLoad( rb, streams[ SphereSweepBatch::RADIUS_B ] + lane );
+	const lane_t dt = dt_sec;
+	const lane_t zero = 0.0f;
+
+	// 1. A's path relative to B, as a ray against a sphere of both radii around B
+	const lane_t pathX = ( pax + ( vax - vbx ) * dt ) - pax;
+	const lane_t pathY = ( pay + ( vay - vby ) * dt ) - pay;
+	const lane_t pathZ = ( paz + ( vaz - vbz ) * dt ) - paz;
+	const lane_t pathSqr = pathX * pathX + pathY * pathY + pathZ * pathZ;
+	const lane_t abX = pbx - pax;
+	const lane_t abY = pby - pay;
+	const lane_t abZ = pbz - paz;
+	const lane_t abSqr = abX * abX + abY * abY + abZ * abZ;
+	const lane_t radii = ra + rb;
+
+	// 2. RaySphere, a * t^2 - 2 * b * t + c = 0
+	const lane_t b = abX * pathX + abY * pathY + abZ * pathZ;
+	const lane_t c = abSqr - radii * radii;
+	const lane_t discriminant = b * b - pathSqr * c;
+	const lane_t sqrtDiscriminant = SimdSqrt( SimdMax( discriminant, zero ) );
+	const lane_t invA = 1.0f / pathSqr;
+	lane_t t0 = ( invA * ( b - sqrtDiscriminant ) ) * dt;
+	lane_t t1 = ( invA * ( b + sqrtDiscriminant ) ) * dt;
+
+	// too short a ray is just an overlap test, at time 0
+	const auto isShort = SimdLess( pathSqr, lane_t( 0.001f * 0.001f ) );
+	const lane_t shortRadii = radii + 0.001f;
+	t0 = SimdSelect( isShort, zero, t0 );
+	t1 = SimdSelect( isShort, zero, t1 );
+	const auto touches = SimdSelect( isShort, SimdLessEqual( abSqr, shortRadii * shortRadii ), SimdLessEqual( zero, discriminant ) );
+
+	// 3. the earliest time of impact, clamped to the start of the step, has to be within it
+	const lane_t toi = SimdMax( t0, zero );
+	const auto hit = SimdAnd( touches, SimdAnd( SimdLessEqual( zero, t1 ), SimdLessEqual( toi, dt ) ) );
+
+	// most pairs the broadphase hands over don't touch, nothing else gets read for a batch that misses entirely
+	if ( SimdMoveMask( hit ) == 0 ) {
+		SimdStore( zero, streams[ SphereSweepBatch::HIT ] + lane );
+		return true;
+	}
+
+	// 4. the bodies at the time of impact, and the points on their surfaces facing each other
+	const lane_t toiAX = pax + vax * toi;
+	const lane_t toiAY = pay + vay * toi;
+	const lane_t toiAZ = paz + vaz * toi;
+	const lane_t toiBX = pbx + vbx * toi;
+	const lane_t toiBY = pby + vby * toi;
+	const lane_t toiBZ = pbz + vbz * toi;
+	lane_t dirX = toiBX - toiAX;
+	lane_t dirY = toiBY - toiAY;
+	lane_t dirZ = toiBZ - toiAZ;
+	const lane_t dirSqr = dirX * dirX + dirY * dirY + dirZ * dirZ;
+	const lane_t invDirMag = SimdSelect( SimdLess( zero, dirSqr ), 1.0f / SimdSqrt( dirSqr ), lane_t( 1.0f ) );		// Vec3::Normalize leaves zero alone
+	dirX = dirX * invDirMag;
+	dirY = dirY * invDirMag;
+	dirZ = dirZ * invDirMag;
+
+	// 5. contact points in body space, with the bodies rotated to the time of impact
+	const lane_t offsetAX = dirX * ra;
+	const lane_t offsetAY = dirY * ra;
+	const lane_t offsetAZ = dirZ * ra;
+	const lane_t offsetBX = -dirX * rb;
+	const lane_t offsetBY = -dirY * rb;
+	const lane_t offsetBZ = -dirZ * rb;
+	lane_t localAX, localAY, localAZ, localBX, localBY, localBZ;
+	if ( !ToBodySpace( qaw, qax, qay, qaz, wax, way, waz, toi, offsetAX, offsetAY, offsetAZ, localAX, localAY, localAZ ) ) {
+		return false;
+	}
+	if ( !ToBodySpace( qbw, qbx, qby, qbz, wbx, wby, wbz, toi, offsetBX, offsetBY, offsetBZ, localBX, localBY, localBZ ) ) {
+		return false;
+	}
+
+	SimdStore( SimdSelect( hit, lane_t( 1.0f ), zero ), streams[ SphereSweepBatch::HIT ] + lane );
+	SimdStore( toi, streams[ SphereSweepBatch::TIME_OF_IMPACT ] + lane );
+	SimdStore( -dirX, streams[ SphereSweepBatch::NORMAL_X ] + lane );
+	SimdStore( -dirY, streams[ SphereSweepBatch::NORMAL_Y ] + lane );
+	SimdStore( -dirZ, streams[ SphereSweepBatch::NORMAL_Z ] + lane );
+	SimdStore( toiAX + offsetAX, streams[ SphereSweepBatch::PT_ON_A_X ] + lane );
+	SimdStore( toiAY + offsetAY, streams[ SphereSweepBatch::PT_ON_A_Y ] + lane );
+	SimdStore( toiAZ + offsetAZ, streams[ SphereSweepBatch::PT_ON_A_Z ] + lane );
+	SimdStore( toiBX + offsetBX, streams[ SphereSweepBatch::PT_ON_B_X ] + lane );
+	SimdStore( toiBY + offsetBY, streams[ SphereSweepBatch::PT_ON_B_Y ] + lane );
+	SimdStore( toiBZ + offsetBZ, streams[ SphereSweepBatch::PT_ON_B_Z ] + lane );
+	SimdStore( localAX, streams[ SphereSweepBatch::LOCAL_PT_ON_A_X ] + lane );
+	SimdStore( localAY, streams[ SphereSweepBatch::LOCAL_PT_ON_A_Y ] + lane );
+	SimdStore( localAZ, streams[ SphereSweepBatch::LOCAL_PT_ON_A_Z ] + lane );
+	SimdStore( localBX, streams[ SphereSweepBatch::LOCAL_PT_ON_B_X ] + lane );
+	SimdStore( localBY, streams[ SphereSweepBatch::LOCAL_PT_ON_B_Y ] + lane );
+	SimdStore( localBZ, streams[ SphereSweepBatch::LOCAL_PT_ON_B_Z ] + lane );
+	SimdStore( SimdSqrt( abSqr ) - radii, streams[ SphereSweepBatch::SEPARATION ] + lane );
+	return true;
+}
+
+/*
+====================================================
+SphereSweepBatch::AddPair
+====================================================
+*/
+int SphereSweepBatch::AddPair( const Body & bodyA, const Body & bodyB ) {
+	assert( bodyA.GetShape()->GetType() == Shape::SHAPE_SPHERE && bodyB.GetShape()->GetType() == Shape::SHAPE_SPHERE );
+	m_bodies.push_back( bodyA );
+	m_bodies.push_back( bodyB );
+	return Size() - 1;
+}
+
+/*
+====================================================
+SphereSweepBatch::Gather
+====================================================
+*/
+void SphereSweepBatch::Gather() {
+	const int numPairs = Size();
+
+	// the padding lanes are two unit spheres far apart and at rest, so they go through the kernel without any NaNs
+	m_stride = SimdStreamStride( numPairs );
+	m_lanes.resize( NUM_STREAMS * m_stride );
+	for ( int s = 0; s < RADIUS_B; s++ ) {
+		std::fill( GetStream( s ) + numPairs, GetStream( s ) + m_stride, 0.0f );
+	}
+	for ( int lane = numPairs; lane < m_stride; lane++ ) {
+		GetStream( POS_B_X )[ lane ] = 10.0f;
+		GetStream( ORIENT_A_W )[ lane ] = 1.0f;
+		GetStream( ORIENT_B_W )[ lane ] = 1.0f;
+		GetStream( RADIUS_A )[ lane ] = 1.0f;
+		GetStream( RADIUS_B )[ lane ] = 1.0f;
+	}
+
+	float * streams[ NUM_STREAMS ];
+	for ( int s = 0; s < NUM_STREAMS; s++ ) {
+		streams[ s ] = GetStream( s );
+	}
+	for ( int lane = 0; lane < numPairs; lane++ ) {
+		// straight to the store's arrays, instead of resolving the handles for every field
+		const BodyStore & storeA = *m_bodies[ lane * 2 + 0 ].GetStore();
+		const BodyStore & storeB = *m_bodies[ lane * 2 + 1 ].GetStore();
+		const int a = m_bodies[ lane * 2 + 0 ].GetIndex();
+		const int b = m_bodies[ lane * 2 + 1 ].GetIndex();
+		const Vec3 & posA = storeA.m_positions[ a ];
+		const Vec3 & posB = storeB.m_positions[ b ];
+		const Vec3 & velA = storeA.m_linearVelocities[ a ];
+		const Vec3 & velB = storeB.m_linearVelocities[ b ];
+		const Quat & orientA = storeA.m_orientations[ a ];
+		const Quat & orientB = storeB.m_orientations[ b ];
+		const Vec3 & angVelA = storeA.m_angularVelocities[ a ];
+		const Vec3 & angVelB = storeB.m_angularVelocities[ b ];
+		streams[ POS_A_X ][ lane ] = posA.x;
+		streams[ POS_A_Y ][ lane ] = posA.y;
+		streams[ POS_A_Z ][ lane ] = posA.z;
+		streams[ POS_B_X ][ lane ] = posB.x;
+		streams[ POS_B_Y ][ lane ] = posB.y;
+		streams[ POS_B_Z ][ lane ] = posB.z;
+		streams[ VEL_A_X ][ lane ] = velA.x;
+		streams[ VEL_A_Y ][ lane ] = velA.y;
+		streams[ VEL_A_Z ][ lane ] = velA.z;
+		streams[ VEL_B_X ][ lane ] = velB.x;
+		streams[ VEL_B_Y ][ lane ] = velB.y;
+		streams[ VEL_B_Z ][ lane ] = velB.z;
+		streams[ ORIENT_A_W ][ lane ] = orientA.w;
+		streams[ ORIENT_A_X ][ lane ] = orientA.x;
+		streams[ ORIENT_A_Y ][ lane ] = orientA.y;
+		streams[ ORIENT_A_Z ][ lane ] = orientA.z;
+		streams[ ORIENT_B_W ][ lane ] = orientB.w;
+		streams[ ORIENT_B_X ][ lane ] = orientB.x;
+		streams[ ORIENT_B_Y ][ lane ] = orientB.y;
+		streams[ ORIENT_B_Z ][ lane ] = orientB.z;
+		streams[ ANG_VEL_A_X ][ lane ] = angVelA.x;
+		streams[ ANG_VEL_A_Y ][ lane ] = angVelA.y;
+		streams[ ANG_VEL_A_Z ][ lane ] = angVelA.z;
+		streams[ ANG_VEL_B_X ][ lane ] = angVelB.x;
+		streams[ ANG_VEL_B_Y ][ lane ] = angVelB.y;
+		streams[ ANG_VEL_B_Z ][ lane ] = angVelB.z;
+		streams[ RADIUS_A ][ lane ] = reinterpret_cast< const ShapeSphere * >( storeA.m_shapes[ a ] )->m_radius;
+		streams[ RADIUS_B ][ lane ] = reinterpret_cast< const ShapeSphere * >( storeB.m_shapes[ b ] )->m_radius;
+	}
+}
+
+/*
+====================================================
+SphereSweepBatch::Sweep
+====================================================
+*/
+void SphereSweepBatch::Sweep( const float dt_sec ) {
+	const int numPairs = Size();
+	if ( numPairs == 0 ) {
+		return;
+	}
+	Gather();
+
+	float * streams[ NUM_STREAMS ];
+	for ( int s = 0; s < NUM_STREAMS; s++ ) {
+		streams[ s ] = GetStream( s );
+	}
+
+	if ( SIMD_NARROWPHASE ) {
+		for ( int lane = 0; lane < numPairs; lane += SIMD_WIDTH ) {
+			if ( SweepLanes< simdf_t >( streams, lane, dt_sec ) ) {
+				continue;
+			}
+
+			// something in this batch spins too far for the polynomials
+			for ( int k = lane; k < lane + SIMD_WIDTH; k++ ) {
+				SweepLanes< float >( streams, k, dt_sec );
+			}
+		}
+	} else {
+		for ( int lane = 0; lane < numPairs; lane++ ) {
+			SweepLanes< float >( streams, lane, dt_sec );
+		}
+	}
+}
+
+/*
+====================================================
+SphereSweepBatch::GetContact
+====================================================
+*/
+bool SphereSweepBatch::GetContact( const int pair, contact_t & outContact ) const {
+	outContact.bodyA = m_bodies[ pair * 2 + 0 ];
+	outContact.bodyB = m_bodies[ pair * 2 + 1 ];
+	if ( GetStream( HIT )[ pair ] == 0.0f ) {
+		return false;
+	}
+
+	outContact.timeOfImpact = GetStream( TIME_OF_IMPACT )[ pair ];
+	outContact.normal = Vec3( GetStream( NORMAL_X )[ pair ], GetStream( NORMAL_Y )[ pair ], GetStream( NORMAL_Z )[ pair ] );
+	outContact.ptOnA_WorldSpace = Vec3( GetStream( PT_ON_A_X )[ pair ], GetStream( PT_ON_A_Y )[ pair ], GetStream( PT_ON_A_Z )[ pair ] );
+	outContact.ptOnB_WorldSpace = Vec3( GetStream( PT_ON_B_X )[ pair ], GetStream( PT_ON_B_Y )[ pair ], GetStream( PT_ON_B_Z )[ pair ] );
+	outContact.ptOnA_LocalSpace = Vec3( GetStream( LOCAL_PT_ON_A_X )[ pair ], GetStream( LOCAL_PT_ON_A_Y )[ pair ], GetStream( LOCAL_PT_ON_A_Z )[ pair ] );
+	outContact.ptOnB_LocalSpace = Vec3( GetStream( LOCAL_PT_ON_B_X )[ pair ], GetStream( LOCAL_PT_ON_B_Y )[ pair ], GetStream( LOCAL_PT_ON_B_Z )[ pair ] );
+	outContact.separationDistance = GetStream( SEPARATION )[ pair ];
+	return true;
+}
+
+/*
+====================================================
+BenchmarkSphereSweep
+====================================================
+*/
+void BenchmarkSphereSweep( const int numPairs, const int numRuns ) {
+	const float dt_sec = 1.0f / 60.0f;
+	std::vector< ShapeSphere > spheres;
+	spheres.reserve( numPairs * 2 );
+
+	// pairs a few radii apart heading roughly at each other, so about half of them touch within the step
+	BodyStore bodies;
+	srand( 1234 );
+	auto random = []( const float range ) { return ( float( rand() ) / float( RAND_MAX ) * 2.0f - 1.0f ) * range; };
+	for ( int i = 0; i < numPairs * 2; i++ ) {
+		spheres.push_back( ShapeSphere( 0.5f + random( 0.4f ) ) );
+
+		bodyDesc_t body;
+		body.position = Vec3( random( 100.0f ), random( 100.0f ), random( 100.0f ) );
+		if ( i & 1 ) {
+			body.position = bodies.m_positions[ i - 1 ] + Vec3( random( 2.0f ), random( 2.0f ), random( 2.0f ) );
+		}
+		body.orientation = Quat( Vec3( random( 1.0f ), random( 1.0f ), random( 1.0f ) ), random( 3.0f ) );
+		body.linearVelocity = Vec3( random( 60.0f ), random( 60.0f ), random( 60.0f ) );
+		body.angularVelocity = Vec3( random( 10.0f ), random( 10.0f ), random( 10.0f ) );
+		body.invMass = 1.0f;
+		body.shape = &spheres.back();
+		bodies.Add( body );
+	}
+
+	std::vector< contact_t > scalarContacts( numPairs );
+	std::vector< char > scalarHits( numPairs );
+	typedef std::chrono::high_resolution_clock clock_t;
+	const clock_t::time_point scalarStart = clock_t::now();
+	for ( int run = 0; run < numRuns; run++ ) {
+		for ( int i = 0; i < numPairs; i++ ) {
+			scalarHits[ i ] = Intersect( bodies.GetBodyAt( i * 2 ), bodies.GetBodyAt( i * 2 + 1 ), dt_sec, scalarContacts[ i ] );
+		}
+	}
+	const clock_t::time_point scalarEnd = clock_t::now();
+
+	SphereSweepBatch batch;
+	const clock_t::time_point batchStart = clock_t::now();
+	for ( int run = 0; run < numRuns; run++ ) {
+		batch.Clear();
+		for ( int i = 0; i < numPairs; i++ ) {
+			batch.AddPair( bodies.GetBodyAt( i * 2 ), bodies.GetBodyAt( i * 2 + 1 ) );
+		}
+		batch.Sweep( dt_sec );
+	}
+	const clock_t::time_point batchEnd = clock_t::now();
+
+	int numHits = 0;
+	int numMismatches = 0;
+	float maxToiError = 0.0f;
+	float maxPointError = 0.0f;
+	float maxLocalError = 0.0f;
+	for ( int i = 0; i < numPairs; i++ ) {
+		contact_t contact;
+		const bool hit = batch.GetContact( i, contact );
+		if ( hit != ( scalarHits[ i ] != 0 ) ) {
+			numMismatches++;
+			continue;
+		}
+		if ( !hit ) {
+			continue;
+		}
+		const contact_t & expected = scalarContacts[ i ];
+		numHits++;
+		maxToiError = std::max( maxToiError, fabsf( contact.timeOfImpact - expected.timeOfImpact ) );
+		maxPointError = std::max( maxPointError, ( contact.ptOnA_WorldSpace - expected.ptOnA_WorldSpace ).GetMagnitude() );
+		maxPointError = std::max( maxPointError, ( contact.ptOnB_WorldSpace - expected.ptOnB_WorldSpace ).GetMagnitude() );
+		maxLocalError = std::max( maxLocalError, ( contact.ptOnA_LocalSpace - expected.ptOnA_LocalSpace ).GetMagnitude() );
+		maxLocalError = std::max( maxLocalError, ( contact.ptOnB_LocalSpace - expected.ptOnB_LocalSpace ).GetMagnitude() );
+	}
+
+	const double scalarSec = std::chrono::duration< double >( scalarEnd - scalarStart ).count();
+	const double batchSec = std::chrono::duration< double >( batchEnd - batchStart ).count();
+	const double numSweeps = double( numPairs ) * double( numRuns );
+	printf( "Sphere sweep benchmark, %i pairs x %i runs, %i touching\n", numPairs, numRuns, numHits );
+	printf( "    Intersect        %8.2f M pairs/s\n", numSweeps / scalarSec * 1e-6 );
+	printf( "    SphereSweepBatch %8.2f M pairs/s ( %i wide, %.1fx )\n", numSweeps / batchSec * 1e-6, SIMD_NARROWPHASE ? SIMD_WIDTH : 1, scalarSec / batchSec );
+	printf( "    max difference   toi %g, point %g, local point %g, %i pairs disagree on touching\n", maxToiError, maxPointError, maxLocalError, numMismatches );
+}
\ No newline at end of file
@@ -0,0 +1,75 @@
+//
+//	SphereSweep.h
+//
+#pragma once
+#include "Body.h"
+#include "Contact.h"
+#include <vector>
+
+/*
+====================================================
+SphereSweepBatch
+
+Batch version of Intersect( bodyA, bodyB, dt, contact ) for sphere pairs.
+The pairs get gathered into lanes ( one float stream per component ), and
+the time of impact quadratic is solved SIMD_WIDTH pairs at a time. The
+contact points, normal and the contact points in body space at the time of
+impact all come out of the same pass, without touching the bodies. Pairs
+whose bodies spin too far before the impact for the quaternion polynomial
+are redone one at a time with the real trig functions, like BodyIntegrator.
+====================================================
+*/
+class SphereSweepBatch {
+public:
+	SphereSweepBatch() : m_stride( 0 ) {}
+
+	void Clear() { m_bodies.clear(); }
+	int Size() const { return static_cast< int >( m_bodies.size() ) / 2; }
+
+	// both bodies have to be spheres, returns the index of the pair in the batch
+	int AddPair( const Body & bodyA, const Body & bodyB );
+
+	// solves every pair for the first time of impact within dt_sec
+	void Sweep( const float dt_sec );
+
+	// fills in the contact of a pair and returns true, if it touches within the step
+	bool GetContact( const int pair, contact_t & outContact ) const;
+
+	enum laneStream_t {
+		// in
+		POS_A_X, POS_A_Y, POS_A_Z,
+		POS_B_X, POS_B_Y, POS_B_Z,
+		VEL_A_X, VEL_A_Y, VEL_A_Z,
+		VEL_B_X, VEL_B_Y, VEL_B_Z,
+		ORIENT_A_W, ORIENT_A_X, ORIENT_A_Y, ORIENT_A_Z,
+		ORIENT_B_W, ORIENT_B_X, ORIENT_B_Y, ORIENT_B_Z,
+		ANG_VEL_A_X, ANG_VEL_A_Y, ANG_VEL_A_Z,
+		ANG_VEL_B_X, ANG_VEL_B_Y, ANG_VEL_B_Z,
+		RADIUS_A, RADIUS_B,
+
+		// out
+		HIT,											// 1 if the pair touches within the step, 0 if not
+		TIME_OF_IMPACT,
+		NORMAL_X, NORMAL_Y, NORMAL_Z,
+		PT_ON_A_X, PT_ON_A_Y, PT_ON_A_Z,				// world space
+		PT_ON_B_X, PT_ON_B_Y, PT_ON_B_Z,
+		LOCAL_PT_ON_A_X, LOCAL_PT_ON_A_Y, LOCAL_PT_ON_A_Z,
+		LOCAL_PT_ON_B_X, LOCAL_PT_ON_B_Y, LOCAL_PT_ON_B_Z,
+		SEPARATION,
+		NUM_STREAMS
+	};
+
+	const float * GetStream( const int stream ) const { return &m_lanes[ stream * m_stride ]; }
+
+private:
+	void Gather();
+
+	float * GetStream( const int stream ) { return &m_lanes[ stream * m_stride ]; }
+
+	std::vector< Body > m_bodies;		// bodyA, bodyB of every pair
+	std::vector< float > m_lanes;		// one lane per pair, padded out to a whole number of SIMD batches
+	int m_stride;
+};
+
+// sweeps the same pairs with Intersect and with SphereSweepBatch, and prints throughput and the largest difference
+void BenchmarkSphereSweep( const int numPairs, const int numRuns );
\ No newline at end of file
@@ -0,0 +1,139 @@
+//
+//	ThreadPool.cpp
+//
+#include "ThreadPool.h"
+#include "../Config.h"
+#include <algorithm>
+
+/*
+====================================================
+ThreadPool::ThreadPool
+====================================================
+*/
+ThreadPool::ThreadPool( const unsigned numThreads ) :
+m_invoke( nullptr ),
+m_context( nullptr ),
+m_numTasks( 0 ),
+m_generation( 0 ),
+m_numBusy( 0 ),
+m_quit( false ),
+m_nextTask( 0 ),
+m_numCompleted( 0 ) {
+	// the calling thread counts as one of them
+	for ( unsigned i = 1; i < numThreads; i++ ) {
+		m_workers.emplace_back( &ThreadPool::WorkerMain, this );
+	}
+}
+
+/*
+====================================================
+ThreadPool::~ThreadPool
+====================================================
+*/
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard< std::mutex > lock( m_mutex );
+		m_quit = true;
+	}
+	m_wakeCondition.notify_all();
+
+	for ( int i = 0; i < m_workers.size(); i++ ) {
+		m_workers[ i ].join();
+	}
+}
+
+/*
+====================================================
+ThreadPool::RunTasks
+====================================================
+*/
+void ThreadPool::RunTasks( invoke_t invoke, void * context, const int numTasks ) {
+	while ( true ) {
+		const int taskIdx = m_nextTask.fetch_add( 1 );
+		if ( taskIdx >= numTasks ) {
+			return;
+		}
+
+		invoke( context, taskIdx );
+		m_numCompleted.fetch_add( 1 );
+	}
+}
+
+/*
+====================================================
+ThreadPool::Run
+====================================================
+*/
+void ThreadPool::Run( const int numTasks, invoke_t invoke, void * context ) {
+	{
+		// a worker can wake up late and grab the previous job after it was already finished,
+		// let it run dry before the task counter gets reset underneath it
+		std::unique_lock< std::mutex > lock( m_mutex );
+		m_doneCondition.wait( lock, [ this ]() { return m_numBusy == 0; } );
+
+		m_invoke = invoke;
+		m_context = context;
+		m_numTasks = numTasks;
+		m_nextTask = 0;
+		m_numCompleted = 0;
+		m_generation++;
+	}
+	m_wakeCondition.notify_all();
+
+	// help out instead of sitting idle
+	RunTasks( invoke, context, numTasks );
+
+	// workers that picked up this job still hold on to the context, wait for them to let go
+	std::unique_lock< std::mutex > lock( m_mutex );
+	m_doneCondition.wait( lock, [ this, numTasks ]() {
+		return m_numBusy == 0 && m_numCompleted.load() == numTasks;
+	} );
+}
+
+/*
+====================================================
+ThreadPool::WorkerMain
+====================================================
+*/
+void ThreadPool::WorkerMain() {
+	uint64_t lastGeneration = 0;
+
+	while ( true ) {
+		invoke_t invoke;
+		void * context;
+		int numTasks;
+		{
+			std::unique_lock< std::mutex > lock( m_mutex );
+			m_wakeCondition.wait( lock, [ this, lastGeneration ]() {
+				return m_quit || m_generation != lastGeneration;
+			} );
+			if ( m_quit ) {
+				return;
+			}
+
+			lastGeneration = m_generation;
+			invoke = m_invoke;
+			context = m_context;
+			numTasks = m_numTasks;
+			m_numBusy++;
+		}
+
+		RunTasks( invoke, context, numTasks );
+
+		{
+			std::lock_guard< std::mutex > lock( m_mutex );
+			m_numBusy--;
+		}
+		m_doneCondition.notify_all();
+	}
+}
+
+/*
+====================================================
+GetPhysicsThreadPool
+====================================================
+*/
+ThreadPool & GetPhysicsThreadPool() {
+	static ThreadPool pool( std::max( 1u, std::min( std::thread::hardware_concurrency(), NUM_THREADS_PHYSICS ) ) );
+	return pool;
+}
\ No newline at end of file
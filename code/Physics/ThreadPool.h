@@ -0,0 +1,88 @@
+//
+//	ThreadPool.h
+//
+#pragma once
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <type_traits>
+#include <stdint.h>
+
+/*
+====================================================
+ThreadPool
+
+Fixed set of worker threads that sleep until handed a ParallelFor. Tasks are
+handed out through an atomic counter, and the calling thread works through
+them too, so a pool of one thread just runs everything inline. Which thread
+runs a task is not deterministic, so anything order sensitive has to write
+into per task storage and be merged by task index afterwards.
+====================================================
+*/
+class ThreadPool {
+public:
+	explicit ThreadPool( const unsigned numThreads );
+	~ThreadPool();
+
+	// including the calling thread
+	int GetNumThreads() const { return static_cast< int >( m_workers.size() ) + 1; }
+
+	// calls fn( taskIdx ) for every task in [0, numTasks), returns once they're all done
+	template< typename func_t >
+	void ParallelFor( const int numTasks, func_t && fn );
+
+private:
+	typedef void ( *invoke_t )( void * context, const int taskIdx );
+
+	void Run( const int numTasks, invoke_t invoke, void * context );
+	void RunTasks( invoke_t invoke, void * context, const int numTasks );
+	void WorkerMain();
+
+	std::vector< std::thread > m_workers;
+
+	std::mutex m_mutex;
+	std::condition_variable m_wakeCondition;
+	std::condition_variable m_doneCondition;
+
+	// the current job, only changed under the lock while no worker is busy
+	invoke_t m_invoke;
+	void * m_context;
+	int m_numTasks;
+	uint64_t m_generation;
+	int m_numBusy;
+	bool m_quit;
+
+	std::atomic< int > m_nextTask;
+	std::atomic< int > m_numCompleted;
+};
+
+/*
+====================================================
+ThreadPool::ParallelFor
+====================================================
+*/
+template< typename func_t >
+void ThreadPool::ParallelFor( const int numTasks, func_t && fn ) {
+	if ( numTasks <= 0 ) {
+		return;
+	}
+
+	// no need to wake anyone up for a single task
+	if ( numTasks == 1 || m_workers.empty() ) {
+		for ( int i = 0; i < numTasks; i++ ) {
+			fn( i );
+		}
+		return;
+	}
+
+	// type erase without a heap allocation, fn outlives the job since Run blocks
+	invoke_t invoke = []( void * context, const int taskIdx ) {
+		( *reinterpret_cast< typename std::remove_reference< func_t >::type * >( context ) )( taskIdx );
+	};
+	Run( numTasks, invoke, const_cast< void * >( reinterpret_cast< const void * >( &fn ) ) );
+}
+
+// shared by all the multithreaded parts of the physics, sized by NUM_THREADS_PHYSICS
+ThreadPool & GetPhysicsThreadPool();
\ No newline at end of file
@@ -4,10 +4,11 @@
 #include "Scene.h"
 #include "Physics/Contact.h"
 #include "Physics/Intersections.h"
-#include "Physics/Broadphase.h"
+#include "Physics/ThreadPool.h"
 #include "Physics/Shapes/ShapeAnimated.h"
 #include "SceneUtil.h"
 #include <algorithm>
+#include <float.h>
 #include "Config.h"
 
 /*
@@ -26,12 +27,16 @@ Scene::~Scene
 Scene::~Scene() {
 	DeInitAnimInstanceDemo();
 
-	for ( int i = 0; i < m_bodies.size(); i++ ) {
-		delete m_bodies[ i ].m_shape;
+	for ( int i = 0; i < m_bodies.Size(); i++ ) {
+		delete m_bodies.m_shapes[ i ];
 	}
-	m_bodies.clear();
+	m_bodies.Clear();
+	m_sleepingIslands.Clear();
 
-	// note - this does NOT call the destructor on these pointers!
+	delete m_broadPhase;
+	m_broadPhase = nullptr;
+
+	// just views, the bodies live in m_bodies and the anim instances
 	m_renderedBodies.clear();
 
 	endDebugSession();
@@ -45,12 +50,16 @@ Scene::Reset
 void Scene::Reset() {
 	DeInitAnimInstanceDemo();
 
-	for ( int i = 0; i < m_bodies.size(); i++ ) {
-		delete m_bodies[ i ].m_shape;
+	for ( int i = 0; i < m_bodies.Size(); i++ ) {
+		delete m_bodies.m_shapes[ i ];
 	}
-	m_bodies.clear();
+	m_bodies.Clear();
+	m_sleepingIslands.Clear();
+	m_broadPhase->Clear();
+	m_manifolds.Clear();
+	m_gjkCaches.Clear();
 
-	// note - this does NOT call the destructor on these pointers!
+	// just views, the bodies live in m_bodies and the anim instances
 	m_renderedBodies.clear();
 
 	Initialize();
@@ -66,7 +75,7 @@ void Scene::Initialize() {
 	// physics bodies
 	///////////////////////////////////////////////////////////////////////
 
-	Body body;
+	bodyDesc_t body;
 
 	// Dynamic bodies
 	if ( RUN_PHYSICS_SIM ) {
@@ -75,14 +84,14 @@ void Scene::Initialize() {
 				float radius = 0.5f;
 				float xx = float( x - 1 ) * radius * 1.5f;
 				float yy = float( y - 1 ) * radius * 1.5f;
-				body.m_position = Vec3( xx, yy, 10.f );
-				body.m_orientation = Quat( 0, 0, 0, 1 );
-				body.m_linearVelocity.Zero();
-				body.m_invMass = 1.f;
-				body.m_elasticity = 0.5f;
-				body.m_friction = 0.5f;
-				body.m_shape = new ShapeSphere( radius );
-				m_bodies.push_back( body );
+				body.position = Vec3( xx, yy, 10.f );
+				body.orientation = Quat( 0, 0, 0, 1 );
+				body.linearVelocity.Zero();
+				body.invMass = 1.f;
+				body.elasticity = 0.5f;
+				body.friction = 0.5f;
+				body.shape = new ShapeSphere( radius );
+				m_bodies.Add( body );
 			}
 		}
 		// Static floor
@@ -91,14 +100,14 @@ void Scene::Initialize() {
 				float radius = 80.f;
 				float xx = float( x - 1 ) * radius * 0.25f;
 				float yy = float( y - 1 ) * radius * 0.25f;
-				body.m_position = Vec3( xx, yy, -radius );
-				body.m_orientation = Quat( 0, 0, 0, 1 );
-				body.m_linearVelocity.Zero();
-				body.m_invMass = 0.f;
-				body.m_elasticity = 0.99f;
-				body.m_friction = 0.5f;
-				body.m_shape = new ShapeSphere( radius );
-				m_bodies.push_back( body );
+				body.position = Vec3( xx, yy, -radius );
+				body.orientation = Quat( 0, 0, 0, 1 );
+				body.linearVelocity.Zero();
+				body.invMass = 0.f;
+				body.elasticity = 0.99f;
+				body.friction = 0.5f;
+				body.shape = new ShapeSphere( radius );
+				m_bodies.Add( body );
 			}
 		}
 	}
@@ -110,35 +119,32 @@ void Scene::Initialize() {
 						{ 0, 1, 0 },  // right
 						{ 0, 0, 1 },  // up
 						GIZMO_SCALE,
-						&m_bodies 
+						m_bodies 
 		);
 		InitializeAnimInstanceDemo();
 	}
 
 	///////////////////////////////////////////////////////////////////////////////////
-	// list of pointers to both ( todo - use placement new to allocate in same block )
+	// list of views of both
 	///////////////////////////////////////////////////////////////////////////////////
 	int numAnimatedBodies = 0;
 	for ( const AnimationInstance * animInst : animInstanceDemo ) {
-		numAnimatedBodies += animInst ? animInst->bodiesToAnimate.size() : 0;
+		numAnimatedBodies += animInst ? animInst->bodiesToAnimate.Size() : 0;
 	}
-	m_renderedBodies.resize( m_bodies.size() + numAnimatedBodies );
+	m_renderedBodies.clear();
+	m_renderedBodies.reserve( m_bodies.Size() + numAnimatedBodies );
 
 	// add all the physics bodies to the array of rendered bodies
-	std::transform( m_bodies.begin(), m_bodies.end(), m_renderedBodies.begin(), []( Body & b ) { return &b; } );
+	for ( int i = 0; i < m_bodies.Size(); i++ ) {
+		m_renderedBodies.push_back( m_bodies.GetBodyAt( i ) );
+	}
 
 	if ( RUN_ANIMATION ) {
 		// add all the animated bodies to the array of rendered bodies ( always at the end )
-		size_t offset = m_bodies.size();
 		for ( AnimationInstance * animInst : animInstanceDemo ) {
-				std::transform( 
-					animInst->bodiesToAnimate.begin(), 
-					animInst->bodiesToAnimate.end(), 
-					m_renderedBodies.begin() + offset, 
-					[]( Body & b )  { 
-						return &b; 
-					} );
-				offset += animInst->bodiesToAnimate.size();
+			for ( int i = 0; i < animInst->bodiesToAnimate.Size(); i++ ) {
+				m_renderedBodies.push_back( animInst->bodiesToAnimate.GetBodyAt( i ) );
+			}
 		}
 	}
 }
@@ -160,10 +166,10 @@ void Scene::TryCycleAnim() {
 }
 
 int Scene::GetFirstAnimatedBodyIdx() {
-	if ( !RUN_ANIMATION || animInstanceDemo[ 0 ]->bodiesToAnimate.empty() ) {
+	if ( !RUN_ANIMATION || animInstanceDemo[ 0 ]->bodiesToAnimate.Size() == 0 ) {
 		return -1;
 	}
-	return m_bodies.size();
+	return m_bodies.Size();
 }
 
 void Scene::InitializeAnimInstanceDemo() {
@@ -220,9 +226,22 @@ void Scene::Update( const float dt_sec ) {
 		}
 	}
 
+	// nothing from the last step's scratch is still in use
+	m_frameArena.Reset();
+
+	// bodies that got hit by an impulse since the last update take their whole island with them
+	WakeTouchedIslands();
+
+	// contact points that slid apart or separated since the last step drop out of their manifolds
+	m_manifolds.RemoveExpired();
+
 	// apply gravitational acceleration to velocity
-	for ( int i = 0; i < m_bodies.size(); i++ ) {
-		Body * body = &m_bodies[ i ];
+	for ( int i = 0; i < m_bodies.Size(); i++ ) {
+		if ( !m_bodies.IsActive( i ) ) {
+			continue;
+		}
+		Body body = m_bodies.GetBodyAt( i );
+
 		// Apply gravity as an impulse
 		// Impulse = total delta momentum
 		// Force   = delta momentum amortized over time
@@ -230,52 +249,367 @@ void Scene::Update( const float dt_sec ) {
 		//	      => Force = mass * gravitational accel * delta time 
 
 		// retrieve actual mass from inverse so we can use it
-		const float mass	= 1.f / body->m_invMass;
+		const float mass	= 1.f / body.GetInvMass();
 		Vec3 gravityImpulse = GRAV_ACCEL * mass * dt_sec;
-		body->ApplyImpulseLinear( gravityImpulse );
+		body.ApplyImpulseLinear( gravityImpulse );
 	}
 
 	// Broadphase ( identify potential pairs )
-	std::vector< collisionPair_t > collisionPairs;
-	BroadPhase( m_bodies.data(), static_cast< int >( m_bodies.size() ), collisionPairs, dt_sec );
+	// the sorted endpoints and pairs persist across steps, so this is only incremental work
+	m_broadPhase->Update( m_bodies, dt_sec );
+	const std::vector< collisionPair_t > & collisionPairs = m_broadPhase->GetPairs();
 
 
 	// Narrow Phase ( actual collision detection )
-	int numContacts = 0;
-	const int maxContacts = m_bodies.size() * m_bodies.size();
-	contact_t * contacts = reinterpret_cast< contact_t * >( alloca( sizeof( contact_t ) * maxContacts ) );
+	m_islands.Reset( m_bodies.Size() );
 	for ( int i = 0; i < collisionPairs.size(); i++ ) {
-		const collisionPair_t & pair = collisionPairs[ i ];
-		Body * bodyA = &m_bodies[ pair.a ];
-		Body * bodyB = &m_bodies[ pair.b ];
+		Body bodyA = m_bodies.GetBodyAt( collisionPairs[ i ].a );
+		Body bodyB = m_bodies.GetBodyAt( collisionPairs[ i ].b );
 
-		// skip pairs w infinite mass
-		if ( 0.f == bodyA->m_invMass && 0.f == bodyB->m_invMass ) {
-			continue;
-		}
+		// bodies this close are treated as one island, even when they don't quite touch this step
+		LinkBodies( bodyA, bodyB );
+	}
 
-		contact_t contact{};
-		if ( Intersect( bodyA, bodyB, dt_sec, contact ) ) {
-			contacts[ numContacts ] = contact;
-			numContacts++;
+	// Intersect doesn't touch the bodies, so the pairs get tested on the thread pool
+	span_t< contact_t > contacts = NarrowPhase( collisionPairs, dt_sec );
+
+	// contacts that are already touching at the start of the step are resting, they go into the
+	// manifolds and get solved as constraints. the rest get resolved at their time of impact
+	int numBallisticContacts = 0;
+	for ( int i = 0; i < contacts.Size(); i++ ) {
+		WakeTouching( contacts[ i ].bodyA, contacts[ i ].bodyB );
+		if ( 0.f == contacts[ i ].timeOfImpact && contacts[ i ].separationDistance > -MAX_RESTING_PENETRATION ) {
+			m_manifolds.AddContact( contacts[ i ] );
+		} else {
+			contacts[ numBallisticContacts ] = contacts[ i ];
+			numBallisticContacts++;
 		}
 	}
+	contacts.count = numBallisticContacts;
+
+	// constraints and manifolds are always touching
+	for ( int i = 0; i < m_constraints.size(); i++ ) {
+		WakeTouching( m_constraints[ i ]->m_bodyA, m_constraints[ i ]->m_bodyB );
+		LinkBodies( m_constraints[ i ]->m_bodyA, m_constraints[ i ]->m_bodyB );
+	}
+	for ( int i = 0; i < m_manifolds.m_manifolds.size(); i++ ) {
+		WakeTouching( m_manifolds.m_manifolds[ i ].GetBodyA(), m_manifolds.m_manifolds[ i ].GetBodyB() );
+		LinkBodies( m_manifolds.m_manifolds[ i ].GetBodyA(), m_manifolds.m_manifolds[ i ].GetBodyB() );
+	}
 
 	// Sort time of impact from earliest to latest
-	if ( numContacts > 1 ) {
-		qsort( contacts, numContacts, sizeof( contact_t ), CompareContacts );
+	if ( contacts.Size() > 1 ) {
+		qsort( contacts.data, contacts.Size(), sizeof( contact_t ), CompareContacts );
 	}
 
+	SolveConstraints( dt_sec );
+
 	// resolve all the bodies that have contacted first
+	if ( TOI_LOCAL_TIME ) {
+		ResolveContactsLocalTime( contacts, dt_sec );
+	} else {
+		ResolveContactsGlobalTime( contacts, dt_sec );
+	}
+
+	UpdateSleeping( dt_sec );
+}
+
+/*
+====================================================
+GetConstraintBodies
+
+store indices of the bodies a constraint writes to, for the coloring. static
+bodies never get written, so they're left out and don't serialize everything
+resting on the floor
+====================================================
+*/
+static constraintBodies_t GetConstraintBodies( const Body & bodyA, const Body & bodyB ) {
+	constraintBodies_t bodies;
+	bodies.bodyA = ( bodyA.IsValid() && bodyA.GetInvMass() != 0.0f ) ? bodyA.GetIndex() : -1;
+	bodies.bodyB = ( bodyB.IsValid() && bodyB.GetInvMass() != 0.0f ) ? bodyB.GetIndex() : -1;
+	return bodies;
+}
+
+/*
+====================================================
+ParallelMax
+
+calls fn( i ) for every i in [0, num), and returns the largest value fn
+returned. when the calls don't share a body that can move they're split into
+contiguous runs across the physics threads, minPerTask or more to a thread,
+and the split only changes how fast it goes, not the result
+====================================================
+*/
+template< typename func_t >
+static float ParallelMax( const int num, const bool isParallel, const int minPerTask, span_t< float > taskResiduals, func_t && fn ) {
+	int numTasks = 1;
+	if ( isParallel ) {
+		numTasks = std::max( 1, std::min( taskResiduals.Size(), num / minPerTask ) );
+	}
+
+	GetPhysicsThreadPool().ParallelFor( numTasks, [ & ]( const int task ) {
+		const int begin = static_cast< int >( int64_t( num ) * task / numTasks );
+		const int end = static_cast< int >( int64_t( num ) * ( task + 1 ) / numTasks );
+
+		float residual = 0.0f;
+		for ( int i = begin; i < end; i++ ) {
+			residual = std::max( residual, fn( i ) );
+		}
+		taskResiduals[ task ] = residual;
+	} );
+
+	float residual = 0.0f;
+	for ( int task = 0; task < numTasks; task++ ) {
+		residual = std::max( residual, taskResiduals[ task ] );
+	}
+	return residual;
+}
+
+/*
+====================================================
+Scene::SolveConstraints
+
+the joints and the resting contacts, all of them warm started from the
+impulses they ended the last step with. a settled stack barely changes from
+one step to the next, so the contacts stop changing after an iteration or
+two and the rest of the iterations get skipped.
+
+when there are enough of them to go around the threads or the SIMD lanes,
+they're colored first and solved a color at a time, each color in parallel.
+the manifolds of a color go SIMD_WIDTH at a time through the wide contact
+solver. the order within an iteration is by color, and the split of a
+color across the threads doesn't change the result, so it's deterministic
+for a given thread count
+====================================================
+*/
+void Scene::SolveConstraints( const float dt_sec ) {
+	// the joints, then the manifolds
+	const int numJoints = static_cast< int >( m_constraints.size() );
+	const int numManifolds = m_manifolds.Size();
+	span_t< constraintBodies_t > constraintBodies = m_frameArena.Alloc< constraintBodies_t >( numJoints + numManifolds );
+	for ( int i = 0; i < numJoints; i++ ) {
+		constraintBodies[ i ] = GetConstraintBodies( m_constraints[ i ]->m_bodyA, m_constraints[ i ]->m_bodyB );
+	}
+	for ( int i = 0; i < numManifolds; i++ ) {
+		const Manifold & manifold = m_manifolds.m_manifolds[ i ];
+		constraintBodies[ numJoints + i ] = GetConstraintBodies( manifold.GetBodyA(), manifold.GetBodyB() );
+	}
+
+	// coloring costs convergence, so it's only worth it when the colors can actually be solved side by side
+	const int numThreads = GetPhysicsThreadPool().GetNumThreads();
+	ConstraintColoring coloring;
+	if ( ( numThreads > 1 || SIMD_SOLVER ) && constraintBodies.Size() >= 2 * MIN_PARALLEL_SOLVER_BATCH ) {
+		coloring.Build( constraintBodies, m_bodies.Size(), m_frameArena );
+	} else {
+		coloring.BuildSerial( constraintBodies.Size(), m_frameArena );
+	}
+	const int numColors = coloring.GetNumColors();
+	span_t< float > taskResiduals = m_frameArena.Alloc< float >( numThreads );
+
+	for ( int color = 0; color < numColors; color++ ) {
+		const span_t< int > constraints = coloring.GetColor( color );
+		ParallelMax( constraints.Size(), coloring.IsParallel( color ), MIN_PARALLEL_SOLVER_BATCH, taskResiduals, [ & ]( const int i ) {
+			const int idx = constraints[ i ];
+			if ( idx < numJoints ) {
+				m_constraints[ idx ]->PreSolve( dt_sec );
+			} else {
+				m_manifolds.m_manifolds[ idx - numJoints ].PreSolve( dt_sec );
+			}
+			return 0.0f;
+		} );
+	}
+
+	// the manifolds that need solving, from colors where no two share a body, into the wide solver's lanes
+	span_t< int > colorGroups = m_frameArena.Alloc< int >( numColors + 1 );
+	m_contactBatch.Clear();
+	for ( int color = 0; color < numColors; color++ ) {
+		colorGroups[ color ] = m_contactBatch.GetNumGroups();
+		if ( !SIMD_SOLVER || !coloring.IsParallel( color ) ) {
+			continue;
+		}
+
+		Manifold * group[ SIMD_WIDTH ];
+		int num = 0;
+		for ( const int idx : coloring.GetColor( color ) ) {
+			if ( idx < numJoints || !m_manifolds.m_manifolds[ idx - numJoints ].IsSolved() ) {
+				continue;
+			}
+			group[ num++ ] = &m_manifolds.m_manifolds[ idx - numJoints ];
+			if ( num == SIMD_WIDTH ) {
+				m_contactBatch.AddGroup( group, num );
+				num = 0;
+			}
+		}
+		if ( num > 0 ) {
+			m_contactBatch.AddGroup( group, num );
+		}
+	}
+	colorGroups[ numColors ] = m_contactBatch.GetNumGroups();
+	m_contactBatch.Gather();
+
+	// the residual is the largest impulse change in the iteration
+	lcpParams_t params;
+	params.relaxation = SOLVER_RELAXATION;
+	params.tolerance = SOLVER_TOLERANCE;
+	params.maxIterations = SOLVER_MAX_ITERATIONS;
+
+	m_solverStats = LCP_Iterate( params, [ & ]() {
+		float maxResidual = 0.0f;
+		for ( int color = 0; color < numColors; color++ ) {
+			const bool isWide = colorGroups[ color + 1 ] > colorGroups[ color ];
+			const span_t< int > constraints = coloring.GetColor( color );
+			const float residual = ParallelMax( constraints.Size(), coloring.IsParallel( color ), MIN_PARALLEL_SOLVER_BATCH, taskResiduals, [ & ]( const int i ) {
+				// the joints don't report how much they changed, it's the contacts that decide when to stop
+				const int idx = constraints[ i ];
+				if ( idx < numJoints ) {
+					m_constraints[ idx ]->Solve();
+					return 0.0f;
+				}
+				if ( isWide ) {
+					return 0.0f;
+				}
+				return m_manifolds.m_manifolds[ idx - numJoints ].Solve( params.relaxation );
+			} );
+
+			const int firstGroup = colorGroups[ color ];
+			const float wideResidual = ParallelMax( colorGroups[ color + 1 ] - firstGroup, true, MIN_PARALLEL_SOLVER_BATCH / SIMD_WIDTH, taskResiduals, [ & ]( const int i ) {
+				return m_contactBatch.SolveGroup( firstGroup + i, params.relaxation );
+			} );
+			maxResidual = std::max( maxResidual, std::max( residual, wideResidual ) );
+		}
+		return maxResidual;
+	} );
+	m_contactBatch.StoreImpulses();
+
+	for ( int color = 0; color < numColors; color++ ) {
+		const span_t< int > constraints = coloring.GetColor( color );
+		ParallelMax( constraints.Size(), coloring.IsParallel( color ), MIN_PARALLEL_SOLVER_BATCH, taskResiduals, [ & ]( const int i ) {
+			const int idx = constraints[ i ];
+			if ( idx < numJoints ) {
+				m_constraints[ idx ]->PostSolve();
+			} else {
+				m_manifolds.m_manifolds[ idx - numJoints ].PostSolve();
+			}
+			return 0.0f;
+		} );
+	}
+}
+
+/*
+====================================================
+Scene::NarrowPhase
+
+tests the pairs in chunks on the physics thread pool. every chunk collects
+its contacts in its own stretch of one scratch span ( a pair makes at most
+one contact ), and the stretches are packed down in chunk order, so the
+contacts come out in pair order no matter which thread ran what. the
+wake ups are left to the caller, they'd race, and a pair is only tested if
+one of its bodies was already active going in. convex pairs run GJK warm
+started from their GJKCacheTable entry, which are all looked up before the
+threads start, so the table never changes under them
+====================================================
+*/
+span_t< contact_t > Scene::NarrowPhase( const std::vector< collisionPair_t > & pairs, const float dt_sec ) {
+	const int numPairs = static_cast< int >( pairs.size() );
+
+	// skip pairs where neither body can move ( infinite mass or asleep )
+	auto isTested = [ & ]( const collisionPair_t & pair ) {
+		return m_bodies.IsActive( pair.a ) || m_bodies.IsActive( pair.b );
+	};
+	auto isSpheres = [ & ]( const collisionPair_t & pair ) {
+		return m_bodies.m_shapes[ pair.a ]->GetType() == Shape::SHAPE_SPHERE && m_bodies.m_shapes[ pair.b ]->GetType() == Shape::SHAPE_SPHERE;
+	};
+
+	// caches of pairs that weren't tested last step go, the broadphase stopped reporting them or they fell asleep
+	m_gjkCaches.RemoveUnused();
+	span_t< int > pairCaches = m_frameArena.Alloc< int >( numPairs );
+	for ( int i = 0; i < numPairs; i++ ) {
+		const bool isConvex = isTested( pairs[ i ] ) && !isSpheres( pairs[ i ] );
+		pairCaches[ i ] = isConvex ? m_gjkCaches.FindOrAdd( m_bodies.GetBodyAt( pairs[ i ].a ), m_bodies.GetBodyAt( pairs[ i ].b ) ) : -1;
+	}
+
+	// sphere pairs get swept as a batch, then the contacts are picked up in pair order
+	auto testPairs = [ & ]( const int begin, const int end, SphereSweepBatch & batch, gjkStats_t & gjkStats, contact_t * outContacts ) {
+		int numContacts = 0;
+		batch.Clear();
+		for ( int i = begin; i < end; i++ ) {
+			if ( isTested( pairs[ i ] ) && isSpheres( pairs[ i ] ) ) {
+				batch.AddPair( m_bodies.GetBodyAt( pairs[ i ].a ), m_bodies.GetBodyAt( pairs[ i ].b ) );
+			}
+		}
+		batch.Sweep( dt_sec );
+
+		int nextInBatch = 0;
+		for ( int i = begin; i < end; i++ ) {
+			if ( !isTested( pairs[ i ] ) ) {
+				continue;
+			}
+
+			contact_t contact{};
+			bool touches = false;
+			if ( isSpheres( pairs[ i ] ) ) {
+				touches = batch.GetContact( nextInBatch++, contact );
+			} else {
+				gjkCache_t & cache = m_gjkCaches.Get( pairCaches[ i ] );
+				touches = IntersectConvex( m_bodies.GetBodyAt( pairs[ i ].a ), m_bodies.GetBodyAt( pairs[ i ].b ), cache, gjkStats, contact );
+			}
+			if ( touches ) {
+				outContacts[ numContacts ] = contact;
+				numContacts++;
+			}
+		}
+		return numContacts;
+	};
+
+	ThreadPool & pool = GetPhysicsThreadPool();
+	int numChunks = 1;
+	if ( numPairs >= MIN_PARALLEL_NARROWPHASE_PAIRS && pool.GetNumThreads() > 1 ) {
+		// the pairs cost about the same, but only some of them end up touching
+		numChunks = std::min( numPairs, pool.GetNumThreads() * 4 );
+	}
+	if ( m_chunkSweeps.size() < numChunks ) {
+		m_chunkSweeps.resize( numChunks );
+	}
+
+	span_t< contact_t > contacts = m_frameArena.Alloc< contact_t >( numPairs );
+	span_t< int > chunkCounts = m_frameArena.Alloc< int >( numChunks );
+	span_t< gjkStats_t > chunkGJKStats = m_frameArena.Alloc< gjkStats_t >( numChunks );
+	pool.ParallelFor( numChunks, [ & ]( const int chunk ) {
+		const int begin = static_cast< int >( int64_t( numPairs ) * chunk / numChunks );
+		const int end = static_cast< int >( int64_t( numPairs ) * ( chunk + 1 ) / numChunks );
+		chunkCounts[ chunk ] = testPairs( begin, end, m_chunkSweeps[ chunk ], chunkGJKStats[ chunk ], contacts.data + begin );
+	} );
+
+	m_gjkStats = gjkStats_t();
+	for ( int chunk = 0; chunk < numChunks; chunk++ ) {
+		m_gjkStats.Add( chunkGJKStats[ chunk ] );
+	}
+
+	// pack, in chunk order. a chunk never moves past its own start, so nothing gets overwritten before it's copied
+	int numContacts = 0;
+	for ( int chunk = 0; chunk < numChunks; chunk++ ) {
+		const int begin = static_cast< int >( int64_t( numPairs ) * chunk / numChunks );
+		std::copy( contacts.data + begin, contacts.data + begin + chunkCounts[ chunk ], contacts.data + numContacts );
+		numContacts += chunkCounts[ chunk ];
+	}
+	return span_t< contact_t >( contacts.data, numContacts );
+}
+
+/*
+====================================================
+Scene::ResolveContactsGlobalTime
+
+steps the whole scene to each contact's time of impact in turn
+====================================================
+*/
+void Scene::ResolveContactsGlobalTime( span_t< contact_t > contacts, const float dt_sec ) {
 	float accumulatedTime = 0.f;
-	for ( int i = 0; i < numContacts; i++ ) {
+	for ( int i = 0; i < contacts.Size(); i++ ) {
 		contact_t & contact = contacts[ i ];
 		const float dt = contact.timeOfImpact - accumulatedTime;
 
 		// update pos
-		for ( int j = 0; j < m_bodies.size(); j++ ) {
-			m_bodies[ j ].Update( dt );
-		}
+		m_integrator.Integrate( m_bodies, dt );
 
 		ResolveContact( contact );
 		accumulatedTime += dt;
@@ -285,18 +619,71 @@ void Scene::Update( const float dt_sec ) {
 	// NOTE - if there were additional ( secondary ) contacts during this period, we just
 	// ignore them, bc that would be way too expensive
 	const float timeRemaining = dt_sec - accumulatedTime;
-	if ( timeRemaining <= 0.f ) {
-		return;
+	if ( timeRemaining > 0.f ) {
+		m_integrator.Integrate( m_bodies, timeRemaining );
 	}
-	for ( int i = 0; i < m_bodies.size(); i++ ) {
-		m_bodies[ i ].Update( timeRemaining );
+}
+
+/*
+====================================================
+Scene::ResolveContactsLocalTime
+
+same result as stepping the whole scene to every time of impact, since a
+contact only ever looks at its own two bodies. each body remembers how far
+into the step it is, a contact only brings its two bodies up to its time of
+impact, and everything catches up to the end of the step in one batch. k
+contacts now cost 2k body updates plus one pass, instead of k passes
+====================================================
+*/
+void Scene::ResolveContactsLocalTime( span_t< contact_t > contacts, const float dt_sec ) {
+	m_localTimes = m_frameArena.Alloc< float >( m_bodies.Size() );
+	std::fill( m_localTimes.begin(), m_localTimes.end(), 0.f );
+
+	// contacts are sorted, so a body's clock never has to run backwards
+	for ( int i = 0; i < contacts.Size(); i++ ) {
+		contact_t & contact = contacts[ i ];
+		AdvanceBody( contact.bodyA, contact.timeOfImpact );
+		AdvanceBody( contact.bodyB, contact.timeOfImpact );
+
+		ResolveContact( contact );
+	}
+
+	// the time left for each body, secondary contacts in it are ignored same as above
+	for ( int i = 0; i < m_bodies.Size(); i++ ) {
+		m_localTimes[ i ] = dt_sec - m_localTimes[ i ];
+	}
+	m_integrator.Integrate( m_bodies, m_localTimes.data );
+}
+
+/*
+====================================================
+Scene::AdvanceBody
+
+moves a body's clock up to time. bodies that can't move just get their
+clock set, so a sleeping body woken by the contact only starts moving from
+here on, like it would have when stepping the whole scene
+====================================================
+*/
+void Scene::AdvanceBody( Body body, const float time ) {
+	const int idx = body.GetIndex();
+	const float dt = time - m_localTimes[ idx ];
+	if ( dt > 0.f && m_bodies.IsActive( idx ) ) {
+		body.Update( dt );
 	}
+	m_localTimes[ idx ] = time;
 }
 
 void Scene::UpdateWithoutTOI( const float dt_sec ) {
+	m_frameArena.Reset();
+	WakeTouchedIslands();
+
 	// apply gravitational acceleration to velocity
-	for ( int i = 0; i < m_bodies.size(); i++ ) {
-		Body * body = &m_bodies[ i ];
+	for ( int i = 0; i < m_bodies.Size(); i++ ) {
+		if ( !m_bodies.IsActive( i ) ) {
+			continue;
+		}
+		Body body = m_bodies.GetBodyAt( i );
+
 		// Apply gravity as an impulse
 		// Impulse = total delta momentum
 		// Force   = delta momentum amortized over time
@@ -304,31 +691,270 @@ void Scene::UpdateWithoutTOI( const float dt_sec ) {
 		//	      => Force = mass * gravitational accel * delta time 
 
 		// retrieve actual mass from inverse so we can use it
-		const float mass = 1.f / body->m_invMass;
+		const float mass = 1.f / body.GetInvMass();
 		Vec3 gravityImpulse = GRAV_ACCEL * mass * dt_sec;
-		body->ApplyImpulseLinear( gravityImpulse );
+		body.ApplyImpulseLinear( gravityImpulse );
 	}
 
-	// Check collisions O( N^2 ) for now
-	for ( int i = 0; i < m_bodies.size(); i++ ) {
-		for ( int j = i + 1; j < m_bodies.size(); j++ ) {
-			Body * bodyA = &m_bodies[ i ];
-			Body * bodyB = &m_bodies[ j ];
+	// Check collisions against the broadphase pairs, instead of every body against every other
+	m_broadPhase->Update( m_bodies, dt_sec );
+	const std::vector< collisionPair_t > & collisionPairs = m_broadPhase->GetPairs();
+	m_islands.Reset( m_bodies.Size() );
+	for ( int i = 0; i < collisionPairs.size(); i++ ) {
+		Body bodyA = m_bodies.GetBodyAt( collisionPairs[ i ].a );
+		Body bodyB = m_bodies.GetBodyAt( collisionPairs[ i ].b );
 
-			// skip pairs with infinite mass
-			if ( bodyA->m_invMass == 0.f && bodyB->m_invMass == 0.f ) {
-				continue;
-			}
+		// skip pairs where neither body can move ( infinite mass or asleep )
+		if ( !bodyA.IsActive() && !bodyB.IsActive() ) {
+			continue;
+		}
 
-			contact_t contact;
-			if ( Intersect( bodyA, bodyB, contact ) ) {
-				ResolveContact( contact );
-			}
+		LinkBodies( bodyA, bodyB );
+
+		contact_t contact;
+		if ( Intersect( bodyA, bodyB, contact ) ) {
+			WakeTouching( bodyA, bodyB );
+			ResolveContact( contact );
 		}
 	}
 
 	// apply displacement based on position 
-	for ( int i = 0; i < m_bodies.size(); i++ ) {
-		m_bodies[ i ].Update( dt_sec );
+	m_integrator.Integrate( m_bodies, dt_sec );
+
+	UpdateSleeping( dt_sec );
+}
+
+/*
+====================================================
+Scene::LinkBodies
+
+puts two active bodies in the same island for this step. static bodies would
+glue every island resting on them together, and sleeping bodies already
+remember the island they fell asleep with
+====================================================
+*/
+void Scene::LinkBodies( const Body & bodyA, const Body & bodyB ) {
+	// constraints can hook up bodies the scene doesn't own ( e.g. animated ones ), those don't sleep
+	if ( bodyA.GetStore() != &m_bodies || bodyB.GetStore() != &m_bodies ) {
+		return;
+	}
+	if ( !bodyA.IsActive() || !bodyB.IsActive() ) {
+		return;
+	}
+	m_islands.Link( bodyA.GetIndex(), bodyB.GetIndex() );
+}
+
+/*
+====================================================
+Scene::WakeTouching
+
+anything active touching a sleeping island wakes the whole island up
+====================================================
+*/
+void Scene::WakeTouching( const Body & bodyA, const Body & bodyB ) {
+	if ( bodyA.IsActive() && !bodyB.IsAwake() ) {
+		WakeIsland( bodyB.GetIslandId() );
+	}
+	if ( bodyB.IsActive() && !bodyA.IsAwake() ) {
+		WakeIsland( bodyA.GetIslandId() );
+	}
+}
+
+/*
+====================================================
+Scene::WakeIsland
+====================================================
+*/
+void Scene::WakeIsland( const int islandId ) {
+	if ( islandId < 0 ) {
+		return;
+	}
+
+	// Wake clears each member's island id, so nothing can wake this island twice
+	const std::vector< bodyHandle_t > & members = m_sleepingIslands.GetMembers( islandId );
+	for ( int i = 0; i < members.size(); i++ ) {
+		if ( m_bodies.IsValid( members[ i ] ) ) {
+			m_bodies.GetBody( members[ i ] ).Wake();
+		}
+	}
+	m_sleepingIslands.Remove( islandId );
+}
+
+/*
+====================================================
+Scene::WakeTouchedIslands
+
+ApplyImpulse only wakes up the body it was called on, this
+wakes up the rest of the island it fell asleep with
+====================================================
+*/
+void Scene::WakeTouchedIslands() {
+	for ( int i = 0; i < m_bodies.Size(); i++ ) {
+		if ( m_bodies.m_isAwake[ i ] && m_bodies.m_islandIds[ i ] >= 0 ) {
+			WakeIsland( m_bodies.m_islandIds[ i ] );
+		}
+	}
+}
+
+/*
+====================================================
+Scene::UpdateSleeping
+
+an island falls asleep once every body in it has been slow for long enough
+====================================================
+*/
+void Scene::UpdateSleeping( const float dt_sec ) {
+	if ( !ENABLE_SLEEPING ) {
+		return;
+	}
+
+	const float maxLinearSqr = SLEEP_LINEAR_VELOCITY * SLEEP_LINEAR_VELOCITY;
+	const float maxAngularSqr = SLEEP_ANGULAR_VELOCITY * SLEEP_ANGULAR_VELOCITY;
+
+	// the island sleeps when its most restless body is ready to
+	span_t< float > islandSleepTimers = m_frameArena.Alloc< float >( m_bodies.Size() );
+	std::fill( islandSleepTimers.begin(), islandSleepTimers.end(), FLT_MAX );
+	for ( int i = 0; i < m_bodies.Size(); i++ ) {
+		if ( !m_bodies.IsActive( i ) ) {
+			continue;
+		}
+
+		const bool isSlow = m_bodies.m_linearVelocities[ i ].GetLengthSqr() < maxLinearSqr && m_bodies.m_angularVelocities[ i ].GetLengthSqr() < maxAngularSqr;
+		float & sleepTimer = m_bodies.m_sleepTimers[ i ];
+		sleepTimer = isSlow ? ( sleepTimer + dt_sec ) : 0.f;
+
+		const int island = m_islands.Find( i );
+		islandSleepTimers[ island ] = std::min( islandSleepTimers[ island ], sleepTimer );
+	}
+
+	// the roots only mean something for this step, islands falling asleep get an id that lasts
+	span_t< int > sleepingIds = m_frameArena.Alloc< int >( m_bodies.Size() );
+	std::fill( sleepingIds.begin(), sleepingIds.end(), -1 );
+	for ( int i = 0; i < m_bodies.Size(); i++ ) {
+		if ( !m_bodies.IsActive( i ) ) {
+			continue;
+		}
+
+		const int island = m_islands.Find( i );
+		if ( islandSleepTimers[ island ] >= TIME_TO_SLEEP ) {
+			if ( sleepingIds[ island ] < 0 ) {
+				sleepingIds[ island ] = m_sleepingIslands.Add();
+			}
+			m_sleepingIslands.AddMember( sleepingIds[ island ], m_bodies.GetHandle( i ) );
+			m_bodies.GetBodyAt( i ).Sleep( sleepingIds[ island ] );
+		}
+	}
+}
+
+/*
+====================================================
+Scene::CycleBroadPhase
+====================================================
+*/
+void Scene::CycleBroadPhase() {
+	const broadPhaseType_t next = static_cast< broadPhaseType_t >( ( m_broadPhase->GetType() + 1 ) % BROADPHASE_COUNT );
+
+	// the new broadphase builds itself from scratch on its first update
+	delete m_broadPhase;
+	m_broadPhase = CreateBroadPhase( next );
+	printf( "Broadphase: %s\n", BroadPhaseTypeToStr( next ) );
+}
+
+/*
+====================================================
+Scene::GetQueryTree
+
+the broadphase's tree, if there is one and it knows about the current bodies.
+it only catches up on the next Update, until then the queries scan every body
+====================================================
+*/
+const DynamicAABBTree * Scene::GetQueryTree() const {
+	if ( m_broadPhase->GetType() != BROADPHASE_AABB_TREE ) {
+		return nullptr;
+	}
+
+	const BroadPhaseTree * treePhase = static_cast< const BroadPhaseTree * >( m_broadPhase );
+	return treePhase->IsCurrent( m_bodies ) ? &treePhase->GetTree() : nullptr;
+}
+
+/*
+====================================================
+Scene::RayCast
+
+closest body hit by the segment start -> end
+====================================================
+*/
+bool Scene::RayCast( const Vec3 & start, const Vec3 & end, Body & outBody, Vec3 & outPoint ) {
+	const Vec3 rayPath = end - start;
+	float closest = 1.f;
+	outBody = Body();
+
+	// exact test against a single body, returns the fraction along the path of the hit
+	auto testBody = [ & ]( const int idx, const float maxFraction ) {
+		const Shape * shape = m_bodies.m_shapes[ idx ];
+		if ( shape->GetType() != Shape::SHAPE_SPHERE ) {
+			return maxFraction;
+		}
+
+		const ShapeSphere * sphere = reinterpret_cast< const ShapeSphere * >( shape );
+		float t1 = 0.f;
+		float t2 = 0.f;
+		if ( !RaySphere( start, rayPath, m_bodies.m_positions[ idx ], sphere->m_radius, t1, t2 ) ) {
+			return maxFraction;
+		}
+
+		// t1 is the entry point, if we start inside the sphere that's the exit point instead
+		const float t = ( t1 >= 0.f ) ? t1 : t2;
+		if ( t < 0.f || t > closest ) {
+			return maxFraction;
+		}
+		closest = t;
+		outBody = m_bodies.GetBodyAt( idx );
+		return t;
+	};
+
+	const DynamicAABBTree * tree = GetQueryTree();
+	if ( tree != nullptr ) {
+		tree->RayCast( start, end, testBody );
+	} else {
+		// no acceleration structure to lean on, test everything
+		for ( int i = 0; i < m_bodies.Size(); i++ ) {
+			testBody( i, closest );
+		}
+	}
+
+	if ( !outBody.IsValid() ) {
+		return false;
+	}
+	outPoint = start + rayPath * closest;
+	return true;
+}
+
+/*
+====================================================
+Scene::QueryBounds
+
+every body whose bounds overlap the given bounds
+====================================================
+*/
+void Scene::QueryBounds( const Bounds & bounds, std::vector< Body > & outBodies ) {
+	outBodies.clear();
+
+	const DynamicAABBTree * tree = GetQueryTree();
+	if ( tree != nullptr ) {
+		// the tree returns fat bounds candidates, confirm them with the real bounds
+		tree->QueryBounds( bounds, [ & ]( const int idx ) {
+			if ( bounds.DoesIntersect( m_bodies.m_shapes[ idx ]->GetBounds( m_bodies.m_positions[ idx ], m_bodies.m_orientations[ idx ] ) ) ) {
+				outBodies.push_back( m_bodies.GetBodyAt( idx ) );
+			}
+			return true;
+		} );
+		return;
+	}
+
+	for ( int i = 0; i < m_bodies.Size(); i++ ) {
+		if ( bounds.DoesIntersect( m_bodies.m_shapes[ i ]->GetBounds( m_bodies.m_positions[ i ], m_bodies.m_orientations[ i ] ) ) ) {
+			outBodies.push_back( m_bodies.GetBodyAt( i ) );
+		}
 	}
 }
\ No newline at end of file
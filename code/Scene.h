@@ -8,6 +8,14 @@
 #include "Physics/Body.h"
 #include "Physics/Constraints.h"
 #include "Physics/Manifold.h"
+#include "Physics/Broadphase.h"
+#include "Physics/Island.h"
+#include "Physics/Integrator.h"
+#include "Physics/SphereSweep.h"
+#include "Physics/FrameArena.h"
+#include "Physics/ConstraintColoring.h"
+#include "Physics/ContactBatch.h"
+#include "Physics/GJK.h"
 #include "Animation/AnimationData.h"
 #include "Animation/AnimationState.h"
 #include "Animation/ModelLoader.h"
@@ -20,7 +28,7 @@ Scene
 */
 class Scene {
 public:
-	Scene() { m_bodies.reserve( 128 ); startDebugSession(); }
+	Scene() : m_broadPhase( CreateBroadPhase( DEFAULT_BROADPHASE ) ) { startDebugSession(); }
 	~Scene();
 
 	void Reset();
@@ -30,16 +38,57 @@ public:
 	void Update( const float dt_sec );
 	void UpdateWithoutTOI( const float dt_sec );
 
+	void CycleBroadPhase();
+	int GetSolverIterations() const { return m_solverStats.iterations; }	// used by the last step
+	const lcpStats_t & GetSolverStats() const { return m_solverStats; }
+	const gjkStats_t & GetGJKStats() const { return m_gjkStats; }	// of the last step's narrowphase
+	bool RayCast( const Vec3 & start, const Vec3 & end, Body & outBody, Vec3 & outPoint );
+	void QueryBounds( const Bounds & bounds, std::vector< Body > & outBodies );
+
 	void ToggleTPose();
 	void TryCycleAnim();
 	int GetFirstAnimatedBodyIdx();
 
 	std::vector< Constraint * >	m_constraints;
 	ManifoldCollector m_manifolds;
-	std::vector< Body * > m_renderedBodies;
+	std::vector< Body > m_renderedBodies;
 	std::array< AnimationInstance *, ANIM_DEMO_SKELETONS.size() > animInstanceDemo = {};
 
 private:
-	std::vector< Body > m_bodies;
+	// sleeping
+	void LinkBodies( const Body & bodyA, const Body & bodyB );
+	void WakeTouching( const Body & bodyA, const Body & bodyB );
+	void WakeIsland( const int islandId );
+	void WakeTouchedIslands();
+	void UpdateSleeping( const float dt_sec );
+
+	// spatial queries
+	const DynamicAABBTree * GetQueryTree() const;
+
+	span_t< contact_t > NarrowPhase( const std::vector< collisionPair_t > & pairs, const float dt_sec );
+	void SolveConstraints( const float dt_sec );
+
+	// time of impact
+	void ResolveContactsGlobalTime( span_t< contact_t > contacts, const float dt_sec );
+	void ResolveContactsLocalTime( span_t< contact_t > contacts, const float dt_sec );
+	void AdvanceBody( Body body, const float time );
+
+	BodyStore m_bodies;
+	BroadPhaseBase * m_broadPhase;
+	BodyIntegrator m_integrator;
+
+	IslandGraph m_islands;
+	SleepingIslandTable m_sleepingIslands;
+	lcpStats_t m_solverStats;
+
+	// warm starts GJK on the convex pairs, kept from step to step like the manifolds
+	GJKCacheTable m_gjkCaches;
+	gjkStats_t m_gjkStats;
+
+	// scratch for everything within a step, reset at the start of each one
+	FrameArena m_frameArena;
+	std::vector< SphereSweepBatch > m_chunkSweeps;	// for the threads running the narrowphase
+	ContactBatch m_contactBatch;					// the wide solver's lanes
+	span_t< float > m_localTimes;					// how far into the step each body is, for ResolveContactsLocalTime
 };
 
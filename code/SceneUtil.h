@@ -1,5 +1,7 @@
 #pragma once
 
+class BodyStore;
+
 namespace sceneUtil {
 	void MakeCoordGizmo(
 		const Vec3 & origin,
@@ -7,6 +9,6 @@ namespace sceneUtil {
 		const Vec3 rDir,
 		const Vec3 & uDir,
 		const float scale,
-		void * bodies
+		BodyStore & bodies
 	);
 } // namespace scene util
\ No newline at end of file
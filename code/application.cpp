@@ -88,13 +88,13 @@ void Application::Initialize() {
 	for ( int i = 0; i < numBodies; i++ ) {
 		// @HACK for now
 		ModelBase * model = nullptr;
-		const bool isAnimated = m_scene->m_renderedBodies[ i ]->isSkinnedMesh;
+		const bool isAnimated = m_scene->m_renderedBodies[ i ].IsSkinnedMesh();
 		if ( isAnimated ) {
 			model = new ModelSkinned();
 		} else {
 			model = new Model();
 		}
-		model->BuildFromShape( m_scene->m_renderedBodies[ i ]->m_shape );
+		model->BuildFromShape( m_scene->m_renderedBodies[ i ].GetShape() );
 		model->MakeVBO( &m_deviceContext );
 
 		m_models.push_back( model );
@@ -461,6 +461,9 @@ void Application::Keyboard( int key, int scancode, int action, int modifiers ) {
 	if ( GLFW_KEY_P == key && GLFW_RELEASE == action ) {
 		m_scene->ToggleTPose();
 	}
+	if ( GLFW_KEY_B == key && GLFW_RELEASE == action ) {
+		m_scene->CycleBroadPhase();
+	}
 }
 
 /*
@@ -649,13 +652,13 @@ void Application::UpdateUniforms() {
 		//	Update the uniform buffer with the body positions/orientations
 		//
 		for ( int i = 0; i < m_scene->m_renderedBodies.size(); i++ ) {
-			Body & body = *( m_scene->m_renderedBodies[ i ] );
+			Body & body = m_scene->m_renderedBodies[ i ];
 
-			Vec3 fwd = body.m_orientation.RotatePoint( Vec3( 1, 0, 0 ) );
-			Vec3 up = body.m_orientation.RotatePoint( Vec3( 0, 0, 1 ) );
+			Vec3 fwd = body.GetOrientation().RotatePoint( Vec3( 1, 0, 0 ) );
+			Vec3 up = body.GetOrientation().RotatePoint( Vec3( 0, 0, 1 ) );
 
 			Mat4 matOrient;
-			matOrient.Orient( body.m_position, fwd, up );
+			matOrient.Orient( body.GetPosition(), fwd, up );
 			matOrient = matOrient.Transpose();
 
 			// Update the uniform buffer with the orientation of this body
@@ -665,17 +668,17 @@ void Application::UpdateUniforms() {
 			renderModel.model = m_models[ i ];
 			renderModel.uboByteOffset = uboByteOffset;
 			renderModel.uboByteSize = sizeof( matOrient );
-			renderModel.pos = body.m_position;
-			renderModel.orient = body.m_orientation;
+			renderModel.pos = body.GetPosition();
+			renderModel.orient = body.GetOrientation();
 
-			if ( body.isSkinnedMesh ) {
-				renderModel.numBones = reinterpret_cast< ShapeLoadedMesh * >( body.m_shape )->matrixPalette.size();
+			if ( body.IsSkinnedMesh() ) {
+				renderModel.numBones = reinterpret_cast< ShapeLoadedMesh * >( body.GetShape() )->matrixPalette.size();
 
 				//extern bool * g_isPaused;
 				//if ( !*g_isPaused ) {
 				//	static int hitcount = 0;
 				//	printf( "~~ \t\treporting matrix palette size for the %ith time ~~ size = %llu\n", hitcount++,
-				//			reinterpret_cast< ShapeLoadedMesh * >( body.m_shape )->matrixPalette.size() );
+				//			reinterpret_cast< ShapeLoadedMesh * >( body.GetShape() )->matrixPalette.size() );
 				//}
 			}
 
@@ -690,12 +693,12 @@ void Application::UpdateUniforms() {
 		const int firstAnimatedBodyIdx = m_scene->GetFirstAnimatedBodyIdx();
 		if ( firstAnimatedBodyIdx >= 0 ) {
 			for ( int i = firstAnimatedBodyIdx; i < m_scene->m_renderedBodies.size(); i++ ) {
-				if ( !m_scene->m_renderedBodies[ i ]->isSkinnedMesh ) {
+				if ( !m_scene->m_renderedBodies[ i ].IsSkinnedMesh() ) {
 					continue;
 				}
 
-				Body & body = *( m_scene->m_renderedBodies[ i ] );
-				ShapeLoadedMesh * mesh = reinterpret_cast< ShapeLoadedMesh * >( body.m_shape );
+				Body & body = m_scene->m_renderedBodies[ i ];
+				ShapeLoadedMesh * mesh = reinterpret_cast< ShapeLoadedMesh * >( body.GetShape() );
 				const std::vector< Mat4 > * matrixData = mesh->GetMatrixPalette();
 				if ( matrixData != nullptr ) {
 
@@ -2,6 +2,10 @@
 //  main.cpp
 //
 #include "application.h"
+#include "Physics/Integrator.h"
+#include "Physics/GJK.h"
+#include "Physics/SphereSweep.h"
+#include <string.h>
 
 /*
 ====================================================
@@ -9,6 +13,16 @@ main
 ====================================================
 */
 int main( int argc, char * argv[] ) {
+	// times the batched physics paths against the scalar ones, then exits without opening a window
+	for ( int i = 1; i < argc; i++ ) {
+		if ( 0 == strcmp( argv[ i ], "-benchmark" ) ) {
+			BenchmarkIntegrator( 16384, 100 );
+			BenchmarkSphereSweep( 16384, 100 );
+			BenchmarkGJK( 64, 4096, 100 );
+			return 0;
+		}
+	}
+
 	g_application = new Application;
 	g_application->Initialize();
 